@@ -2,7 +2,9 @@
 
 layout (location = 0) in vec3 fragColor;
 layout (location = 1) in vec2 fragTexture;
-layout(location = 2) flat in int useTexture;
+
+// Set per pipeline variant by LevelRenderer, so the branch below is compiled out
+layout (constant_id = 0) const bool USE_TEXTURE = true;
 
 layout (set = 1, binding = 0) uniform sampler2D textureSampler;
 
@@ -11,8 +13,8 @@ layout(location = 0) out vec4 outColor;		// Final output color (must have locati
 void main()
 {
 	
-	// NOTE: if use texture = 1, use texture, IF 0 then just use fragment colors.
-	if (useTexture == 1) 
+	// NOTE: if USE_TEXTURE is true, use texture, otherwise just use fragment colors.
+	if (USE_TEXTURE) 
 	{
 		outColor = texture(textureSampler, fragTexture);
 	}
@@ -18,7 +18,9 @@ layout (push_constant) uniform PushModel
 
 layout (location = 0) out vec3 fragColor;
 layout (location = 1) out vec2 fragTexture;
-layout (location = 2) out int useTexture;
+
+// The depth pre-pass and the depth-equal color pass must compute exactly the same depth
+invariant gl_Position;
 
 void main() 
 {
@@ -26,5 +28,4 @@ void main()
 
     fragColor = color;
     fragTexture = texture;
-    useTexture = pushModel.useTexture;
 }
\ No newline at end of file
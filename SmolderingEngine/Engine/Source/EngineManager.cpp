@@ -4,7 +4,12 @@
 #include "Engine/Source/Public/Input/InputManager.h"
 #include "Engine/Source/Public/Camera/Camera.h"
 #include "Engine/Source/Public/Rendering/Renderer.h"
+#include "Engine/Source/Public/Rendering/RenderThread.h"
 #include "Engine/Source/Public/EngineLevel/EngineLevelManager.h"
+#include "Engine/Source/Public/Object/ObjectManager.h"
+#include "Engine/Source/Public/SceneQuery/SceneQuery.h"
+#include "Engine/Source/Public/Threading/JobSystem.h"
+#include "Engine/Source/Public/Time/FixedTimestep.h"
 
 EngineManager* EngineManager::seEngineInstance = nullptr;
 
@@ -20,16 +25,50 @@ EngineManager* EngineManager::GetEngineManager()
 
 void EngineManager::DeleteEngineManager()
 {
-	// TODO: CLEANUP ENGINE MANAGER
+	// Load jobs use the level manager, the renderer and the render thread, let them finish while all of those exist
+	seEngineLevel->WaitForLoads();
+
+	// Game objects hold GPU buffers, they have to be released before the renderer destroys the device
+	seEngineLevel->GetObjectManager()->DestroyAllGameObjects();
+
+	// Nothing may be recording when the renderer is destroyed
+	delete(seRenderThread);
+	seRenderThread = nullptr;
+
+	// Destroying the renderer also writes the pipeline cache back to disk
+	seRenderer->DestroyRenderer();
+	seRenderer = nullptr;
+
+	glfwDestroyWindow(seInputManager->window);
+	glfwTerminate();
+
+	delete(seFixedTimestep);
+	delete(seSceneQuery);
+	delete(seEngineLevel);
+	delete(seCamera);
+	delete(seInputManager);
+
+	// Last, nothing else may still be running jobs
+	delete(seJobSystem);
+
+	seEngineInstance = nullptr;
+	delete(this);
 }
 
 EngineManager::EngineManager()
 {
+	// Created on the main thread, which makes it the job system's main thread
+	seJobSystem = new JobSystem();
 	seInputManager = new InputManager("Smoldering Engine", 1280, 720);
 	seCamera = new Camera(45.f, 1280.f, 720.f, 0.1f, 1000.f);
 	seRenderer = new Renderer(seInputManager->window, seCamera);
+	seRenderThread = new RenderThread([this](const RenderSnapshot& _snapshot) { seRenderer->Draw(_snapshot); });
+	seRenderer->SetFrameTimeline(seRenderThread->GetFrameTimeline());
+	seRenderer->SetRenderThread(seRenderThread);
+	seSceneQuery = new SceneQuery();
+	seFixedTimestep = new FixedTimestep();
 
-	seEngineLevel = new EngineLevelManager(seRenderer);
+	seEngineLevel = new EngineLevelManager(seRenderer, seRenderThread, seJobSystem);
 	// Load the level
 	seEngineLevel->LoadLevel(std::string(PROJECT_SOURCE_DIR) + "/SmolderingEngine/Game/Levels/defaultLevel.selevel");
 }
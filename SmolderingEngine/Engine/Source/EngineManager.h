@@ -22,12 +22,32 @@ private:
 	*/
 	class Renderer* seRenderer = nullptr;
 
+	/*
+	* Records and submits frames on its own thread from snapshots the main thread publishes each frame
+	*/
+	class RenderThread* seRenderThread = nullptr;
+
 	/*
 	* EngineLevelManager holds the functionality to Load / Save levels. It also holds the ObjectManager
 	* These two classes hold all the objects within the scene we are in.
 	*/
 	class EngineLevelManager* seEngineLevel = nullptr;
 
+	/*
+	* Raycasts and overlap queries against the objects in the level (picking, line of sight, ground snapping)
+	*/
+	class SceneQuery* seSceneQuery = nullptr;
+
+	/*
+	* Worker threads shared by every system that splits its work into jobs (loading, object updates, collision, scene queries)
+	*/
+	class JobSystem* seJobSystem = nullptr;
+
+	/*
+	* Fixed rate simulation clock, how many ticks each frame runs and how far rendering is between the last two
+	*/
+	class FixedTimestep* seFixedTimestep = nullptr;
+
 	/* Functions */
 public:
 
@@ -40,7 +60,11 @@ public:
 	class InputManager* GetInputManager() { return seInputManager; };
 	class Camera* GetCamera() { return seCamera; };
 	class Renderer* GetRenderer() { return seRenderer; };
+	class RenderThread* GetRenderThread() { return seRenderThread; };
 	class EngineLevelManager* GetEngineLevelManager() { return seEngineLevel; };
+	class SceneQuery* GetSceneQuery() { return seSceneQuery; };
+	class JobSystem* GetJobSystem() { return seJobSystem; };
+	class FixedTimestep* GetFixedTimestep() { return seFixedTimestep; };
 
 private:
 	EngineManager();
@@ -0,0 +1,601 @@
+#include "Engine/Source/Public/Benchmark/Benchmarks.h"
+
+// Standard Library
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <utility>
+#include <thread>
+#include <memory>
+#include <atomic>
+#include <cmath>
+#include <queue>
+#include <mutex>
+#include <functional>
+#include <algorithm>
+
+// Project Includes
+#include "Engine/Source/Public/Rendering/Utilities.h"
+#include "Engine/Source/Public/Collision/Broadphase.h"
+#include "Engine/Source/Public/Object/GameObject.h"
+#include "Engine/Source/Public/Object/ObjectTransforms.h"
+#include "Engine/Source/Public/Rendering/MeshModel.h"
+#include "Engine/Source/Public/Memory/PoolAllocator.h"
+#include "Engine/Source/Public/Memory/LevelArena.h"
+#include "Engine/Source/Public/Object/ObjectUpdateScheduler.h"
+#include "Engine/Source/Public/Threading/JobSystem.h"
+#include "Engine/Source/Public/Threading/MPSCTaskQueue.h"
+
+static double MillisecondsSince(std::chrono::high_resolution_clock::time_point _start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - _start).count();
+}
+
+static AABB CreateBoxAABB(const glm::vec3& _center, const glm::vec3& _halfExtent)
+{
+	AABB aabb;
+	aabb.minimumX = _center.x - _halfExtent.x;
+	aabb.minimumY = _center.y - _halfExtent.y;
+	aabb.minimumZ = _center.z - _halfExtent.z;
+	aabb.maximumX = _center.x + _halfExtent.x;
+	aabb.maximumY = _center.y + _halfExtent.y;
+	aabb.maximumZ = _center.z + _halfExtent.z;
+
+	return aabb;
+}
+
+const std::vector<std::pair<std::string, Benchmarks::BenchmarkFunction>>& Benchmarks::GetBenchmarkTable()
+{
+	// Add new benchmarks here
+	static const std::vector<std::pair<std::string, BenchmarkFunction>> benchmarkTable =
+	{
+		{ "collision-broadphase", &Benchmarks::CollisionBroadphase },
+		{ "level-allocation", &Benchmarks::LevelAllocation },
+		{ "object-update", &Benchmarks::ObjectUpdate },
+		{ "job-system", &Benchmarks::JobSystemOverhead },
+		{ "task-queue-contention", &Benchmarks::TaskQueueContention },
+	};
+
+	return benchmarkTable;
+}
+
+bool Benchmarks::RunBenchmark(const std::string& _name)
+{
+	for (const auto& [name, function] : GetBenchmarkTable())
+	{
+		if (name == _name)
+		{
+			std::cout << "Running benchmark: " << name << std::endl;
+			function();
+			return true;
+		}
+	}
+
+	std::cout << "Unknown benchmark \"" << _name << "\", available benchmarks:" << std::endl;
+	for (const std::string& name : GetBenchmarkNames())
+		std::cout << "  " << name << std::endl;
+
+	return false;
+}
+
+std::vector<std::string> Benchmarks::GetBenchmarkNames()
+{
+	std::vector<std::string> names;
+	for (const auto& benchmark : GetBenchmarkTable())
+		names.push_back(benchmark.first);
+
+	return names;
+}
+
+void Benchmarks::CollisionBroadphase()
+{
+	const int staticCount = 10000;
+	const int movableCount = 100;
+	const int frameCount = 100;
+	const float worldSize = 500.0f;
+	const float movableSpeed = 0.25f;
+
+	// Fixed seed so every run (and both broadphases) see the same scene
+	std::mt19937 random(1337);
+	std::uniform_real_distribution<float> position(-worldSize * 0.5f, worldSize * 0.5f);
+	std::uniform_real_distribution<float> halfExtent(0.25f, 2.0f);
+	std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+
+	// Statics are spread over a ground plane, movers are a unit box moving in a straight line
+	std::vector<AABB> staticAABBs(staticCount);
+	for (AABB& staticAABB : staticAABBs)
+		staticAABB = CreateBoxAABB(glm::vec3(position(random), halfExtent(random), position(random)), glm::vec3(halfExtent(random), halfExtent(random), halfExtent(random)));
+
+	std::vector<glm::vec3> movablePositions(movableCount);
+	std::vector<glm::vec3> movableVelocities(movableCount);
+	for (int i = 0; i < movableCount; i++)
+	{
+		movablePositions[i] = glm::vec3(position(random), 1.0f, position(random));
+		movableVelocities[i] = glm::normalize(glm::vec3(direction(random), 0.0f, direction(random) + 0.001f)) * movableSpeed;
+	}
+
+	auto getMovableAABB = [&](int _movable, int _frame)
+		{
+			return CreateBoxAABB(movablePositions[_movable] + movableVelocities[_movable] * static_cast<float>(_frame), glm::vec3(0.5f));
+		};
+
+	// Statics first, then movers, updated every frame
+	std::vector<AABB> aabbs(staticAABBs);
+	aabbs.resize(staticCount + movableCount);
+	auto updateMovableAABBs = [&](int _frame)
+		{
+			for (int movable = 0; movable < movableCount; movable++)
+				aabbs[staticCount + movable] = getMovableAABB(movable, _frame);
+		};
+
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << staticCount << " statics x " << movableCount << " movers, " << frameCount << " frames" << std::endl;
+
+	// Scalar brute force, every mover against every static and every other mover one pair at a time
+	uint64_t bruteForcePairs = 0;
+	auto start = std::chrono::high_resolution_clock::now();
+	for (int frame = 0; frame < frameCount; frame++)
+	{
+		updateMovableAABBs(frame);
+		for (int movable = staticCount; movable < staticCount + movableCount; movable++)
+		{
+			for (int other = 0; other < movable; other++)
+				bruteForcePairs += AABBOverlaps(aabbs[movable], aabbs[other]) ? 1 : 0;
+		}
+	}
+	double bruteForceTime = MillisecondsSince(start);
+	std::cout << "  Brute force:          " << bruteForceTime / frameCount << "ms per frame, " << bruteForcePairs << " pairs" << std::endl;
+
+	// Every broadphase goes through the same interface CollisionManager uses
+	for (BroadphaseType broadphaseType : { BroadphaseType::BruteForce, BroadphaseType::DynamicAABBTree, BroadphaseType::SweepAndPrune, BroadphaseType::SpatialHashGrid })
+	{
+		updateMovableAABBs(0);
+
+		start = std::chrono::high_resolution_clock::now();
+		Broadphase* broadphase = Broadphase::CreateBroadphase(broadphaseType);
+		std::vector<int> proxyIDs(aabbs.size());
+		for (int i = 0; i < static_cast<int>(aabbs.size()); i++)
+		{
+			CollisionTypes collisionType = (i < staticCount) ? CollisionTypes::StaticCollision : CollisionTypes::MovableCollision;
+			proxyIDs[i] = broadphase->CreateProxy(aabbs[i], nullptr, collisionType);
+		}
+		double buildTime = MillisecondsSince(start);
+
+		// Proxy IDs are small non-negative ints (the tree's share their range with internal nodes), so the way back to
+		// the AABB index is a plain array built before any timing
+		std::vector<int> proxyIndices(*std::max_element(proxyIDs.begin(), proxyIDs.end()) + 1, -1);
+		for (int i = 0; i < static_cast<int>(proxyIDs.size()); i++)
+			proxyIndices[proxyIDs[i]] = i;
+
+		// The first update sorts/builds everything, count it as part of the build
+		std::vector<BroadphasePair> pairs;
+		start = std::chrono::high_resolution_clock::now();
+		broadphase->UpdatePairs(pairs);
+		buildTime += MillisecondsSince(start);
+
+		// Only moving the proxies and finding the pairs is timed, checking the pairs afterwards is not the broadphase's cost
+		uint64_t broadphasePairs = 0;
+		uint64_t candidates = 0;
+		double broadphaseTime = 0.0;
+		for (int frame = 0; frame < frameCount; frame++)
+		{
+			updateMovableAABBs(frame);
+
+			start = std::chrono::high_resolution_clock::now();
+			for (int movable = staticCount; movable < staticCount + movableCount; movable++)
+				broadphase->MoveProxy(proxyIDs[movable], aabbs[movable]);
+
+			pairs.clear();
+			broadphase->UpdatePairs(pairs);
+			broadphaseTime += MillisecondsSince(start);
+
+			candidates += pairs.size();
+			for (const BroadphasePair& pair : pairs)
+				broadphasePairs += AABBOverlaps(aabbs[proxyIndices[pair.proxyID]], aabbs[proxyIndices[pair.otherProxyID]]) ? 1 : 0;
+		}
+
+		std::cout << "  " << std::left << std::setw(22) << (std::string(broadphase->GetName()) + ":") << std::right
+			<< broadphaseTime / frameCount << "ms per frame, " << broadphasePairs << " pairs, " << candidates << " candidates, build "
+			<< buildTime << "ms, " << bruteForceTime / std::max(broadphaseTime, 0.001) << "x brute force" << std::endl;
+
+		if (bruteForcePairs != broadphasePairs)
+			std::cout << "Warning: " << broadphase->GetName() << " found a different number of pairs than brute force!" << std::endl;
+
+		delete(broadphase);
+	}
+}
+
+void Benchmarks::LevelAllocation()
+{
+	const int objectCount = 10000;
+	const int levelCount = 5;
+
+	// Same steps as ObjectManager: a MeshModel in the level arena and a GameObject from the pool per object
+	PoolAllocator<GameObject> gameObjectPool;
+	LevelArena levelArena;
+	ObjectTransforms objectTransforms;
+	std::vector<GameObject*> gameObjects;
+	gameObjects.reserve(objectCount);
+
+	// Paths like the ones LoadLevel builds, too long for the small string buffer
+	const std::string objectPath = std::string(PROJECT_SOURCE_DIR) + "/SmolderingEngine/Game/Models/House/Heilig_Grab_Kapelle_C.obj";
+	const std::string texturePath = std::string(PROJECT_SOURCE_DIR) + "/SmolderingEngine/Game/Models/House/";
+
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << levelCount << " loads of a " << objectCount << " object level" << std::endl;
+
+	for (int level = 0; level < levelCount; level++)
+	{
+		AllocationStatistics poolBefore = gameObjectPool.GetStatistics();
+		AllocationStatistics arenaBefore = levelArena.GetStatistics();
+
+		auto start = std::chrono::high_resolution_clock::now();
+		// LoadLevel interns the paths in the level arena, every GameObject's ObjectData only holds views of them
+		ObjectData objectData;
+		objectData.objectPath = levelArena.CreateString(objectPath);
+		objectData.texturePath = levelArena.CreateString(texturePath);
+		for (int i = 0; i < objectCount; i++)
+		{
+			MeshModel* meshModel = levelArena.Create<MeshModel>();
+			int transformHandle = objectTransforms.Add(glm::mat4(1.0f), meshModel->GetLocalAABB());
+			gameObjects.push_back(gameObjectPool.Create(objectData, nullptr, meshModel, &objectTransforms, transformHandle, GameObjectHandle()));
+		}
+		double loadTime = MillisecondsSince(start);
+
+		start = std::chrono::high_resolution_clock::now();
+		for (GameObject* gameObject : gameObjects)
+			gameObjectPool.Destroy(gameObject);
+		gameObjects.clear();
+		objectTransforms.Clear();
+		levelArena.Reset();
+		double unloadTime = MillisecondsSince(start);
+
+		// Only the first load reaches the heap, later loads reuse the pool's and arena's blocks whatever objectCount is
+		const AllocationStatistics& pool = gameObjectPool.GetStatistics();
+		const AllocationStatistics& arena = levelArena.GetStatistics();
+		std::cout << "  Level " << level << ": load " << loadTime << "ms, unload " << unloadTime << "ms, heap calls (GameObject pool "
+			<< (pool.heapAllocations - poolBefore.heapAllocations) << ", level arena " << (arena.heapAllocations - arenaBefore.heapAllocations)
+			<< ")" << std::endl;
+	}
+
+	// The same objects with a heap call each, as before the pool and arena
+	ObjectData objectData;
+	objectData.objectPath = levelArena.CreateString(objectPath);
+	objectData.texturePath = levelArena.CreateString(texturePath);
+	std::vector<MeshModel*> meshModels;
+	meshModels.reserve(objectCount);
+	auto start = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < objectCount; i++)
+	{
+		meshModels.push_back(new MeshModel());
+		int transformHandle = objectTransforms.Add(glm::mat4(1.0f), meshModels.back()->GetLocalAABB());
+		gameObjects.push_back(new GameObject(objectData, nullptr, meshModels.back(), &objectTransforms, transformHandle, GameObjectHandle()));
+	}
+	for (int i = 0; i < objectCount; i++)
+	{
+		delete gameObjects[i];
+		delete meshModels[i];
+	}
+	gameObjects.clear();
+	objectTransforms.Clear();
+	levelArena.Reset();
+	double heapTime = MillisecondsSince(start);
+	// A new for each MeshModel and GameObject
+	std::cout << "  new/delete: load + unload " << heapTime << "ms, " << objectCount * 2 << " heap calls" << std::endl;
+
+	const AllocationStatistics& pool = gameObjectPool.GetStatistics();
+	const AllocationStatistics& arena = levelArena.GetStatistics();
+	std::cout << "  Totals: GameObject pool " << pool.heapAllocations << " heap calls for " << pool.allocations << " objects ("
+		<< pool.bytesReserved / 1024 << "KB), level arena " << arena.heapAllocations << " heap calls for " << arena.allocations
+		<< " allocations (" << arena.bytesReserved / 1024 << "KB)" << std::endl;
+}
+
+void Benchmarks::ObjectUpdate()
+{
+	const int objectCount = 100000;
+	const int childEvery = 4;
+	const int frameCount = 60;
+	const float deltaTime = 1.0f / 60.0f;
+
+	// Every fourth object is parented to the one before it, so propagation has two depths to get through
+	auto createScene = [&](ObjectTransforms& _transforms)
+		{
+			std::mt19937 random(1337);
+			std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+			AABB unitAABB = CreateBoxAABB(glm::vec3(0.0f), glm::vec3(0.5f));
+
+			std::vector<int> handles(objectCount);
+			for (int i = 0; i < objectCount; i++)
+				handles[i] = _transforms.Add(glm::translate(glm::mat4(1.0f), glm::vec3(position(random), 0.0f, position(random))), unitAABB);
+			for (int i = childEvery - 1; i < objectCount; i += childEvery)
+				_transforms.SetParent(handles[i], handles[i - 1]);
+		};
+
+	// Two callbacks writing the local matrices have to run one after the other, the read only one shares the first stage
+	std::atomic<int> nearOriginCount{ 0 };
+	auto addCallbacks = [&](ObjectUpdateScheduler& _scheduler)
+		{
+			_scheduler.AddUpdateCallback("Spin", OBJECT_ACCESS_LOCAL_MATRICES, OBJECT_ACCESS_LOCAL_MATRICES, [](const ObjectUpdateChunk& _chunk)
+				{
+					glm::mat4 rotation = glm::rotate(glm::mat4(1.0f), _chunk.deltaTime, glm::vec3(0.0f, 1.0f, 0.0f));
+					for (size_t i = _chunk.first; i < _chunk.last; i++)
+						_chunk.transforms->SetLocalMatrixAt(i, _chunk.transforms->GetLocalMatrixAt(i) * rotation);
+				});
+			_scheduler.AddUpdateCallback("Bob", OBJECT_ACCESS_LOCAL_MATRICES, OBJECT_ACCESS_LOCAL_MATRICES, [](const ObjectUpdateChunk& _chunk)
+				{
+					for (size_t i = _chunk.first; i < _chunk.last; i++)
+					{
+						glm::mat4 localMatrix = _chunk.transforms->GetLocalMatrixAt(i);
+						localMatrix[3].y = std::sin(localMatrix[3].x + localMatrix[3].z);
+						_chunk.transforms->SetLocalMatrixAt(i, localMatrix);
+					}
+				});
+			_scheduler.AddUpdateCallback("Count near origin", OBJECT_ACCESS_WORLD_AABBS, OBJECT_ACCESS_USER, [&nearOriginCount](const ObjectUpdateChunk& _chunk)
+				{
+					AABB nearOrigin = CreateBoxAABB(glm::vec3(0.0f), glm::vec3(100.0f));
+					int count = 0;
+					for (size_t i = _chunk.first; i < _chunk.last; i++)
+						count += AABBOverlaps(_chunk.transforms->GetWorldAABBs()[i], nearOrigin) ? 1 : 0;
+					nearOriginCount.fetch_add(count, std::memory_order_relaxed);
+				});
+		};
+
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << objectCount << " objects (1 in " << childEvery << " a child), 3 callbacks, " << frameCount << " frames" << std::endl;
+
+	std::vector<Model> serialModels;
+	double serialTime = 0.0;
+	size_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+	std::vector<size_t> threadCounts = { 0 };
+	for (size_t threadCount = 1; threadCount < hardwareThreads; threadCount *= 2)
+		threadCounts.push_back(threadCount);
+	threadCounts.push_back(hardwareThreads);
+
+	for (size_t threadCount : threadCounts)
+	{
+		ObjectTransforms transforms;
+		createScene(transforms);
+		ObjectUpdateScheduler scheduler;
+		addCallbacks(scheduler);
+
+		// 0 threads is the plain serial loop, otherwise the main thread plus threadCount - 1 workers
+		std::unique_ptr<JobSystem> jobSystem;
+		if (threadCount > 0)
+			jobSystem = std::make_unique<JobSystem>(threadCount - 1);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		for (int frame = 0; frame < frameCount; frame++)
+			scheduler.Update(deltaTime, &transforms, jobSystem.get());
+		double time = MillisecondsSince(start);
+
+		if (threadCount == 0)
+		{
+			serialModels = transforms.GetModels();
+			serialTime = time;
+			std::cout << "  Serial:    " << time / frameCount << "ms per frame, " << scheduler.GetStageCount() << " stages" << std::endl;
+			continue;
+		}
+
+		// The stages and depths keep the parallel update exactly the same as the serial one
+		bool matches = transforms.GetModels().size() == serialModels.size();
+		for (size_t i = 0; matches && i < serialModels.size(); i++)
+			matches = transforms.GetModels()[i].modelMatrix == serialModels[i].modelMatrix;
+
+		std::cout << "  " << std::setw(2) << threadCount << " threads: " << time / frameCount << "ms per frame, "
+			<< serialTime / std::max(time, 0.001) << "x serial" << std::endl;
+		if (!matches)
+			std::cout << "Warning: the parallel update gave different world matrices than the serial one!" << std::endl;
+	}
+}
+
+void Benchmarks::JobSystemOverhead()
+{
+	// Batches stay under what one thread may have unfinished at a time
+	const int batchSize = 4000;
+	const int batchCount = 50;
+	const int jobCount = batchSize * batchCount;
+	const int threadTaskCount = 1000;
+
+	std::cout << std::fixed << std::setprecision(1);
+
+	// What the level loader and the old ParallelFor did, a thread started and joined for every task
+	std::atomic<int> sum{ 0 };
+	auto start = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < threadTaskCount; i++)
+	{
+		std::thread thread([&sum]() { sum.fetch_add(1, std::memory_order_relaxed); });
+		thread.join();
+	}
+	std::cout << "std::thread per task: " << MillisecondsSince(start) * 1000000.0 / threadTaskCount << "ns per task" << std::endl;
+
+	size_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+	std::vector<size_t> threadCounts = { 1 };
+	if (hardwareThreads > 1)
+		threadCounts.push_back(hardwareThreads);
+
+	for (size_t threadCount : threadCounts)
+	{
+		JobSystem jobSystem(threadCount - 1);
+		std::cout << threadCount << " threads:" << std::endl;
+
+		// Spawn: the main thread starts a batch of empty jobs then helps run them
+		start = std::chrono::high_resolution_clock::now();
+		for (int batch = 0; batch < batchCount; batch++)
+		{
+			JobCounter counter;
+			for (int i = 0; i < batchSize; i++)
+				jobSystem.Run([&sum]() { sum.fetch_add(1, std::memory_order_relaxed); }, &counter);
+			jobSystem.Wait(&counter);
+		}
+		std::cout << "  Spawn + run:     " << MillisecondsSince(start) * 1000000.0 / jobCount << "ns per job" << std::endl;
+
+		// Steal: the main thread does not help, every job has to be stolen by a worker
+		if (threadCount > 1)
+		{
+			start = std::chrono::high_resolution_clock::now();
+			for (int batch = 0; batch < batchCount; batch++)
+			{
+				JobCounter counter;
+				for (int i = 0; i < batchSize; i++)
+					jobSystem.Run([&sum]() { sum.fetch_add(1, std::memory_order_relaxed); }, &counter);
+				while (!counter.IsDone())
+					std::this_thread::yield();
+			}
+			std::cout << "  Spawn + steal:   " << MillisecondsSince(start) * 1000000.0 / jobCount << "ns per job" << std::endl;
+		}
+
+		// Nested: one job per thread that each start their own jobs, so workers pop their own deques
+		start = std::chrono::high_resolution_clock::now();
+		{
+			JobCounter outerCounter;
+			for (size_t thread = 0; thread < threadCount; thread++)
+			{
+				jobSystem.Run([&jobSystem, &sum, batchCount, batchSize]()
+					{
+						for (int batch = 0; batch < batchCount; batch++)
+						{
+							JobCounter counter;
+							for (int i = 0; i < batchSize; i++)
+								jobSystem.Run([&sum]() { sum.fetch_add(1, std::memory_order_relaxed); }, &counter);
+							jobSystem.Wait(&counter);
+						}
+					}, &outerCounter);
+			}
+			jobSystem.Wait(&outerCounter);
+		}
+		std::cout << "  Nested spawn:    " << MillisecondsSince(start) * 1000000.0 / (jobCount * threadCount) << "ns per job" << std::endl;
+
+		// Wait: the round trip of starting one job and waiting for it
+		start = std::chrono::high_resolution_clock::now();
+		for (int i = 0; i < jobCount / 10; i++)
+		{
+			JobCounter counter;
+			jobSystem.Run([&sum]() { sum.fetch_add(1, std::memory_order_relaxed); }, &counter);
+			jobSystem.Wait(&counter);
+		}
+		std::cout << "  Run + wait:      " << MillisecondsSince(start) * 1000000.0 / (jobCount / 10) << "ns per job" << std::endl;
+
+		// Main thread jobs: queued from workers, run by the main thread
+		start = std::chrono::high_resolution_clock::now();
+		{
+			JobCounter counter;
+			jobSystem.Run([&jobSystem, &sum, &counter, batchSize]()
+				{
+					for (int i = 0; i < batchSize; i++)
+						jobSystem.RunOnMainThread([&sum]() { sum.fetch_add(1, std::memory_order_relaxed); }, &counter);
+				}, &counter);
+			jobSystem.Wait(&counter);
+		}
+		std::cout << "  Main thread job: " << MillisecondsSince(start) * 1000000.0 / batchSize << "ns per job" << std::endl;
+	}
+
+	int expectedSum = threadTaskCount;
+	for (size_t threadCount : threadCounts)
+		expectedSum += jobCount * ((threadCount > 1) ? 2 : 1) + jobCount * static_cast<int>(threadCount) + jobCount / 10 + batchSize;
+	if (sum.load() != expectedSum)
+		std::cout << "Warning: " << sum.load() << " jobs ran, expected " << expectedSum << "!" << std::endl;
+}
+
+void Benchmarks::TaskQueueContention()
+{
+	const int producerCount = std::max(4, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+	const int tasksPerProducer = 100000;
+	const int taskCount = producerCount * tasksPerProducer;
+
+	// Stands in for the Assimp importer every loader task used to hold on to
+	std::shared_ptr<int> importer = std::make_shared<int>(0);
+	std::atomic<int> tasksRun{ 0 };
+
+	// Runs _produce on every producer thread while this thread drains with _consume, like the main loop each frame
+	auto runContention = [&](const char* _name, auto&& _produce, auto&& _consume)
+		{
+			tasksRun = 0;
+			std::atomic<bool> start{ false };
+			std::vector<std::thread> producers;
+			for (int i = 0; i < producerCount; i++)
+			{
+				producers.emplace_back([&]()
+					{
+						while (!start)
+							std::this_thread::yield();
+						for (int task = 0; task < tasksPerProducer; task++)
+							_produce();
+					});
+			}
+
+			auto startTime = std::chrono::high_resolution_clock::now();
+			start = true;
+
+			double consumeTime = 0.0;
+			int drainCount = 0;
+			while (tasksRun.load(std::memory_order_relaxed) < taskCount)
+			{
+				auto drainStart = std::chrono::high_resolution_clock::now();
+				_consume();
+				consumeTime += MillisecondsSince(drainStart);
+				drainCount++;
+
+				// The rest of the frame, gives the producers the core back on machines with few of them
+				std::this_thread::yield();
+			}
+			double totalTime = MillisecondsSince(startTime);
+
+			for (std::thread& producer : producers)
+				producer.join();
+
+			std::cout << "  " << _name << totalTime * 1000000.0 / taskCount << "ns per task, main thread "
+				<< consumeTime * 1000000.0 / taskCount << "ns per task over " << drainCount << " drains" << std::endl;
+		};
+
+	std::cout << std::fixed << std::setprecision(1);
+	std::cout << producerCount << " producers, " << tasksPerProducer << " tasks each" << std::endl;
+
+	// The old loader queue, a heap allocated std::function per task behind one mutex
+	struct VulkanTask
+	{
+		std::function<void()> function;
+	};
+	std::queue<VulkanTask> vulkanTaskQueue;
+	std::mutex taskQueueMutex;
+
+	runContention("std::mutex + std::queue: ",
+		[&]()
+		{
+			VulkanTask task;
+			task.function = [&tasksRun, importer]() { tasksRun.fetch_add(1, std::memory_order_relaxed); };
+
+			std::lock_guard<std::mutex> lock(taskQueueMutex);
+			vulkanTaskQueue.push(task);
+		},
+		[&]()
+		{
+			std::queue<VulkanTask> tasksToProcess;
+			{
+				std::lock_guard<std::mutex> lock(taskQueueMutex);
+				tasksToProcess.swap(vulkanTaskQueue);
+			}
+
+			while (!tasksToProcess.empty())
+			{
+				tasksToProcess.front().function();
+				tasksToProcess.pop();
+			}
+		});
+
+	// The ring the main thread jobs use, tasks stored inline in the cells. A full ring makes the producer wait.
+	MPSCTaskQueue taskQueue;
+	runContention("MPSCTaskQueue:            ",
+		[&]()
+		{
+			while (!taskQueue.TryPush([&tasksRun, importer]() { tasksRun.fetch_add(1, std::memory_order_relaxed); }))
+				std::this_thread::yield();
+		},
+		[&]()
+		{
+			taskQueue.RunPending();
+		});
+
+	if (importer.use_count() != 1)
+		std::cout << "Warning: " << importer.use_count() - 1 << " tasks were never destroyed!" << std::endl;
+}
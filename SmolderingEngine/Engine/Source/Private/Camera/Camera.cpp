@@ -24,6 +24,24 @@ Camera::Camera(float _fovAngle, float _width, float _height, float _nearPlane, f
 	uboViewProjection.projection[1][1] *= -1;
 }
 
+void Camera::SetSimulationState(const glm::vec3& _position, const glm::vec3& _front)
+{
+	previousPosition = currentPosition;
+	previousFront = currentFront;
+	currentPosition = _position;
+	currentFront = _front;
+}
+
+void Camera::InterpolateView(float _alpha)
+{
+	// The look direction is blended rather than yaw and pitch so it never spins the long way round
+	glm::vec3 position = glm::mix(previousPosition, currentPosition, _alpha);
+	glm::vec3 front = glm::mix(previousFront, currentFront, _alpha);
+	front = (glm::dot(front, front) > 0.0f) ? glm::normalize(front) : currentFront;
+
+	uboViewProjection.view = glm::lookAt(position, position + front, glm::vec3(0.0f, 1.0f, 0.0f));
+}
+
 void Camera::SetModel(glm::mat4 _model)
 {
 }
@@ -0,0 +1,92 @@
+#include "Engine/Source/Public/Collision/AABBTreeBroadphase.h"
+
+int AABBTreeBroadphase::CreateProxy(const AABB& _aabb, GameObject* _gameObject, CollisionTypes _collisionType)
+{
+	if (_collisionType == CollisionTypes::MovableCollision)
+	{
+		int treeProxyID = movableTree.CreateProxy(_aabb, _gameObject);
+		movableProxies.push_back(treeProxyID);
+		return ToProxyID(treeProxyID, true);
+	}
+
+	return ToProxyID(staticTree.CreateProxy(_aabb, _gameObject), false);
+}
+
+void AABBTreeBroadphase::DestroyProxy(int _proxyID)
+{
+	int treeProxyID = ToTreeProxyID(_proxyID);
+	if (!IsMovable(_proxyID))
+	{
+		staticTree.DestroyProxy(treeProxyID);
+		return;
+	}
+
+	movableTree.DestroyProxy(treeProxyID);
+	movableProxies.erase(std::remove(movableProxies.begin(), movableProxies.end(), treeProxyID), movableProxies.end());
+}
+
+void AABBTreeBroadphase::MoveProxy(int _proxyID, const AABB& _aabb)
+{
+	if (IsMovable(_proxyID))
+		movableTree.MoveProxy(ToTreeProxyID(_proxyID), _aabb);
+	else
+		staticTree.MoveProxy(ToTreeProxyID(_proxyID), _aabb);
+}
+
+void AABBTreeBroadphase::UpdatePairs(std::vector<BroadphasePair>& _pairs)
+{
+	for (int treeProxyID : movableProxies)
+		AddPairs(treeProxyID, true, _pairs);
+}
+
+void AABBTreeBroadphase::QueryProxy(int _proxyID, std::vector<BroadphasePair>& _pairs)
+{
+	if (IsMovable(_proxyID))
+		AddPairs(ToTreeProxyID(_proxyID), false, _pairs);
+}
+
+void AABBTreeBroadphase::QueryAABB(const AABB& _aabb, std::vector<int>& _proxyIDs)
+{
+	staticTree.Query(_aabb, [&](int _treeProxyID)
+		{
+			_proxyIDs.push_back(ToProxyID(_treeProxyID, false));
+			return true;
+		});
+
+	movableTree.Query(_aabb, [&](int _treeProxyID)
+		{
+			_proxyIDs.push_back(ToProxyID(_treeProxyID, true));
+			return true;
+		});
+}
+
+GameObject* AABBTreeBroadphase::GetGameObject(int _proxyID) const
+{
+	return IsMovable(_proxyID) ? movableTree.GetGameObject(ToTreeProxyID(_proxyID)) : staticTree.GetGameObject(ToTreeProxyID(_proxyID));
+}
+
+CollisionTypes AABBTreeBroadphase::GetCollisionType(int _proxyID) const
+{
+	return IsMovable(_proxyID) ? CollisionTypes::MovableCollision : CollisionTypes::StaticCollision;
+}
+
+void AABBTreeBroadphase::AddPairs(int _treeProxyID, bool _onlyHigherMovables, std::vector<BroadphasePair>& _pairs)
+{
+	const AABB& movableAABB = movableTree.GetFatAABB(_treeProxyID);
+	int proxyID = ToProxyID(_treeProxyID, true);
+
+	staticTree.Query(movableAABB, [&](int _otherTreeProxyID)
+		{
+			_pairs.push_back({ proxyID, ToProxyID(_otherTreeProxyID, false) });
+			return true;
+		});
+
+	movableTree.Query(movableAABB, [&](int _otherTreeProxyID)
+		{
+			if (_otherTreeProxyID == _treeProxyID || (_onlyHigherMovables && _otherTreeProxyID < _treeProxyID))
+				return true;
+
+			_pairs.push_back({ proxyID, ToProxyID(_otherTreeProxyID, true) });
+			return true;
+		});
+}
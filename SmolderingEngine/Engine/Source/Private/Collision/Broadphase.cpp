@@ -0,0 +1,23 @@
+#include "Engine/Source/Public/Collision/Broadphase.h"
+
+// Project Includes
+#include "Engine/Source/Public/Collision/AABBTreeBroadphase.h"
+#include "Engine/Source/Public/Collision/SweepAndPrune.h"
+#include "Engine/Source/Public/Collision/BruteForceBroadphase.h"
+#include "Engine/Source/Public/Collision/SpatialHashGrid.h"
+
+Broadphase* Broadphase::CreateBroadphase(BroadphaseType _broadphaseType)
+{
+	switch (_broadphaseType)
+	{
+	case BroadphaseType::SweepAndPrune:
+		return new SweepAndPrune();
+	case BroadphaseType::BruteForce:
+		return new BruteForceBroadphase();
+	case BroadphaseType::SpatialHashGrid:
+		return new SpatialHashGrid();
+	case BroadphaseType::DynamicAABBTree:
+	default:
+		return new AABBTreeBroadphase();
+	}
+}
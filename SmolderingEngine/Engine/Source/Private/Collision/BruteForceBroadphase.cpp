@@ -0,0 +1,100 @@
+#include "Engine/Source/Public/Collision/BruteForceBroadphase.h"
+
+int BruteForceBroadphase::CreateProxy(const AABB& _aabb, GameObject* _gameObject, CollisionTypes _collisionType)
+{
+	int proxyID;
+	if (freeList != -1)
+	{
+		proxyID = freeList;
+		freeList = proxies[proxyID].indexOrNext;
+	}
+	else
+	{
+		proxyID = static_cast<int>(proxies.size());
+		proxies.emplace_back();
+	}
+
+	BruteForceProxy& proxy = proxies[proxyID];
+	proxy.gameObject = _gameObject;
+	proxy.collisionType = _collisionType;
+	proxy.free = false;
+
+	if (_collisionType == CollisionTypes::MovableCollision)
+	{
+		proxy.indexOrNext = movableBounds.Add(_aabb);
+		movableProxyIDs.push_back(proxyID);
+	}
+	else
+	{
+		proxy.indexOrNext = staticBounds.Add(_aabb);
+		staticProxyIDs.push_back(proxyID);
+	}
+
+	return proxyID;
+}
+
+void BruteForceBroadphase::DestroyProxy(int _proxyID)
+{
+	BruteForceProxy& proxy = proxies[_proxyID];
+	bool movable = proxy.collisionType == CollisionTypes::MovableCollision;
+	AABBArrays& bounds = movable ? movableBounds : staticBounds;
+	std::vector<int>& proxyIDs = movable ? movableProxyIDs : staticProxyIDs;
+
+	// The last bounds are moved into the hole, point their proxy at the new index
+	int index = proxy.indexOrNext;
+	int movedFromIndex = bounds.RemoveSwap(index);
+	proxyIDs[index] = proxyIDs[movedFromIndex];
+	proxies[proxyIDs[index]].indexOrNext = index;
+	proxyIDs.pop_back();
+
+	proxy.free = true;
+	proxy.gameObject = nullptr;
+	proxy.indexOrNext = freeList;
+	freeList = _proxyID;
+}
+
+void BruteForceBroadphase::MoveProxy(int _proxyID, const AABB& _aabb)
+{
+	const BruteForceProxy& proxy = proxies[_proxyID];
+	if (proxy.collisionType == CollisionTypes::MovableCollision)
+		movableBounds.Set(proxy.indexOrNext, _aabb);
+	else
+		staticBounds.Set(proxy.indexOrNext, _aabb);
+}
+
+void BruteForceBroadphase::UpdatePairs(std::vector<BroadphasePair>& _pairs)
+{
+	for (int movableIndex = 0; movableIndex < movableBounds.count; movableIndex++)
+		AddPairs(movableIndex, true, _pairs);
+}
+
+void BruteForceBroadphase::QueryProxy(int _proxyID, std::vector<BroadphasePair>& _pairs)
+{
+	if (proxies[_proxyID].collisionType == CollisionTypes::MovableCollision)
+		AddPairs(proxies[_proxyID].indexOrNext, false, _pairs);
+}
+
+void BruteForceBroadphase::QueryAABB(const AABB& _aabb, std::vector<int>& _proxyIDs)
+{
+	QueryOverlaps(_aabb, staticBounds, [&](int _staticIndex) { _proxyIDs.push_back(staticProxyIDs[_staticIndex]); });
+	QueryOverlaps(_aabb, movableBounds, [&](int _movableIndex) { _proxyIDs.push_back(movableProxyIDs[_movableIndex]); });
+}
+
+void BruteForceBroadphase::AddPairs(int _movableIndex, bool _onlyHigherMovables, std::vector<BroadphasePair>& _pairs)
+{
+	AABB movableAABB = movableBounds.Get(_movableIndex);
+	int proxyID = movableProxyIDs[_movableIndex];
+
+	QueryOverlaps(movableAABB, staticBounds, [&](int _staticIndex)
+		{
+			_pairs.push_back({ proxyID, staticProxyIDs[_staticIndex] });
+		});
+
+	QueryOverlaps(movableAABB, movableBounds, [&](int _otherIndex)
+		{
+			if (_otherIndex == _movableIndex || (_onlyHigherMovables && _otherIndex < _movableIndex))
+				return;
+
+			_pairs.push_back({ proxyID, movableProxyIDs[_otherIndex] });
+		});
+}
@@ -1,12 +1,71 @@
 #include "Engine/Source/Public/Collision/CollisionManager.h"
 
+// Project Includes
+#include "Engine/Source/Public/Collision/SpatialHashGrid.h"
+
+CollisionManager::CollisionManager()
+{
+	contacts.reserve(MAX_COLLISION_CONTACTS);
+	broadphasePairs.reserve(MAX_COLLISION_CONTACTS);
+	broadphaseProxyIDs.reserve(MAX_COLLISION_CONTACTS);
+	pairCache.reserve(MAX_COLLISION_CONTACTS);
+	nextPairCache.reserve(MAX_COLLISION_CONTACTS);
+	contactPairs.reserve(MAX_COLLISION_CONTACTS);
+	broadphase = Broadphase::CreateBroadphase(broadphaseType);
+}
+
+CollisionManager::~CollisionManager()
+{
+	delete(broadphase);
+}
+
+void CollisionManager::SetBroadphaseType(BroadphaseType _broadphaseType)
+{
+	if (_broadphaseType == broadphaseType)
+		return;
+
+	Broadphase* newBroadphase = Broadphase::CreateBroadphase(_broadphaseType);
+	if (_broadphaseType == BroadphaseType::SpatialHashGrid)
+		static_cast<SpatialHashGrid*>(newBroadphase)->SetCellSize(spatialHashCellSize);
+
+	for (auto& [object, proxyID] : proxyIDs)
+		proxyID = newBroadphase->CreateProxy(object->GetWorldAABB(), object, broadphase->GetCollisionType(proxyID));
+
+	delete(broadphase);
+	broadphase = newBroadphase;
+	broadphaseType = _broadphaseType;
+}
+
+void CollisionManager::SetSpatialHashCellSize(float _cellSize)
+{
+	spatialHashCellSize = _cellSize;
+	if (broadphaseType == BroadphaseType::SpatialHashGrid)
+		static_cast<SpatialHashGrid*>(broadphase)->SetCellSize(_cellSize);
+}
+
 void CollisionManager::SubscribeObjectToCollisionManager(GameObject* inObject, CollisionTypes inCollisionType)
 {
 	collisionObserver[inCollisionType].push_back(inObject);
+
+	if (inCollisionType != CollisionTypes::NoCollision)
+		proxyIDs[inObject] = broadphase->CreateProxy(inObject->GetWorldAABB(), inObject, inCollisionType);
+	if (inCollisionType == CollisionTypes::MovableCollision)
+		previousAABBs[inObject] = inObject->GetWorldAABB();
 }
 
 void CollisionManager::UnsubscribeObjectFromCollisionManager(GameObject* inObject)
 {
+	// Anything still touching the object exits now, so no later check reports a pair with an unsubscribed object
+	auto exitedPairs = std::remove_if(pairCache.begin(), pairCache.end(), [&](const CachedCollisionPair& _pair)
+		{
+			if (_pair.first != inObject && _pair.second != inObject)
+				return false;
+
+			PushCollisionEvent(CollisionEventType::Exit, _pair.contact);
+			return true;
+		});
+	pairCache.erase(exitedPairs, pairCache.end());
+
 	for (auto& [collisionType, gameObjectList] : collisionObserver) 
 	{
 		// Find the GameObject* to remove using std::remove
@@ -15,76 +74,350 @@ void CollisionManager::UnsubscribeObjectFromCollisionManager(GameObject* inObjec
 		// If the object was found, remove it from the vector
 		if (it != gameObjectList.end()) {
 			gameObjectList.erase(it, gameObjectList.end());
+
+			auto proxy = proxyIDs.find(inObject);
+			if (proxy != proxyIDs.end() && collisionType != CollisionTypes::NoCollision)
+			{
+				broadphase->DestroyProxy(proxy->second);
+				proxyIDs.erase(proxy);
+			}
+			previousAABBs.erase(inObject);
 		}
 	}
 }
 
-std::pair<float, float> CollisionManager::NotifyCollisionManagerOfMovement(GameObject* inObject)
+const std::vector<CollisionContact>& CollisionManager::NotifyCollisionManagerOfMovement(GameObject* inObject)
 {
-	// Check if the object is movable and then run collision detection
-	auto object = std::find(collisionObserver[CollisionTypes::MovableCollision].begin(), collisionObserver[CollisionTypes::MovableCollision].end(), inObject);
-	
-	if (object != collisionObserver[CollisionTypes::MovableCollision].end())
+	contacts.clear();
+	contactsOverflowed = false;
+
+	// Only movable objects are checked, the proxy already knows which type the object is
+	auto proxy = proxyIDs.find(inObject);
+	if (proxy != proxyIDs.end() && broadphase->GetCollisionType(proxy->second) == CollisionTypes::MovableCollision)
 	{
-		std::pair<float, float> check = CheckForCollisions();
-		return check;
+		int proxyID = proxy->second;
+		broadphase->MoveProxy(proxyID, GetSweptAABB(inObject));
+
+		broadphasePairs.clear();
+		broadphase->QueryProxy(proxyID, broadphasePairs);
+		AddContacts(broadphasePairs);
+		UpdatePairCache(inObject);
+
+		previousAABBs[inObject] = inObject->GetWorldAABB();
 	}
 
-	return std::pair<float, float>(0.0f, 0.0f);
+	return contacts;
 }
 
-std::pair<float, float> CollisionManager::CheckForCollisions()
+const std::vector<CollisionContact>& CollisionManager::CheckForCollisions()
 {
+	contacts.clear();
+	contactsOverflowed = false;
+
+	// Movers are put in the broadphase with the bounds of their whole motion, so anything they passed through is a candidate
 	const auto& movableObjects = collisionObserver[CollisionTypes::MovableCollision];
-	const auto& staticObjects = collisionObserver[CollisionTypes::StaticCollision];
+	for (GameObject* movableObject : movableObjects)
+		broadphase->MoveProxy(proxyIDs[movableObject], GetSweptAABB(movableObject));
+
+	broadphasePairs.clear();
+	broadphase->UpdatePairs(broadphasePairs);
+	AddContacts(broadphasePairs);
+	UpdatePairCache(nullptr);
+
+	for (GameObject* movableObject : movableObjects)
+		previousAABBs[movableObject] = movableObject->GetWorldAABB();
+
+	return contacts;
+}
+
+bool CollisionManager::SweepObject(GameObject* inObject, const glm::vec3& _displacement, CollisionContact* _earliestContact)
+{
+	const AABB& currentAABB = inObject->GetWorldAABB();
+	AABB movedAABB = currentAABB;
+	movedAABB.minimumX += _displacement.x;
+	movedAABB.minimumY += _displacement.y;
+	movedAABB.minimumZ += _displacement.z;
+	movedAABB.maximumX += _displacement.x;
+	movedAABB.maximumY += _displacement.y;
+	movedAABB.maximumZ += _displacement.z;
+
+	broadphaseProxyIDs.clear();
+	broadphase->QueryAABB(MergeAABB(currentAABB, movedAABB), broadphaseProxyIDs);
+
+	bool hit = false;
+	for (int proxyID : broadphaseProxyIDs)
+	{
+		GameObject* otherObject = broadphase->GetGameObject(proxyID);
+		if (otherObject == inObject)
+			continue;
+
+		float timeOfImpact;
+		glm::vec3 normal;
+		if (!SweptAABBTimeOfImpact(currentAABB, _displacement, otherObject->GetWorldAABB(), &timeOfImpact, &normal))
+			continue;
+
+		if (!hit || timeOfImpact < _earliestContact->timeOfImpact)
+		{
+			_earliestContact->object = inObject;
+			_earliestContact->otherObject = otherObject;
+			_earliestContact->otherCollisionType = broadphase->GetCollisionType(proxyID);
+			_earliestContact->normal = normal;
+			_earliestContact->penetrationDepth = 0.0f;
+			_earliestContact->timeOfImpact = timeOfImpact;
+			hit = true;
+		}
+	}
+
+	return hit;
+}
+
+int CollisionManager::AddCollisionEventListener(const std::function<void(const CollisionEvent&)>& _listener)
+{
+	eventListeners.emplace_back(nextEventListenerID, _listener);
+	return nextEventListenerID++;
+}
+
+void CollisionManager::RemoveCollisionEventListener(int _listenerID)
+{
+	auto listener = std::remove_if(eventListeners.begin(), eventListeners.end(), [&](const auto& _listener) { return _listener.first == _listenerID; });
+	eventListeners.erase(listener, eventListeners.end());
+}
+
+void CollisionManager::DispatchCollisionEvents()
+{
+	// Listeners must not be added or removed from inside a listener
+	CollisionEvent event;
+	while (collisionEvents.Pop(&event))
+	{
+		for (const auto& [listenerID, listener] : eventListeners)
+			listener(event);
+	}
+
+	eventsOverflowed = false;
+}
+
+void CollisionManager::QueryRadius(const glm::vec3& _center, float _radius, std::vector<GameObject*>& _results)
+{
+	AABB sphereAABB;
+	sphereAABB.minimumX = _center.x - _radius;
+	sphereAABB.minimumY = _center.y - _radius;
+	sphereAABB.minimumZ = _center.z - _radius;
+	sphereAABB.maximumX = _center.x + _radius;
+	sphereAABB.maximumY = _center.y + _radius;
+	sphereAABB.maximumZ = _center.z + _radius;
+
+	broadphaseProxyIDs.clear();
+	broadphase->QueryAABB(sphereAABB, broadphaseProxyIDs);
+
+	// Broadphase bounds can be fattened or swept, so test the object's real bounds
+	for (int proxyID : broadphaseProxyIDs)
+	{
+		GameObject* gameObject = broadphase->GetGameObject(proxyID);
+		if (SphereOverlapsAABB(_center, _radius, gameObject->GetWorldAABB()))
+			_results.push_back(gameObject);
+	}
+}
+
+float CollisionManager::GetEarliestTimeOfImpact(GameObject* inObject)
+{
+	float earliestTimeOfImpact = 1.0f;
+	for (const CollisionContact& contact : contacts)
+	{
+		if (contact.object == inObject || contact.otherObject == inObject)
+			earliestTimeOfImpact = std::min(earliestTimeOfImpact, contact.timeOfImpact);
+	}
+
+	return earliestTimeOfImpact;
+}
+
+AABB CollisionManager::GetSweptAABB(GameObject* _object)
+{
+	return MergeAABB(previousAABBs[_object], _object->GetWorldAABB());
+}
+
+glm::vec3 CollisionManager::GetDisplacement(GameObject* _object)
+{
+	const AABB& previousAABB = previousAABBs.at(_object);
+	const AABB& currentAABB = _object->GetWorldAABB();
+
+	return glm::vec3(
+		(currentAABB.minimumX + currentAABB.maximumX) - (previousAABB.minimumX + previousAABB.maximumX),
+		(currentAABB.minimumY + currentAABB.maximumY) - (previousAABB.minimumY + previousAABB.maximumY),
+		(currentAABB.minimumZ + currentAABB.maximumZ) - (previousAABB.minimumZ + previousAABB.maximumZ)) * 0.5f;
+}
 
-	for (GameObject* moveableObject : movableObjects)
+void CollisionManager::AddContacts(const std::vector<BroadphasePair>& _pairs)
+{
+	// World bounds are calculated lazily, make sure none get written while the batches read them
+	for (const BroadphasePair& pair : _pairs)
 	{
-		AABB movableAABB = CalculateMeshAABB(moveableObject);
+		broadphase->GetGameObject(pair.proxyID)->GetWorldAABB();
+		broadphase->GetGameObject(pair.otherProxyID)->GetWorldAABB();
+	}
+
+	size_t batchCount = (_pairs.size() + narrowphaseBatchSize - 1) / narrowphaseBatchSize;
+	if (batchContacts.size() < batchCount)
+		batchContacts.resize(batchCount);
 
-		for (GameObject* staticObject : staticObjects)
+	// One batch per index, so a thread never shares a contact buffer
+	ParallelFor(batchCount, minimumBatchesPerThread, [&](size_t _batch)
 		{
-			AABB staticAABB = CalculateMeshAABB(staticObject);
+			std::vector<CollisionContact>& batch = batchContacts[_batch];
+			batch.clear();
 
-			if (AABBIntersect(movableAABB, staticAABB))
+			size_t last = std::min(_pairs.size(), (_batch + 1) * narrowphaseBatchSize);
+			for (size_t i = _batch * narrowphaseBatchSize; i < last; i++)
 			{
-				//std::cout << "Collision detected!" << std::endl;
-				return std::pair<float, float>(staticAABB.maximumY, std::abs(movableAABB.minimumY - staticAABB.maximumY));
+				CollisionContact contact;
+				if (NarrowphasePair(_pairs[i], &contact))
+					batch.push_back(contact);
 			}
-		}
+		});
+
+	for (size_t batch = 0; batch < batchCount; batch++)
+	{
+		for (const CollisionContact& contact : batchContacts[batch])
+			AddContact(contact);
 	}
 }
 
-AABB CollisionManager::CalculateMeshAABB(GameObject* inObject)
+bool CollisionManager::NarrowphasePair(const BroadphasePair& _pair, CollisionContact* _contact)
 {
-	float minX = std::numeric_limits<float>::max();
-	float minY = std::numeric_limits<float>::max();
-	float maxX = std::numeric_limits<float>::lowest();
-	float maxY = std::numeric_limits<float>::lowest();
+	_contact->object = broadphase->GetGameObject(_pair.proxyID);
+	_contact->otherObject = broadphase->GetGameObject(_pair.otherProxyID);
+	_contact->otherCollisionType = broadphase->GetCollisionType(_pair.otherProxyID);
+
+	bool overlapping = AABBIntersect(_contact->object->GetWorldAABB(), _contact->otherObject->GetWorldAABB(), _contact);
 
-	for (const auto vertex : inObject->objectMesh->GetVertices())
+	// Sweep in the other object's frame, so two movers use their relative motion
+	glm::vec3 displacement = GetDisplacement(_contact->object);
+	AABB otherStartAABB = _contact->otherObject->GetWorldAABB();
+	if (_contact->otherCollisionType == CollisionTypes::MovableCollision)
 	{
-		glm::vec4 transformedPosition = inObject->GetModel().modelMatrix * glm::vec4(vertex.x, vertex.y, vertex.z, 1.0f);
+		displacement -= GetDisplacement(_contact->otherObject);
+		otherStartAABB = previousAABBs.at(_contact->otherObject);
+	}
+
+	float timeOfImpact;
+	glm::vec3 sweptNormal;
+	bool swept = SweptAABBTimeOfImpact(previousAABBs.at(_contact->object), displacement, otherStartAABB, &timeOfImpact, &sweptNormal);
+	if (!overlapping && !swept)
+		return false;
+
+	if (swept)
+	{
+		_contact->timeOfImpact = timeOfImpact;
 
-		if (transformedPosition.x < minX) minX = transformedPosition.x;
-		if (transformedPosition.y < minY) minY = transformedPosition.y;
-		if (transformedPosition.x > maxX) maxX = transformedPosition.x;
-		if (transformedPosition.y > maxY) maxY = transformedPosition.y;
+		// The face hit first is a better push out direction than the shallowest axis once an object has sunk deep in
+		if (timeOfImpact > 0.0f)
+			_contact->normal = sweptNormal;
+		if (!overlapping)
+			_contact->penetrationDepth = 0.0f;
 	}
+	else
+		_contact->timeOfImpact = 1.0f;
 
-	AABB modelAABB;
-	modelAABB.minimumX = minX;
-	modelAABB.maximumX = maxX;
-	modelAABB.minimumY = minY;
-	modelAABB.maximumY = maxY;
+	return true;
+}
 
-	return modelAABB;
+void CollisionManager::AddContact(const CollisionContact& _contact)
+{
+	// Never grow past the reserved capacity so checks do not allocate
+	if (contacts.size() >= MAX_COLLISION_CONTACTS)
+	{
+		if (!contactsOverflowed)
+			std::cout << "Warning: more than " << MAX_COLLISION_CONTACTS << " collision contacts, extra contacts are dropped" << std::endl;
+
+		contactsOverflowed = true;
+		return;
+	}
+
+	contacts.push_back(_contact);
 }
 
-bool CollisionManager::AABBIntersect(AABB first, AABB second)
+void CollisionManager::UpdatePairCache(GameObject* _onlyObject)
 {
-    bool xOverlap = (first.minimumX <= second.maximumX) && (first.maximumX >= second.minimumX);
-    bool yOverlap = (first.minimumY <= second.maximumY) && (first.maximumY >= second.minimumY);
+	contactPairs.clear();
+	for (const CollisionContact& contact : contacts)
+	{
+		CachedCollisionPair pair;
+		bool objectFirst = std::less<GameObject*>()(contact.object, contact.otherObject);
+		pair.first = objectFirst ? contact.object : contact.otherObject;
+		pair.second = objectFirst ? contact.otherObject : contact.object;
+		pair.contact = contact;
+		contactPairs.push_back(pair);
+	}
+	std::sort(contactPairs.begin(), contactPairs.end());
+
+	// Both lists are sorted, so one merge pass finds which pairs are new, which are still touching and which have stopped
+	nextPairCache.clear();
+	size_t cached = 0;
+	size_t current = 0;
+	while (cached < pairCache.size() || current < contactPairs.size())
+	{
+		if (current == contactPairs.size() || (cached < pairCache.size() && pairCache[cached] < contactPairs[current]))
+		{
+			const CachedCollisionPair& pair = pairCache[cached++];
+			if (_onlyObject == nullptr || pair.first == _onlyObject || pair.second == _onlyObject)
+				PushCollisionEvent(CollisionEventType::Exit, pair.contact);
+			else
+				nextPairCache.push_back(pair);
+		}
+		else if (cached == pairCache.size() || contactPairs[current] < pairCache[cached])
+		{
+			PushCollisionEvent(CollisionEventType::Enter, contactPairs[current].contact);
+			nextPairCache.push_back(contactPairs[current++]);
+		}
+		else
+		{
+			PushCollisionEvent(CollisionEventType::Stay, contactPairs[current].contact);
+			nextPairCache.push_back(contactPairs[current++]);
+			cached++;
+		}
+	}
+
+	std::swap(pairCache, nextPairCache);
+}
+
+void CollisionManager::PushCollisionEvent(CollisionEventType _type, const CollisionContact& _contact)
+{
+	CollisionEvent event;
+	event.type = _type;
+	event.contact = _contact;
+
+	if (!collisionEvents.Push(event))
+	{
+		if (!eventsOverflowed)
+			std::cout << "Warning: more than " << MAX_COLLISION_EVENTS << " collision events queued, call DispatchCollisionEvents after every tick" << std::endl;
+
+		eventsOverflowed = true;
+	}
+}
+
+bool CollisionManager::AABBIntersect(const AABB& _first, const AABB& _second, CollisionContact* _contact)
+{
+	if (!AABBOverlaps(_first, _second))
+		return false;
+
+	// The axis with the smallest overlap is the shortest way to separate the boxes
+	glm::vec3 overlap(
+		std::min(_first.maximumX, _second.maximumX) - std::max(_first.minimumX, _second.minimumX),
+		std::min(_first.maximumY, _second.maximumY) - std::max(_first.minimumY, _second.minimumY),
+		std::min(_first.maximumZ, _second.maximumZ) - std::max(_first.minimumZ, _second.minimumZ));
+
+	int axis = 0;
+	if (overlap[1] < overlap[axis])
+		axis = 1;
+	if (overlap[2] < overlap[axis])
+		axis = 2;
+
+	// Push _first away from the centre of _second
+	float firstCenter[3] = { _first.minimumX + _first.maximumX, _first.minimumY + _first.maximumY, _first.minimumZ + _first.maximumZ };
+	float secondCenter[3] = { _second.minimumX + _second.maximumX, _second.minimumY + _second.maximumY, _second.minimumZ + _second.maximumZ };
+
+	_contact->normal = glm::vec3(0.0f);
+	_contact->normal[axis] = (firstCenter[axis] >= secondCenter[axis]) ? 1.0f : -1.0f;
+	_contact->penetrationDepth = overlap[axis];
 
-    return xOverlap && yOverlap;
+	return true;
 }
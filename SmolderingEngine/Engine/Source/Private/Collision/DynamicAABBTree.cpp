@@ -0,0 +1,306 @@
+#include "Engine/Source/Public/Collision/DynamicAABBTree.h"
+
+DynamicAABBTree::DynamicAABBTree(float _aabbMargin)
+	: aabbMargin(_aabbMargin)
+{
+}
+
+int DynamicAABBTree::CreateProxy(const AABB& _aabb, GameObject* _gameObject)
+{
+	int proxyID = AllocateNode();
+
+	nodes[proxyID].aabb = ExpandAABB(_aabb, aabbMargin);
+	nodes[proxyID].gameObject = _gameObject;
+	nodes[proxyID].height = 0;
+
+	InsertLeaf(proxyID);
+	proxyCount++;
+
+	return proxyID;
+}
+
+void DynamicAABBTree::DestroyProxy(int _proxyID)
+{
+	RemoveLeaf(_proxyID);
+	FreeNode(_proxyID);
+	proxyCount--;
+}
+
+bool DynamicAABBTree::MoveProxy(int _proxyID, const AABB& _aabb)
+{
+	// Still inside the fat AABB, nothing in the tree needs to change
+	if (AABBContains(nodes[_proxyID].aabb, _aabb))
+		return false;
+
+	RemoveLeaf(_proxyID);
+	nodes[_proxyID].aabb = ExpandAABB(_aabb, aabbMargin);
+	InsertLeaf(_proxyID);
+
+	return true;
+}
+
+int DynamicAABBTree::AllocateNode()
+{
+	// Reuse a freed node before growing the node pool
+	if (freeList != NULL_NODE)
+	{
+		int nodeID = freeList;
+		freeList = nodes[nodeID].parentOrNext;
+		nodes[nodeID] = DynamicAABBTreeNode();
+		return nodeID;
+	}
+
+	nodes.emplace_back();
+	return static_cast<int>(nodes.size()) - 1;
+}
+
+void DynamicAABBTree::FreeNode(int _nodeID)
+{
+	nodes[_nodeID].parentOrNext = freeList;
+	nodes[_nodeID].height = -1;
+	nodes[_nodeID].gameObject = nullptr;
+	freeList = _nodeID;
+}
+
+void DynamicAABBTree::InsertLeaf(int _leafID)
+{
+	if (rootNode == NULL_NODE)
+	{
+		rootNode = _leafID;
+		nodes[rootNode].parentOrNext = NULL_NODE;
+		return;
+	}
+
+	// Walk down the tree picking the child that grows the total surface area the least
+	AABB leafAABB = nodes[_leafID].aabb;
+	int index = rootNode;
+	while (!nodes[index].IsLeaf())
+	{
+		int child1 = nodes[index].child1;
+		int child2 = nodes[index].child2;
+
+		float area = AABBSurfaceArea(nodes[index].aabb);
+		float combinedArea = AABBSurfaceArea(MergeAABB(nodes[index].aabb, leafAABB));
+
+		// Cost of making a new parent for this node and the leaf
+		float cost = 2.0f * combinedArea;
+
+		// Minimum cost of pushing the leaf further down the tree
+		float inheritanceCost = 2.0f * (combinedArea - area);
+
+		auto descendCost = [&](int _childID)
+		{
+			float mergedArea = AABBSurfaceArea(MergeAABB(leafAABB, nodes[_childID].aabb));
+			if (nodes[_childID].IsLeaf())
+				return mergedArea + inheritanceCost;
+
+			return (mergedArea - AABBSurfaceArea(nodes[_childID].aabb)) + inheritanceCost;
+		};
+
+		float cost1 = descendCost(child1);
+		float cost2 = descendCost(child2);
+
+		if (cost < cost1 && cost < cost2)
+			break;
+
+		index = (cost1 < cost2) ? child1 : child2;
+	}
+
+	int sibling = index;
+
+	// Create a new parent for the sibling and the leaf. AllocateNode can grow the vector so only hold indices.
+	int oldParent = nodes[sibling].parentOrNext;
+	int newParent = AllocateNode();
+	nodes[newParent].parentOrNext = oldParent;
+	nodes[newParent].aabb = MergeAABB(leafAABB, nodes[sibling].aabb);
+	nodes[newParent].height = nodes[sibling].height + 1;
+	nodes[newParent].child1 = sibling;
+	nodes[newParent].child2 = _leafID;
+	nodes[sibling].parentOrNext = newParent;
+	nodes[_leafID].parentOrNext = newParent;
+
+	if (oldParent != NULL_NODE)
+	{
+		if (nodes[oldParent].child1 == sibling)
+			nodes[oldParent].child1 = newParent;
+		else
+			nodes[oldParent].child2 = newParent;
+	}
+	else
+		rootNode = newParent;
+
+	// Walk back up fixing heights and AABBs
+	index = nodes[_leafID].parentOrNext;
+	while (index != NULL_NODE)
+	{
+		index = Balance(index);
+
+		int child1 = nodes[index].child1;
+		int child2 = nodes[index].child2;
+		nodes[index].height = 1 + std::max(nodes[child1].height, nodes[child2].height);
+		nodes[index].aabb = MergeAABB(nodes[child1].aabb, nodes[child2].aabb);
+
+		index = nodes[index].parentOrNext;
+	}
+}
+
+void DynamicAABBTree::RemoveLeaf(int _leafID)
+{
+	if (_leafID == rootNode)
+	{
+		rootNode = NULL_NODE;
+		return;
+	}
+
+	int parent = nodes[_leafID].parentOrNext;
+	int grandParent = nodes[parent].parentOrNext;
+	int sibling = (nodes[parent].child1 == _leafID) ? nodes[parent].child2 : nodes[parent].child1;
+
+	if (grandParent == NULL_NODE)
+	{
+		rootNode = sibling;
+		nodes[sibling].parentOrNext = NULL_NODE;
+		FreeNode(parent);
+		return;
+	}
+
+	// Destroy the parent and connect the sibling to the grand parent
+	if (nodes[grandParent].child1 == parent)
+		nodes[grandParent].child1 = sibling;
+	else
+		nodes[grandParent].child2 = sibling;
+	nodes[sibling].parentOrNext = grandParent;
+	FreeNode(parent);
+
+	// Adjust ancestor bounds
+	int index = grandParent;
+	while (index != NULL_NODE)
+	{
+		index = Balance(index);
+
+		int child1 = nodes[index].child1;
+		int child2 = nodes[index].child2;
+		nodes[index].aabb = MergeAABB(nodes[child1].aabb, nodes[child2].aabb);
+		nodes[index].height = 1 + std::max(nodes[child1].height, nodes[child2].height);
+
+		index = nodes[index].parentOrNext;
+	}
+}
+
+int DynamicAABBTree::Balance(int _nodeID)
+{
+	DynamicAABBTreeNode& a = nodes[_nodeID];
+	if (a.IsLeaf() || a.height < 2)
+		return _nodeID;
+
+	int bID = a.child1;
+	int cID = a.child2;
+	DynamicAABBTreeNode& b = nodes[bID];
+	DynamicAABBTreeNode& c = nodes[cID];
+
+	int balance = c.height - b.height;
+
+	// Rotate C up
+	if (balance > 1)
+	{
+		int fID = c.child1;
+		int gID = c.child2;
+		DynamicAABBTreeNode& f = nodes[fID];
+		DynamicAABBTreeNode& g = nodes[gID];
+
+		// Swap A and C
+		c.child1 = _nodeID;
+		c.parentOrNext = a.parentOrNext;
+		a.parentOrNext = cID;
+
+		// A's old parent should point to C
+		if (c.parentOrNext != NULL_NODE)
+		{
+			if (nodes[c.parentOrNext].child1 == _nodeID)
+				nodes[c.parentOrNext].child1 = cID;
+			else
+				nodes[c.parentOrNext].child2 = cID;
+		}
+		else
+			rootNode = cID;
+
+		// Keep the taller of F and G under C
+		if (f.height > g.height)
+		{
+			c.child2 = fID;
+			a.child2 = gID;
+			g.parentOrNext = _nodeID;
+			a.aabb = MergeAABB(b.aabb, g.aabb);
+			c.aabb = MergeAABB(a.aabb, f.aabb);
+
+			a.height = 1 + std::max(b.height, g.height);
+			c.height = 1 + std::max(a.height, f.height);
+		}
+		else
+		{
+			c.child2 = gID;
+			a.child2 = fID;
+			f.parentOrNext = _nodeID;
+			a.aabb = MergeAABB(b.aabb, f.aabb);
+			c.aabb = MergeAABB(a.aabb, g.aabb);
+
+			a.height = 1 + std::max(b.height, f.height);
+			c.height = 1 + std::max(a.height, g.height);
+		}
+
+		return cID;
+	}
+
+	// Rotate B up
+	if (balance < -1)
+	{
+		int dID = b.child1;
+		int eID = b.child2;
+		DynamicAABBTreeNode& d = nodes[dID];
+		DynamicAABBTreeNode& e = nodes[eID];
+
+		// Swap A and B
+		b.child1 = _nodeID;
+		b.parentOrNext = a.parentOrNext;
+		a.parentOrNext = bID;
+
+		// A's old parent should point to B
+		if (b.parentOrNext != NULL_NODE)
+		{
+			if (nodes[b.parentOrNext].child1 == _nodeID)
+				nodes[b.parentOrNext].child1 = bID;
+			else
+				nodes[b.parentOrNext].child2 = bID;
+		}
+		else
+			rootNode = bID;
+
+		// Keep the taller of D and E under B
+		if (d.height > e.height)
+		{
+			b.child2 = dID;
+			a.child1 = eID;
+			e.parentOrNext = _nodeID;
+			a.aabb = MergeAABB(c.aabb, e.aabb);
+			b.aabb = MergeAABB(a.aabb, d.aabb);
+
+			a.height = 1 + std::max(c.height, e.height);
+			b.height = 1 + std::max(a.height, d.height);
+		}
+		else
+		{
+			b.child2 = eID;
+			a.child1 = dID;
+			d.parentOrNext = _nodeID;
+			a.aabb = MergeAABB(c.aabb, d.aabb);
+			b.aabb = MergeAABB(a.aabb, e.aabb);
+
+			a.height = 1 + std::max(c.height, d.height);
+			b.height = 1 + std::max(a.height, e.height);
+		}
+
+		return bID;
+	}
+
+	return _nodeID;
+}
@@ -0,0 +1,242 @@
+#include "Engine/Source/Public/Collision/SpatialHashGrid.h"
+
+// Standard Library
+#include <cmath>
+#include <stdexcept>
+
+SpatialHashGrid::SpatialHashGrid(float _cellSize)
+{
+	SetCellSize(_cellSize);
+}
+
+int SpatialHashGrid::CreateProxy(const AABB& _aabb, GameObject* _gameObject, CollisionTypes _collisionType)
+{
+	int proxyID;
+	if (freeList != -1)
+	{
+		proxyID = freeList;
+		freeList = proxies[proxyID].next;
+	}
+	else
+	{
+		proxyID = static_cast<int>(proxies.size());
+		proxies.emplace_back();
+	}
+
+	SpatialHashProxy& proxy = proxies[proxyID];
+	proxy.aabb = _aabb;
+	proxy.gameObject = _gameObject;
+	proxy.collisionType = _collisionType;
+	proxy.free = false;
+
+	// IDs are reused, so the new one can land anywhere in the list
+	SpatialHashTable& table = GetTable(_collisionType);
+	table.proxyIDs.insert(std::lower_bound(table.proxyIDs.begin(), table.proxyIDs.end(), proxyID), proxyID);
+	table.dirty = true;
+	return proxyID;
+}
+
+void SpatialHashGrid::DestroyProxy(int _proxyID)
+{
+	SpatialHashProxy& proxy = proxies[_proxyID];
+	proxy.free = true;
+	proxy.gameObject = nullptr;
+	proxy.next = freeList;
+	freeList = _proxyID;
+
+	SpatialHashTable& table = GetTable(proxy.collisionType);
+	table.proxyIDs.erase(std::lower_bound(table.proxyIDs.begin(), table.proxyIDs.end(), _proxyID));
+	table.dirty = true;
+}
+
+void SpatialHashGrid::MoveProxy(int _proxyID, const AABB& _aabb)
+{
+	proxies[_proxyID].aabb = _aabb;
+	GetTable(proxies[_proxyID].collisionType).dirty = true;
+}
+
+void SpatialHashGrid::UpdatePairs(std::vector<BroadphasePair>& _pairs)
+{
+	RebuildIfDirty();
+
+	for (int proxyID : movableTable.proxyIDs)
+		AddPairs(proxyID, true, _pairs);
+}
+
+void SpatialHashGrid::QueryProxy(int _proxyID, std::vector<BroadphasePair>& _pairs)
+{
+	if (proxies[_proxyID].collisionType != CollisionTypes::MovableCollision)
+		return;
+
+	RebuildIfDirty();
+	AddPairs(_proxyID, false, _pairs);
+}
+
+void SpatialHashGrid::QueryAABB(const AABB& _aabb, std::vector<int>& _proxyIDs)
+{
+	RebuildIfDirty();
+	ForEachOverlap(staticTable, _aabb, [&](int _otherID) { _proxyIDs.push_back(_otherID); });
+	ForEachOverlap(movableTable, _aabb, [&](int _otherID) { _proxyIDs.push_back(_otherID); });
+}
+
+void SpatialHashGrid::SetCellSize(float _cellSize)
+{
+	if (_cellSize <= 0.0f)
+		throw std::runtime_error("Spatial hash grid cell size must be greater than 0!");
+
+	cellSize = _cellSize;
+	inverseCellSize = 1.0f / _cellSize;
+	staticTable.dirty = true;
+	movableTable.dirty = true;
+}
+
+void SpatialHashGrid::RebuildIfDirty()
+{
+	if (staticTable.dirty)
+		Rebuild(staticTable);
+	if (movableTable.dirty)
+		Rebuild(movableTable);
+}
+
+void SpatialHashGrid::Rebuild(SpatialHashTable& _table)
+{
+	_table.cellProxyIDs.clear();
+	_table.oversizedProxyIDs.clear();
+
+	// Count the cell entries first so the table can be sized once, kept at most half full for short probes
+	int64_t entryCount = 0;
+	for (int proxyID : _table.proxyIDs)
+	{
+		int64_t cellCount = GetCellRange(proxies[proxyID].aabb).GetCellCount();
+		if (cellCount <= maxCellsPerProxy)
+			entryCount += cellCount;
+	}
+
+	size_t capacity = 16;
+	while (capacity < static_cast<size_t>(entryCount) * 2)
+		capacity *= 2;
+
+	_table.cells.assign(capacity, SpatialHashCell());
+
+	// Pass 1: find or insert every covered cell and count its proxies
+	for (int proxyID : _table.proxyIDs)
+	{
+		SpatialHashCellRange range = GetCellRange(proxies[proxyID].aabb);
+		if (range.GetCellCount() > maxCellsPerProxy)
+		{
+			_table.oversizedProxyIDs.push_back(proxyID);
+			continue;
+		}
+
+		for (int z = range.minimumZ; z <= range.maximumZ; z++)
+		{
+			for (int y = range.minimumY; y <= range.maximumY; y++)
+			{
+				for (int x = range.minimumX; x <= range.maximumX; x++)
+				{
+					SpatialHashCell& cell = _table.cells[FindCellSlot(_table, x, y, z)];
+					if (cell.IsEmpty())
+					{
+						cell.x = x;
+						cell.y = y;
+						cell.z = z;
+						cell.count = 0;
+					}
+					cell.count++;
+				}
+			}
+		}
+	}
+
+	// Pass 2: give every cell its own range in the compact proxy list
+	int start = 0;
+	for (SpatialHashCell& cell : _table.cells)
+	{
+		if (cell.IsEmpty())
+			continue;
+
+		cell.start = start;
+		start += cell.count;
+		cell.count = 0;
+	}
+	_table.cellProxyIDs.resize(start);
+
+	// Pass 3: fill the ranges, proxies are added in ID order so every cell's list is in ID order too
+	for (int proxyID : _table.proxyIDs)
+	{
+		SpatialHashCellRange range = GetCellRange(proxies[proxyID].aabb);
+		if (range.GetCellCount() > maxCellsPerProxy)
+			continue;
+
+		for (int z = range.minimumZ; z <= range.maximumZ; z++)
+		{
+			for (int y = range.minimumY; y <= range.maximumY; y++)
+			{
+				for (int x = range.minimumX; x <= range.maximumX; x++)
+				{
+					SpatialHashCell& cell = _table.cells[FindCellSlot(_table, x, y, z)];
+					_table.cellProxyIDs[cell.start + cell.count++] = proxyID;
+				}
+			}
+		}
+	}
+
+	_table.dirty = false;
+}
+
+SpatialHashCellRange SpatialHashGrid::GetCellRange(const AABB& _aabb) const
+{
+	SpatialHashCellRange range;
+	range.minimumX = GetCell(_aabb.minimumX);
+	range.minimumY = GetCell(_aabb.minimumY);
+	range.minimumZ = GetCell(_aabb.minimumZ);
+	range.maximumX = GetCell(_aabb.maximumX);
+	range.maximumY = GetCell(_aabb.maximumY);
+	range.maximumZ = GetCell(_aabb.maximumZ);
+
+	return range;
+}
+
+int SpatialHashGrid::GetCell(float _value) const
+{
+	// Clamped so objects far outside the level can not overflow the cell coordinates
+	const float maxCell = 1000000.0f;
+	return static_cast<int>(std::floor(std::clamp(_value * inverseCellSize, -maxCell, maxCell)));
+}
+
+unsigned int SpatialHashGrid::HashCell(int _x, int _y, int _z) const
+{
+	// Large primes from "Optimized Spatial Hashing for Collision Detection of Deformable Objects" (Teschner et al. 2003)
+	return (static_cast<unsigned int>(_x) * 73856093u) ^ (static_cast<unsigned int>(_y) * 19349663u) ^ (static_cast<unsigned int>(_z) * 83492791u);
+}
+
+int SpatialHashGrid::FindCellSlot(const SpatialHashTable& _table, int _x, int _y, int _z) const
+{
+	unsigned int mask = static_cast<unsigned int>(_table.cells.size()) - 1;
+	unsigned int slot = HashCell(_x, _y, _z) & mask;
+
+	// The table is never more than half full so there is always an empty slot to stop at
+	while (true)
+	{
+		const SpatialHashCell& cell = _table.cells[slot];
+		if (cell.IsEmpty() || (cell.x == _x && cell.y == _y && cell.z == _z))
+			return static_cast<int>(slot);
+
+		slot = (slot + 1) & mask;
+	}
+}
+
+void SpatialHashGrid::AddPairs(int _proxyID, bool _onlyHigherMovables, std::vector<BroadphasePair>& _pairs) const
+{
+	const AABB& aabb = proxies[_proxyID].aabb;
+
+	ForEachOverlap(staticTable, aabb, [&](int _staticID) { _pairs.push_back({ _proxyID, _staticID }); });
+
+	ForEachOverlap(movableTable, aabb, [&](int _otherID)
+		{
+			if (_otherID == _proxyID || (_onlyHigherMovables && _otherID < _proxyID))
+				return;
+
+			_pairs.push_back({ _proxyID, _otherID });
+		});
+}
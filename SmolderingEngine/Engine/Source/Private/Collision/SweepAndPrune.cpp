@@ -0,0 +1,224 @@
+#include "Engine/Source/Public/Collision/SweepAndPrune.h"
+
+// Minimums sort before maximums at the same value so touching AABBs are still reported, like AABBOverlaps
+static bool EndpointLess(const SweepAndPruneEndpoint& _first, const SweepAndPruneEndpoint& _second)
+{
+	if (_first.value != _second.value)
+		return _first.value < _second.value;
+
+	return _first.isMinimum && !_second.isMinimum;
+}
+
+int SweepAndPrune::CreateProxy(const AABB& _aabb, GameObject* _gameObject, CollisionTypes _collisionType)
+{
+	int proxyID;
+	if (freeList != -1)
+	{
+		proxyID = freeList;
+		freeList = proxies[proxyID].activeIndexOrNext;
+	}
+	else
+	{
+		proxyID = static_cast<int>(proxies.size());
+		proxies.emplace_back();
+	}
+
+	SweepAndPruneProxy& proxy = proxies[proxyID];
+	proxy.aabb = _aabb;
+	proxy.gameObject = _gameObject;
+	proxy.collisionType = _collisionType;
+	proxy.activeIndexOrNext = -1;
+	proxy.free = false;
+
+	// Values are filled in and the endpoints moved into place on the next sort
+	endpoints.push_back({ 0.0f, proxyID, true });
+	endpoints.push_back({ 0.0f, proxyID, false });
+	unsortedEndpointCount += 2;
+
+	return proxyID;
+}
+
+void SweepAndPrune::DestroyProxy(int _proxyID)
+{
+	// Removing keeps the rest of the array in order, destroying is rare enough for the O(n) erase
+	endpoints.erase(std::remove_if(endpoints.begin(), endpoints.end(),
+		[_proxyID](const SweepAndPruneEndpoint& _endpoint) { return _endpoint.proxyID == _proxyID; }), endpoints.end());
+
+	proxies[_proxyID].free = true;
+	proxies[_proxyID].gameObject = nullptr;
+	proxies[_proxyID].activeIndexOrNext = freeList;
+	freeList = _proxyID;
+}
+
+void SweepAndPrune::MoveProxy(int _proxyID, const AABB& _aabb)
+{
+	proxies[_proxyID].aabb = _aabb;
+}
+
+void SweepAndPrune::UpdatePairs(std::vector<BroadphasePair>& _pairs)
+{
+	SortEndpoints();
+
+	activeStaticBounds.Clear();
+	activeStaticProxies.clear();
+	activeMovableBounds.Clear();
+	activeMovableProxies.clear();
+
+	for (const SweepAndPruneEndpoint& endpoint : endpoints)
+	{
+		SweepAndPruneProxy& proxy = proxies[endpoint.proxyID];
+		bool movable = proxy.collisionType == CollisionTypes::MovableCollision;
+		AABBArrays& activeBounds = movable ? activeMovableBounds : activeStaticBounds;
+		std::vector<int>& activeProxies = movable ? activeMovableProxies : activeStaticProxies;
+
+		if (!endpoint.isMinimum)
+		{
+			// Swap remove from the active list
+			int movedFromIndex = activeBounds.RemoveSwap(proxy.activeIndexOrNext);
+			activeProxies[proxy.activeIndexOrNext] = activeProxies[movedFromIndex];
+			proxies[activeProxies[proxy.activeIndexOrNext]].activeIndexOrNext = proxy.activeIndexOrNext;
+			activeProxies.pop_back();
+			continue;
+		}
+
+		// Everything active overlaps on the sort axis, the batch test checks the other two axes
+		QueryOverlaps(proxy.aabb, activeMovableBounds, [&](int _activeIndex)
+			{
+				AddPair(endpoint.proxyID, activeMovableProxies[_activeIndex], _pairs);
+			});
+
+		if (movable)
+		{
+			QueryOverlaps(proxy.aabb, activeStaticBounds, [&](int _activeIndex)
+				{
+					AddPair(endpoint.proxyID, activeStaticProxies[_activeIndex], _pairs);
+				});
+		}
+
+		proxy.activeIndexOrNext = activeBounds.Add(proxy.aabb);
+		activeProxies.push_back(endpoint.proxyID);
+	}
+}
+
+void SweepAndPrune::QueryProxy(int _proxyID, std::vector<BroadphasePair>& _pairs)
+{
+	if (proxies[_proxyID].collisionType != CollisionTypes::MovableCollision)
+		return;
+
+	// A single query would have to re-sort the whole array first, a linear pass over the proxies is cheaper
+	const AABB& queryAABB = proxies[_proxyID].aabb;
+	for (int proxyID = 0; proxyID < static_cast<int>(proxies.size()); proxyID++)
+	{
+		if (proxyID == _proxyID || proxies[proxyID].free)
+			continue;
+
+		if (AABBOverlaps(queryAABB, proxies[proxyID].aabb))
+			AddPair(_proxyID, proxyID, _pairs);
+	}
+}
+
+void SweepAndPrune::QueryAABB(const AABB& _aabb, std::vector<int>& _proxyIDs)
+{
+	// Same reasoning as QueryProxy, one query is not worth a sort
+	for (int proxyID = 0; proxyID < static_cast<int>(proxies.size()); proxyID++)
+	{
+		if (!proxies[proxyID].free && AABBOverlaps(_aabb, proxies[proxyID].aabb))
+			_proxyIDs.push_back(proxyID);
+	}
+}
+
+void SweepAndPrune::SortEndpoints()
+{
+	bool axisChanged = ChooseSortAxis();
+
+	for (SweepAndPruneEndpoint& endpoint : endpoints)
+	{
+		const AABB& aabb = proxies[endpoint.proxyID].aabb;
+		endpoint.value = endpoint.isMinimum ? GetAxisMinimum(aabb) : GetAxisMaximum(aabb);
+	}
+
+	// Inserting many new endpoints one by one is O(n) each, sort from scratch instead
+	if (axisChanged || unsortedEndpointCount > 64)
+	{
+		std::sort(endpoints.begin(), endpoints.end(), EndpointLess);
+		unsortedEndpointCount = 0;
+		return;
+	}
+
+	// Frame to frame coherence keeps the array almost sorted, so this only moves a few endpoints a few places
+	for (size_t i = 1; i < endpoints.size(); i++)
+	{
+		SweepAndPruneEndpoint endpoint = endpoints[i];
+		size_t j = i;
+		while (j > 0 && EndpointLess(endpoint, endpoints[j - 1]))
+		{
+			endpoints[j] = endpoints[j - 1];
+			j--;
+		}
+		endpoints[j] = endpoint;
+	}
+
+	unsortedEndpointCount = 0;
+}
+
+bool SweepAndPrune::ChooseSortAxis()
+{
+	// Variance of the AABB centres on each axis, the axis they are most spread out on gives the fewest overlaps to sweep
+	glm::dvec3 sum(0.0);
+	glm::dvec3 sumSquared(0.0);
+	int count = 0;
+	for (const SweepAndPruneProxy& proxy : proxies)
+	{
+		if (proxy.free)
+			continue;
+
+		glm::dvec3 center(
+			(proxy.aabb.minimumX + proxy.aabb.maximumX) * 0.5,
+			(proxy.aabb.minimumY + proxy.aabb.maximumY) * 0.5,
+			(proxy.aabb.minimumZ + proxy.aabb.maximumZ) * 0.5);
+		sum += center;
+		sumSquared += center * center;
+		count++;
+	}
+
+	if (count < 2)
+		return false;
+
+	glm::dvec3 variance = sumSquared / static_cast<double>(count) - (sum * sum) / (static_cast<double>(count) * count);
+
+	int bestAxis = 0;
+	if (variance[1] > variance[bestAxis])
+		bestAxis = 1;
+	if (variance[2] > variance[bestAxis])
+		bestAxis = 2;
+
+	// Only switch when clearly better, a full re-sort is not worth a small gain
+	if (bestAxis == sortAxis || variance[bestAxis] < variance[sortAxis] * 1.5)
+		return false;
+
+	sortAxis = bestAxis;
+	return true;
+}
+
+float SweepAndPrune::GetAxisMinimum(const AABB& _aabb) const
+{
+	return sortAxis == 0 ? _aabb.minimumX : (sortAxis == 1 ? _aabb.minimumY : _aabb.minimumZ);
+}
+
+float SweepAndPrune::GetAxisMaximum(const AABB& _aabb) const
+{
+	return sortAxis == 0 ? _aabb.maximumX : (sortAxis == 1 ? _aabb.maximumY : _aabb.maximumZ);
+}
+
+void SweepAndPrune::AddPair(int _first, int _second, std::vector<BroadphasePair>& _pairs) const
+{
+	bool firstMovable = proxies[_first].collisionType == CollisionTypes::MovableCollision;
+	bool secondMovable = proxies[_second].collisionType == CollisionTypes::MovableCollision;
+	if (!firstMovable && !secondMovable)
+		return;
+
+	if (firstMovable)
+		_pairs.push_back({ _first, _second });
+	else
+		_pairs.push_back({ _second, _first });
+}
@@ -3,21 +3,23 @@
 // Engine includes
 #include "Engine/Source/Public/Rendering/Renderer.h"
 #include "Engine/Source/Public/Rendering/LevelRenderer.h"
+#include "Engine/Source/Public/Rendering/RenderThread.h"
 
 #include "Engine/Source/Public/Object/ObjectManager.h"
 #include "Engine/Source/Public/Object/GameObject.h"
 #include "Engine/Source/Public/Rendering/Mesh.h"
+#include "Engine/Source/Public/Threading/JobSystem.h"
 
 //#include "Game/Source/Public/Game.h"
 
 
-EngineLevelManager::EngineLevelManager(Renderer* _renderer)
-	: seRenderer(_renderer)
+EngineLevelManager::EngineLevelManager(Renderer* _renderer, RenderThread* _renderThread, JobSystem* _jobSystem)
+	: seRenderer(_renderer), seRenderThread(_renderThread), seJobSystem(_jobSystem)
 {
 	physicalDevice = seRenderer->GetPhysicalDevice();
 	logicalDevice = seRenderer->GetLogicalDevice();
 	transferQueue = seRenderer->GetGraphicsQueue();
-	transferCommandPool = seRenderer->GetGraphicsCommandPool();
+	transferCommandPool = seRenderer->GetUploadCommandPool();
 
 	seObjectManager = new ObjectManager();
 }
@@ -92,7 +94,7 @@ void EngineLevelManager::LoadLevel(std::string inLevelFilePath)
 					else if (line[0] == '~')
 					{
 						line = line.substr(1); // Remove '~'
-						currentObject.objectPath = std::string(PROJECT_SOURCE_DIR) + line;
+						currentObject.objectPath = seObjectManager->GetLevelArena()->CreateString(std::string(PROJECT_SOURCE_DIR) + line);
 					}
 				}
 			}
@@ -110,7 +112,7 @@ void EngineLevelManager::LoadLevel(std::string inLevelFilePath)
 					else if (line[0] == '~')
 					{
 						line = line.substr(1); // Remove '~'
-						currentObject.texturePath = std::string(PROJECT_SOURCE_DIR) + line;
+						currentObject.texturePath = seObjectManager->GetLevelArena()->CreateString(std::string(PROJECT_SOURCE_DIR) + line);
 					}
 				}
 			}
@@ -166,25 +168,6 @@ void EngineLevelManager::LoadLevel(std::string inLevelFilePath)
 	file.close();
 }
 
-void EngineLevelManager::ProcessLevelModelTasks()
-{
-	std::queue<VulkanTask> tasksToProcess;
-
-	// Move tasks from the shared queue to a local queue
-	{
-		std::lock_guard<std::mutex> lock(taskQueueMutex);
-		tasksToProcess.swap(vulkanTaskQueue);
-	}
-
-	// Process tasks
-	while (!tasksToProcess.empty())
-	{
-		VulkanTask& task = tasksToProcess.front();
-		task.function(); // Execute the Vulkan commands
-		tasksToProcess.pop();
-	}
-}
-
 void EngineLevelManager::SaveLevel(std::string inFileName)
 {
 	std::ofstream outFile(inFileName);
@@ -206,10 +189,10 @@ void EngineLevelManager::SaveLevel(std::string inFileName)
 		outFile << "~" << data.parentID << std::endl;
 		// For file paths we convert it to a relative file path before saving.
 		outFile << "@objectPath" << std::endl;
-		std::string objectPath = MakeRelativePath(data.objectPath);
+		std::string objectPath = MakeRelativePath(std::string(data.objectPath));
 		outFile << "~" << objectPath << std::endl;
 		outFile << "@texturePath" << std::endl;
-		std::string texturePath = MakeRelativePath(data.texturePath);
+		std::string texturePath = MakeRelativePath(std::string(data.texturePath));
 		outFile << "~" << texturePath << std::endl;
 		
 		// Write the model matrix
@@ -317,19 +300,20 @@ std::string EngineLevelManager::SaveFileExplorer()
 
 void EngineLevelManager::LoadNewScene()
 {
-	// Wait until queues and all operations are done before cleaning up
-	vkDeviceWaitIdle(logicalDevice);
+	// Models of the current level still loading would otherwise be added after it is destroyed
+	WaitForLoads();
 
-	// Destroy texture-related Vulkan objects for the current level
-	seRenderer->GetLevelRenderer()->DestroyAllRendererTextures();
-
-	// TODO: Eventually we should do this, issue is the DescriptorPool wont allow it unless we modify it some.
-	// it adds an excess of ~3mb of memory but technically doesnt leak it because when the descriptor pool is cleaned up
-	// so it that memory. But in general we should clean it up so if someone uses the program for extended periods it wont
-	// run out of memory because a vector keeps expanding its size.
-	//vkFreeDescriptorSets(Devices.LogicalDevice, samplerDescriptorPool, static_cast<uint32_t>(samplerDescriptorSets.size()), samplerDescriptorSets.data());
+	// Destroy texture-related Vulkan objects (and their descriptor sets) for the current level.
+	// They go through the deletion queue, so frames still in flight finish with them and nothing waits on the device.
+	// The snapshot waiting to be drawn still uses them, it is dropped and the next one is made without them.
+	{
+		std::unique_lock<std::mutex> frameLock = seRenderThread->LockFrame();
+		std::unique_lock<std::mutex> deviceLock = seRenderThread->LockDevice();
+		seRenderThread->DiscardPendingSnapshot();
+		seRenderer->GetLevelRenderer()->DestroyAllRendererTextures();
+	}
 
-	// Destroy current objects
+	// Destroy current objects, this holds the render thread off by itself
 	seObjectManager->DestroyAllGameObjects();
 
 	std::string filePath = OpenFileExplorer();
@@ -340,27 +324,41 @@ void EngineLevelManager::LoadNewScene()
 	LoadLevel(filePath);
 }
 
+void EngineLevelManager::WaitForLoads()
+{
+	seJobSystem->Wait(&loadCounter);
+}
+
 void EngineLevelManager::LoadMeshModel(ObjectData _objectData)
 {
-	// Put this into a vector of threads, we will launch them after the whole file is done loading
-	std::thread loadingThread([this, _objectData]()
+	// ObjectData is too big to capture in a job, it is shared between the import and the main thread job instead
+	std::shared_ptr<const ObjectData> objectData = std::make_shared<const ObjectData>(std::move(_objectData));
+
+	seJobSystem->Run([this, objectData]()
 	{
 		// Import model scene
-		std::shared_ptr<Assimp::Importer> importer = std::make_shared<Assimp::Importer>();
+		Assimp::Importer importer;
 
 		// After model included, make sure all faces are triangulated
 		// Also make sure UVs match our UV system, and finally try to remove any duplicate verticies
-		const aiScene* scene = importer->ReadFile(_objectData.objectPath, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_JoinIdenticalVertices);
+		// Arena strings end in a null, so the view's data can be passed as a C string
+		const aiScene* scene = importer.ReadFile(objectData->objectPath.data(), aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_JoinIdenticalVertices);
 
 		if (!scene)
-			throw std::runtime_error("failed to load the model passed in: " + _objectData.objectPath);
+			throw std::runtime_error("failed to load the model passed in: " + std::string(objectData->objectPath));
 
-		// Create a task to perform Vulkan operations
-		VulkanTask task;
-		task.function = [this, _objectData, scene, importer]()
-		{
+		// Everything that only reads the scene (vertices, bounds, triangle BVHs) is done here, the importer and its scene
+		// are freed with this job
+		std::vector<std::string> textureNames = MeshModel::LoadMaterials(scene);
+		std::vector<MeshData> meshData;
+		MeshModel::LoadNode(scene->mRootNode, scene, meshData);
 
-			std::vector<std::string> textureNames = MeshModel::LoadMaterials(scene);
+		// Vulkan operations happen on the main thread
+		seJobSystem->RunOnMainThread([this, objectData, textureNames = std::move(textureNames), meshData = std::move(meshData)]() mutable
+		{
+			// Uploads use the graphics queue and descriptor pools, the render thread only holds them off while it submits.
+			// New textures and meshes reach it through the next snapshot, so the frame lock is not needed.
+			std::unique_lock<std::mutex> deviceLock = seRenderThread->LockDevice();
 
 			// convert the material list IDs to descriptor array IDs
 			std::vector<int> materialToTexture(textureNames.size());
@@ -371,28 +369,19 @@ void EngineLevelManager::LoadMeshModel(ObjectData _objectData)
 					materialToTexture[i] = 0;
 				else
 				{
-					std::string fileLoc = (_objectData.texturePath + textureNames[i]);
+					std::string fileLoc = std::string(objectData->texturePath) + textureNames[i];
 					materialToTexture[i] = seRenderer->GetLevelRenderer()->CreateTexture(fileLoc);
 
 				}
 			}
 
-			// Load in all the meshes
-			std::vector<Mesh> modelMeshes = MeshModel::LoadNode(physicalDevice, logicalDevice, transferQueue, transferCommandPool, scene->mRootNode, scene, materialToTexture);
-
-			MeshModel* meshModel = new MeshModel(modelMeshes);
-
-			seObjectManager->CreateGameObject(_objectData, nullptr, meshModel);
-		};
-
-		// Add the task to the queue
-		{
-			std::lock_guard<std::mutex> lock(taskQueueMutex);
-			vulkanTaskQueue.push(task);
-		}
+			// Upload all the meshes
+			std::vector<Mesh> modelMeshes = MeshModel::CreateMeshes(physicalDevice, logicalDevice, transferQueue, transferCommandPool, meshData, materialToTexture);
 
-	});
+			// Main thread jobs never run at the same time, so the level arena needs no lock
+			MeshModel* meshModel = seObjectManager->GetLevelArena()->Create<MeshModel>(std::move(modelMeshes));
 
-	// Detatch the thread so it does not block the main thread
-	loadingThread.detach();
+			seObjectManager->CreateGameObject(*objectData, nullptr, meshModel);
+		}, &loadCounter);
+	}, &loadCounter);
 }
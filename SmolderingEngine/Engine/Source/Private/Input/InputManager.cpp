@@ -133,9 +133,10 @@ void InputManager::processInput(float inDeltaTime, class Camera* inCamera)
     lastMouseX = currentMouseX;
     lastMouseY = currentMouseY;
 
-    // Apply sensitivity to the mouse movement and make it frame-rate independent using deltaTime
-    offsetX *= mouseMovementSpeed * inDeltaTime;
-    offsetY *= mouseMovementSpeed * inDeltaTime;
+    // Apply sensitivity to the mouse movement. The offset is how far the mouse moved since the last tick, a distance
+    // rather than a rate, so it is not scaled by deltaTime.
+    offsetX *= mouseMovementSpeed;
+    offsetY *= mouseMovementSpeed;
 
     // Update yaw and pitch based on mouse movement
     yaw += offsetX;
@@ -178,14 +179,8 @@ void InputManager::processInput(float inDeltaTime, class Camera* inCamera)
     // Camera position based on updated model position
     glm::vec3 cameraPosition = glm::vec3(modelX, modelY, modelZ);
 
-    // Camera target based on the front direction
-    glm::vec3 targetPosition = cameraPosition + front;
-
-    // Define up direction (Y-axis)
-    glm::vec3 upDirection = glm::vec3(0.0f, 1.0f, 0.0f);
-
-    // Update the view matrix
-    inCamera->uboViewProjection.view = glm::lookAt(cameraPosition, targetPosition, upDirection);
+    // The view matrix is built each frame from this and the previous tick, see Camera::InterpolateView
+    inCamera->SetSimulationState(cameraPosition, front);
 
 
     // --- ENGINE KEYBINDS --- TODO: Separate these functions eventually
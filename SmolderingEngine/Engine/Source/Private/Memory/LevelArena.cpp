@@ -0,0 +1,97 @@
+#include "Engine/Source/Public/Memory/LevelArena.h"
+
+// Standard Library
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <cstring>
+
+LevelArena::LevelArena(size_t _blockSize)
+	: blockSize(_blockSize)
+{
+	if (_blockSize == 0)
+		throw std::runtime_error("Level arena block size must be greater than 0!");
+}
+
+LevelArena::~LevelArena()
+{
+	Release();
+}
+
+void* LevelArena::Allocate(size_t _size, size_t _alignment)
+{
+	// Try the current block, then any kept from an earlier level, before asking the heap for another
+	while (currentBlock != nullptr)
+	{
+		uintptr_t start = reinterpret_cast<uintptr_t>(currentBlock->GetData()) + currentBlock->used;
+		size_t padding = (_alignment - (start % _alignment)) % _alignment;
+		if (currentBlock->used + padding + _size <= currentBlock->size)
+		{
+			currentBlock->used += padding + _size;
+			statistics.allocations++;
+			return reinterpret_cast<void*>(start + padding);
+		}
+
+		if (currentBlock->next == nullptr)
+			break;
+		currentBlock = currentBlock->next;
+	}
+
+	// Oversized allocations get a block of their own, with room for the alignment padding
+	size_t size = std::max(blockSize, _size + _alignment);
+	ArenaBlock* block = new (::operator new(sizeof(ArenaBlock) + size)) ArenaBlock();
+	block->size = size;
+
+	if (currentBlock != nullptr)
+		currentBlock->next = block;
+	else
+		firstBlock = block;
+	currentBlock = block;
+
+	statistics.heapAllocations++;
+	statistics.bytesReserved += size;
+
+	return Allocate(_size, _alignment);
+}
+
+std::string_view LevelArena::CreateString(std::string_view _string)
+{
+	char* characters = static_cast<char*>(Allocate(_string.size() + 1, alignof(char)));
+	std::memcpy(characters, _string.data(), _string.size());
+	characters[_string.size()] = '\0';
+
+	statistics.liveObjects++;
+	return std::string_view(characters, _string.size());
+}
+
+void LevelArena::Reset()
+{
+	while (destructors != nullptr)
+	{
+		destructors->destroy(destructors->object);
+		destructors = destructors->next;
+	}
+
+	for (ArenaBlock* block = firstBlock; block != nullptr; block = block->next)
+		block->used = 0;
+	currentBlock = firstBlock;
+
+	statistics.frees += statistics.liveObjects;
+	statistics.liveObjects = 0;
+}
+
+void LevelArena::Release()
+{
+	Reset();
+
+	while (firstBlock != nullptr)
+	{
+		ArenaBlock* next = firstBlock->next;
+		::operator delete(firstBlock);
+		firstBlock = next;
+
+		statistics.heapFrees++;
+	}
+	currentBlock = nullptr;
+	statistics.bytesReserved = 0;
+}
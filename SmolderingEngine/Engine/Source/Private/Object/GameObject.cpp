@@ -1,67 +1,67 @@
 #include "Engine/Source/Public/Object/GameObject.h"
 
 // Project Includes
-#include "Engine/Source/Public/Rendering/Mesh.h"
-#include "Engine/Source/Public/Rendering/MeshModel.h"
+#include "Engine/Source/Public/Object/ObjectTransforms.h"
 
-GameObject::GameObject()
-{
-	objectModel.modelMatrix = glm::mat4(1.0f);
-}
-
-GameObject::GameObject(ObjectData _data, Mesh* _mesh, MeshModel* _meshModel)
-	: objectMesh(_mesh), objectMeshModel(_meshModel)
+GameObject::GameObject(ObjectData _data, Mesh* _mesh, MeshModel* _meshModel, ObjectTransforms* _transforms, int _transformHandle, GameObjectHandle _handle)
+	: objectMesh(_mesh), objectMeshModel(_meshModel), objectTransforms(_transforms), transformHandle(_transformHandle), handle(_handle)
 {
 	objectData = _data;
 }
 
 void GameObject::ApplyLocalTransform(glm::vec3 inTransform)
 {
-	objectModel.modelMatrix[3].x = inTransform.x;
-	objectModel.modelMatrix[3].y = inTransform.y;
-	objectModel.modelMatrix[3].z = inTransform.z;
+	glm::mat4 localMatrix = objectTransforms->GetLocalMatrix(transformHandle);
+	localMatrix[3].x = inTransform.x;
+	localMatrix[3].y = inTransform.y;
+	localMatrix[3].z = inTransform.z;
+	objectTransforms->SetLocalMatrix(transformHandle, localMatrix);
 }
 
 void GameObject::ApplyLocalYRotation(float inAngle)
 {
 	glm::mat4 rotationMatrix = glm::rotate(glm::mat4(1.0f), glm::radians(inAngle), glm::vec3(0.0f, 1.0f, 0.0f));
 
-	// Apply the rotation to the parent object
+	// Children are placed relative to this object, so they come with it when the hierarchy updates
 	SetModel(rotationMatrix * GetModel().modelMatrix);
+}
 
-	std::vector<Object*> objectsToRotate = childObjects;
-
-	while (!objectsToRotate.empty())
-	{
-		Object* currObject = objectsToRotate.back();
-		objectsToRotate.pop_back();
+void GameObject::SetModel(glm::mat4 inModel)
+{
+	objectTransforms->SetWorldMatrix(transformHandle, inModel);
+}
 
-		currObject->SetModel(rotationMatrix * currObject->GetModel().modelMatrix);
+Model GameObject::GetModel()
+{
+	return objectTransforms->GetModel(transformHandle);
+}
 
-		for (Object* grandchild : currObject->GetChildObjects())
-		{
-			objectsToRotate.push_back(grandchild);
-		}
-	}
+Model GameObject::GetRenderModel() const
+{
+	return objectTransforms->GetRenderModel(transformHandle);
 }
 
-void GameObject::SetModel(glm::mat4 inModel)
+void GameObject::SetLocalMatrix(const glm::mat4& _localMatrix)
 {
-	objectModel.modelMatrix = inModel;
-	GetObjectData().objectMatrix = inModel;
+	objectTransforms->SetLocalMatrix(transformHandle, _localMatrix);
 }
 
-Model GameObject::GetModel()
+const glm::mat4& GameObject::GetLocalMatrix()
 {
-	return objectModel;
+	return objectTransforms->GetLocalMatrix(transformHandle);
 }
 
 int GameObject::GetUseTexture()
 {
-	return objectModel.useTexture;
+	return objectTransforms->GetModel(transformHandle).useTexture;
 }
 
 void GameObject::SetUseTexture(int inUseTexture)
 {
-	objectModel.useTexture = inUseTexture;
+	objectTransforms->SetUseTexture(transformHandle, inUseTexture);
+}
+
+const AABB& GameObject::GetWorldAABB()
+{
+	return objectTransforms->GetWorldAABB(transformHandle);
 }
\ No newline at end of file
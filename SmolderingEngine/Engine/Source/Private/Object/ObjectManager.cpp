@@ -6,45 +6,251 @@
 #include "Engine/Source/Public/Object/Object.h"
 #include "Engine/Source/Public/Object/GameObject.h"
 #include "Engine/Source/Public/Rendering/MeshModel.h"
+#include "Engine/Source/Public/Rendering/Mesh.h"
 
 #include "Engine/Source/Public/Rendering/Renderer.h"
+#include "Engine/Source/Public/Rendering/RenderThread.h"
+#include "Engine/Source/Public/SceneQuery/SceneQuery.h"
 
 GameObject* ObjectManager::CreateGameObject(ObjectData _objectData, Mesh* _mesh, MeshModel* _meshModel)
 {
-    int id;
-    if (!reusableIDs.empty()) 
+    GameObjectHandle handle = AllocateSlot();
+
+    // Objects without a mesh are treated as a point at their position
+    AABB localAABB = {};
+    if (_meshModel != nullptr)
+        localAABB = _meshModel->GetLocalAABB();
+    else if (_mesh != nullptr)
+        localAABB = _mesh->GetLocalAABB();
+
+    int transformIndex = objectTransforms.Add(_objectData.objectMatrix, localAABB);
+    GameObject* newObj = gameObjectPool.Create(_objectData, _mesh, _meshModel, &objectTransforms, transformIndex, handle);
+    newObj->SetUseTexture(1);
+
+    GameObjectSlot& slot = slots[handle.index];
+    slot.gameObject = newObj;
+    slot.denseIndexOrNextFree = static_cast<uint32_t>(gameObjects.size());
+    gameObjects.push_back(newObj);
+    denseSlots.push_back(handle.index);
+
+    LinkLevelParents(newObj);
+
+    if (seEngineManager == nullptr)
+        seEngineManager = EngineManager::GetEngineManager();
+    seEngineManager->GetSceneQuery()->MarkDirty();
+
+    return newObj;
+}
+
+void ObjectManager::DestroyGameObject(GameObjectHandle _handle)
+{
+    GameObject* gameObject = GetGameObject(_handle);
+    if (gameObject == nullptr)
+    {
+        std::cout << "Warning: tried to destroy a game object that no longer exists" << std::endl;
+        return;
+    }
+
+    // Children stay in the level where they are, the transform must have no children left before it is removed
+    std::vector<Object*> children = gameObject->GetChildObjects();
+    for (Object* child : children)
+        SetParent(static_cast<GameObject*>(child), nullptr);
+    SetParent(gameObject, nullptr);
+
+    objectTransforms.Remove(gameObject->GetTransformHandle());
+    FreeSlot(_handle);
+
+    if (seEngineManager == nullptr)
+        seEngineManager = EngineManager::GetEngineManager();
+    seEngineManager->GetSceneQuery()->MarkDirty();
+
+    // Released between the render thread's frames, and the snapshot still waiting to be drawn with this mesh is dropped
+    RenderThread* seRenderThread = seEngineManager->GetRenderThread();
+    std::unique_lock<std::mutex> frameLock = seRenderThread->LockFrame();
+    std::unique_lock<std::mutex> deviceLock = seRenderThread->LockDevice();
+    seRenderThread->DiscardPendingSnapshot();
+    DeleteGameObject(gameObject);
+}
+
+GameObject* ObjectManager::GetGameObject(GameObjectHandle _handle) const
+{
+    if (_handle.index >= slots.size())
+        return nullptr;
+
+    const GameObjectSlot& slot = slots[_handle.index];
+    return (slot.generation == _handle.generation) ? slot.gameObject : nullptr;
+}
+
+GameObjectHandle ObjectManager::AllocateSlot()
+{
+    uint32_t index;
+    if (freeSlotList != UINT32_MAX)
     {
-        // Get the smallest ID from the reusable ID set
-        id = *reusableIDs.begin();
-        reusableIDs.erase(reusableIDs.begin());
+        index = freeSlotList;
+        freeSlotList = slots[index].denseIndexOrNextFree;
     }
-    else 
+    else
     {
-        // Assign the next sequential ID
-        id = nextID++;
+        index = static_cast<uint32_t>(slots.size());
+        slots.emplace_back();
     }
 
-    GameObject* newObj = new GameObject(_objectData, _mesh, _meshModel);
-    newObj->SetUseTexture(1);
-    newObj->SetModel(_objectData.objectMatrix);
-    gameObjects.push_back(newObj);
-    return newObj;
+    GameObjectHandle handle;
+    handle.index = index;
+    handle.generation = slots[index].generation;
+    return handle;
 }
 
-void ObjectManager::DestroyAllGameObjects()
+void ObjectManager::FreeSlot(GameObjectHandle _handle)
+{
+    GameObjectSlot& slot = slots[_handle.index];
+
+    // Swap the last live object into the hole so the dense list stays packed
+    uint32_t denseIndex = slot.denseIndexOrNextFree;
+    uint32_t lastIndex = static_cast<uint32_t>(gameObjects.size()) - 1;
+    if (denseIndex != lastIndex)
+    {
+        gameObjects[denseIndex] = gameObjects[lastIndex];
+        denseSlots[denseIndex] = denseSlots[lastIndex];
+        slots[denseSlots[denseIndex]].denseIndexOrNextFree = denseIndex;
+    }
+    gameObjects.pop_back();
+    denseSlots.pop_back();
+
+    // A new generation makes every handle to the old object stale
+    slot.gameObject = nullptr;
+    slot.generation++;
+    slot.denseIndexOrNextFree = freeSlotList;
+    freeSlotList = _handle.index;
+}
+
+void ObjectManager::DeleteGameObject(GameObject* _gameObject)
 {
     if (seEngineManager == nullptr)
         seEngineManager = EngineManager::GetEngineManager();
 
-    // Wait until queues and all operations are done before cleaning up
-    vkDeviceWaitIdle(seEngineManager->GetRenderer()->GetLogicalDevice());
+    // The last frames recorded with the mesh may still be on the GPU, the deletion queue waits for them
+    if (_gameObject->objectMeshModel != nullptr)
+        _gameObject->objectMeshModel->DestroyMeshModel(seEngineManager->GetRenderer()->GetDeletionQueue());
+    gameObjectPool.Destroy(_gameObject);
+}
+
+bool ObjectManager::SetParent(GameObject* _child, GameObject* _parent)
+{
+    for (GameObject* ancestor = _parent; ancestor != nullptr; ancestor = ancestor->GetParentObject())
+    {
+        if (ancestor == _child)
+        {
+            std::cout << "Warning: can not parent an object to itself or one of its children" << std::endl;
+            return false;
+        }
+    }
+
+    if (_child->GetParentObject() != nullptr)
+        _child->GetParentObject()->RemoveChildObject(_child);
+    if (_parent != nullptr)
+        _parent->AddChildObject(_child);
+    _child->SetParentObject(_parent);
+
+    // Saved levels store the parent by objectID
+    ObjectData data = _child->GetObjectData();
+    data.parentID = (_parent != nullptr) ? _parent->GetObjectID() : -1;
+    _child->SetObjectData(data);
+
+    objectTransforms.SetParent(_child->GetTransformHandle(), (_parent != nullptr) ? _parent->GetTransformHandle() : -1);
+
+    if (seEngineManager == nullptr)
+        seEngineManager = EngineManager::GetEngineManager();
+    seEngineManager->GetSceneQuery()->MarkDirty();
+    return true;
+}
+
+void ObjectManager::UpdateObjects(float _deltaTime)
+{
+    if (seEngineManager == nullptr)
+        seEngineManager = EngineManager::GetEngineManager();
+
+    // The world matrices from the last tick are what rendering interpolates from until this one is shown
+    objectTransforms.BeginTick(seEngineManager->GetJobSystem());
+    updateScheduler.Update(_deltaTime, &objectTransforms, seEngineManager->GetJobSystem());
+
+    // Callbacks, parent propagation and anything that set a transform since the last tick moved objects, so the
+    // scene BVH is rebuilt before the next query
+    if (objectTransforms.TakeWorldChanged())
+        seEngineManager->GetSceneQuery()->MarkDirty();
+}
+
+void ObjectManager::LinkLevelParents(GameObject* _gameObject)
+{
+    int objectID = _gameObject->GetObjectID();
+    int parentID = _gameObject->GetParentObjectID();
+
+    if (objectID >= 0)
+    {
+        if (objectID >= static_cast<int>(levelObjectLinks.size()))
+            levelObjectLinks.resize(objectID + 1);
+
+        LevelObjectLink& link = levelObjectLinks[objectID];
+        if (GetGameObject(link.handle) != nullptr)
+            std::cout << "Warning: two level objects share objectID " << objectID << ", children are linked to the newest" << std::endl;
+        link.handle = _gameObject->GetHandle();
+
+        // Children destroyed while waiting have stale handles and are skipped
+        for (uint32_t i = link.firstWaitingChild; i != UINT32_MAX; i = waitingChildren[i].next)
+        {
+            if (GameObject* child = GetGameObject(waitingChildren[i].child))
+                SetParent(child, _gameObject);
+        }
+        link.firstWaitingChild = UINT32_MAX;
+    }
+
+    if (parentID >= 0)
+    {
+        GameObject* parent = (parentID < static_cast<int>(levelObjectLinks.size())) ? GetGameObject(levelObjectLinks[parentID].handle) : nullptr;
+        if (parent != nullptr)
+        {
+            SetParent(_gameObject, parent);
+            return;
+        }
+
+        // The parent has not loaded yet, it links this child when it does
+        if (parentID >= static_cast<int>(levelObjectLinks.size()))
+            levelObjectLinks.resize(parentID + 1);
+
+        LevelObjectLink& parentLink = levelObjectLinks[parentID];
+        waitingChildren.push_back({ _gameObject->GetHandle(), parentLink.firstWaitingChild });
+        parentLink.firstWaitingChild = static_cast<uint32_t>(waitingChildren.size()) - 1;
+    }
+}
+
+void ObjectManager::DestroyAllGameObjects()
+{
+    if (seEngineManager == nullptr)
+        seEngineManager = EngineManager::GetEngineManager();
 
-    for (int i = 0; i < gameObjects.size(); i++)
     {
-        MeshModel* tempModel = gameObjects[i]->objectMeshModel;
-        tempModel->DestroyMeshModel();
-        delete gameObjects[i];
+        // Released between the render thread's frames, and the snapshot still waiting to be drawn with the level is dropped
+        RenderThread* seRenderThread = seEngineManager->GetRenderThread();
+        std::unique_lock<std::mutex> frameLock = seRenderThread->LockFrame();
+        std::unique_lock<std::mutex> deviceLock = seRenderThread->LockDevice();
+        seRenderThread->DiscardPendingSnapshot();
+
+        // Every slot is freed with a new generation, so handles from the old level resolve to nullptr
+        while (!gameObjects.empty())
+        {
+            GameObject* gameObject = gameObjects.back();
+            FreeSlot(gameObject->GetHandle());
+            DeleteGameObject(gameObject);
+        }
+
+        objectTransforms.Clear();
+        levelObjectLinks.clear();
+        waitingChildren.clear();
+
+        // Every MeshModel of the level is destructed here, the arena keeps its blocks for the next level
+        levelArena.Reset();
     }
 
-    gameObjects.clear();
+    // Meshes are gone, the scene BVH must not point at them anymore
+    seEngineManager->GetSceneQuery()->Build(gameObjects);
 }
@@ -0,0 +1,331 @@
+#include "Engine/Source/Public/Object/ObjectTransforms.h"
+
+// Standard Library
+#include <iostream>
+
+// Project Includes
+#include "Engine/Source/Public/Threading/JobSystem.h"
+
+int ObjectTransforms::Add(const glm::mat4& _modelMatrix, const AABB& _localAABB)
+{
+	Model model;
+	model.modelMatrix = _modelMatrix;
+
+	models.push_back(model);
+	localMatrices.push_back(_modelMatrix);
+	parentIndices.push_back(-1);
+	localAABBs.push_back(_localAABB);
+	worldAABBs.push_back(AABB());
+	flags.push_back(TRANSFORM_FLAG_WORLD_AABB_DIRTY);
+	previousWorldMatrices.push_back(_modelMatrix);
+
+	// A new root can go at the end without breaking the parents first order
+	int index = static_cast<int>(models.size()) - 1;
+	int handle;
+	if (!freeHandles.empty())
+	{
+		handle = freeHandles.back();
+		freeHandles.pop_back();
+		handleToIndex[handle] = index;
+	}
+	else
+	{
+		handle = static_cast<int>(handleToIndex.size());
+		handleToIndex.push_back(index);
+	}
+	indexToHandle.push_back(handle);
+
+	// Only while every transform is a root does the new one keep the depth ranges intact
+	if (depthStarts.size() <= 2)
+		depthStarts = { 0, static_cast<int>(models.size()) };
+	else
+		hierarchyDirty = true;
+
+	return handle;
+}
+
+void ObjectTransforms::Remove(int _handle)
+{
+	int index = handleToIndex[_handle];
+	flags[index] = TRANSFORM_FLAG_REMOVED;
+	parentIndices[index] = -1;
+
+	handleToIndex[_handle] = -1;
+	freeHandles.push_back(_handle);
+
+	hierarchyDirty = true;
+}
+
+void ObjectTransforms::Clear()
+{
+	models.clear();
+	localMatrices.clear();
+	parentIndices.clear();
+	localAABBs.clear();
+	worldAABBs.clear();
+	flags.clear();
+	previousWorldMatrices.clear();
+	handleToIndex.clear();
+	indexToHandle.clear();
+	freeHandles.clear();
+	depthStarts.clear();
+
+	hierarchyDirty = false;
+	transformsDirty = false;
+	worldChanged = false;
+}
+
+void ObjectTransforms::SetParent(int _handle, int _parentHandle)
+{
+	int index = handleToIndex[_handle];
+	int parentIndex = (_parentHandle == -1) ? -1 : handleToIndex[_parentHandle];
+
+	// Keep the object where it is in the world, so its local matrix is now relative to the new parent
+	parentIndices[index] = parentIndex;
+	SetWorldMatrix(_handle, models[index].modelMatrix);
+
+	hierarchyDirty = true;
+}
+
+void ObjectTransforms::SetLocalMatrix(int _handle, const glm::mat4& _localMatrix)
+{
+	int index = handleToIndex[_handle];
+	localMatrices[index] = _localMatrix;
+	flags[index] |= TRANSFORM_FLAG_LOCAL_DIRTY;
+
+	// Update this world matrix straight away so it can be read back before the next update, children wait for it
+	models[index].modelMatrix = GetParentWorldMatrix(index) * _localMatrix;
+	flags[index] |= TRANSFORM_FLAG_WORLD_AABB_DIRTY;
+
+	transformsDirty = true;
+	worldChanged = true;
+}
+
+void ObjectTransforms::SetWorldMatrix(int _handle, const glm::mat4& _worldMatrix)
+{
+	int index = handleToIndex[_handle];
+	SetLocalMatrix(_handle, glm::inverse(GetParentWorldMatrix(index)) * _worldMatrix);
+}
+
+void ObjectTransforms::SetLocalAABB(int _handle, const AABB& _localAABB)
+{
+	int index = handleToIndex[_handle];
+	localAABBs[index] = _localAABB;
+	flags[index] |= TRANSFORM_FLAG_WORLD_AABB_DIRTY;
+	worldChanged = true;
+}
+
+void ObjectTransforms::UpdateWorldMatrices(JobSystem* _jobSystem)
+{
+	if (hierarchyDirty)
+		SortHierarchy();
+
+	if (!transformsDirty)
+		return;
+
+	if (_jobSystem == nullptr)
+		UpdateWorldMatrixRange(0, models.size());
+	else
+	{
+		// A depth only reads the depth before it, which the previous ParallelFor has already finished
+		for (size_t depth = 0; depth + 1 < depthStarts.size(); depth++)
+		{
+			size_t first = depthStarts[depth];
+			_jobSystem->ParallelFor(depthStarts[depth + 1] - first, updateChunkSize, [this, first](size_t _first, size_t _last)
+				{
+					UpdateWorldMatrixRange(first + _first, first + _last);
+				});
+		}
+	}
+
+	// Set here rather than in the ranges, which run on several threads at once
+	transformsDirty = false;
+	worldChanged = true;
+}
+
+void ObjectTransforms::UpdateWorldMatrixRange(size_t _first, size_t _last)
+{
+	// Parents are always before their children, so a parent's world matrix and changed flag are final by the time
+	// its children read them. Every flag is rewritten when its transform is visited, so nothing is left over for next frame.
+	for (size_t i = _first; i < _last; i++)
+	{
+		int parentIndex = parentIndices[i];
+		bool changed = (flags[i] & TRANSFORM_FLAG_LOCAL_DIRTY) || (parentIndex != -1 && (flags[parentIndex] & TRANSFORM_FLAG_WORLD_CHANGED));
+
+		flags[i] &= ~(TRANSFORM_FLAG_LOCAL_DIRTY | TRANSFORM_FLAG_WORLD_CHANGED);
+		if (!changed)
+			continue;
+
+		models[i].modelMatrix = (parentIndex == -1) ? localMatrices[i] : models[parentIndex].modelMatrix * localMatrices[i];
+		flags[i] |= TRANSFORM_FLAG_WORLD_CHANGED | TRANSFORM_FLAG_WORLD_AABB_DIRTY;
+	}
+}
+
+void ObjectTransforms::UpdateWorldAABBs(JobSystem* _jobSystem)
+{
+	if (_jobSystem == nullptr)
+		UpdateWorldAABBRange(0, models.size());
+	else
+		_jobSystem->ParallelFor(models.size(), updateChunkSize, [this](size_t _first, size_t _last) { UpdateWorldAABBRange(_first, _last); });
+}
+
+void ObjectTransforms::UpdateWorldAABBRange(size_t _first, size_t _last)
+{
+	for (size_t i = _first; i < _last; i++)
+	{
+		if (flags[i] & TRANSFORM_FLAG_WORLD_AABB_DIRTY)
+		{
+			worldAABBs[i] = TransformAABB(localAABBs[i], models[i].modelMatrix);
+			flags[i] &= ~TRANSFORM_FLAG_WORLD_AABB_DIRTY;
+		}
+	}
+}
+
+const AABB& ObjectTransforms::GetWorldAABB(int _handle)
+{
+	int index = handleToIndex[_handle];
+	if (flags[index] & TRANSFORM_FLAG_WORLD_AABB_DIRTY)
+	{
+		worldAABBs[index] = TransformAABB(localAABBs[index], models[index].modelMatrix);
+		flags[index] &= ~TRANSFORM_FLAG_WORLD_AABB_DIRTY;
+	}
+
+	return worldAABBs[index];
+}
+
+void ObjectTransforms::BeginTick(JobSystem* _jobSystem)
+{
+	// Sorted first so the saved matrices line up with the indices the tick will use
+	UpdateHierarchy();
+
+	auto saveRange = [this](size_t _first, size_t _last)
+		{
+			for (size_t i = _first; i < _last; i++)
+				previousWorldMatrices[i] = models[i].modelMatrix;
+		};
+
+	if (_jobSystem == nullptr)
+		saveRange(0, models.size());
+	else
+		_jobSystem->ParallelFor(models.size(), updateChunkSize, saveRange);
+}
+
+Model ObjectTransforms::GetRenderModel(int _handle) const
+{
+	int index = handleToIndex[_handle];
+
+	Model model = models[index];
+	if (interpolationAlpha < 1.0f)
+		model.modelMatrix = previousWorldMatrices[index] + (model.modelMatrix - previousWorldMatrices[index]) * interpolationAlpha;
+
+	return model;
+}
+
+int ObjectTransforms::GetParent(int _handle) const
+{
+	int parentIndex = parentIndices[handleToIndex[_handle]];
+	return (parentIndex == -1) ? -1 : indexToHandle[parentIndex];
+}
+
+void ObjectTransforms::SortHierarchy()
+{
+	size_t count = models.size();
+
+	// Depth of every transform, walking up until a transform with a known depth is found. -2 marks the current path.
+	std::vector<int> depths(count, -1);
+	std::vector<int> path;
+	int maxDepth = 0;
+	for (size_t i = 0; i < count; i++)
+	{
+		if (flags[i] & TRANSFORM_FLAG_REMOVED)
+			continue;
+
+		int index = static_cast<int>(i);
+		path.clear();
+		while (index != -1 && depths[index] < 0)
+		{
+			// Walked back onto the path, so it is a cycle. Break it at the last object walked.
+			if (depths[index] == -2)
+			{
+				std::cout << "Warning: transform hierarchy has a cycle, detaching an object from its parent" << std::endl;
+				parentIndices[path.back()] = -1;
+				index = -1;
+				break;
+			}
+
+			depths[index] = -2;
+			path.push_back(index);
+			index = parentIndices[index];
+		}
+
+		int depth = (index == -1) ? -1 : depths[index];
+		for (auto pathIndex = path.rbegin(); pathIndex != path.rend(); pathIndex++)
+			depths[*pathIndex] = ++depth;
+
+		maxDepth = std::max(maxDepth, depths[i]);
+	}
+
+	// Counting sort by depth keeps siblings in their current order, removed transforms are left out
+	std::vector<int> depthOffsets(maxDepth + 2, 0);
+	size_t liveCount = 0;
+	for (int depth : depths)
+	{
+		if (depth < 0)
+			continue;
+
+		depthOffsets[depth + 1]++;
+		liveCount++;
+	}
+	for (int depth = 1; depth <= maxDepth + 1; depth++)
+		depthOffsets[depth] += depthOffsets[depth - 1];
+
+	// Kept for the parallel update, the counting sort below moves each offset on to the end of its depth
+	depthStarts = depthOffsets;
+
+	std::vector<int> order(liveCount);
+	std::vector<int> newIndices(count, -1);
+	for (size_t i = 0; i < count; i++)
+	{
+		if (depths[i] < 0)
+			continue;
+
+		int newIndex = depthOffsets[depths[i]]++;
+		order[newIndex] = static_cast<int>(i);
+		newIndices[i] = newIndex;
+	}
+
+	auto permute = [&](auto& _array)
+		{
+			auto sorted = _array;
+			sorted.resize(liveCount);
+			for (size_t i = 0; i < liveCount; i++)
+				sorted[i] = _array[order[i]];
+			_array.swap(sorted);
+		};
+
+	permute(models);
+	permute(localMatrices);
+	permute(parentIndices);
+	permute(localAABBs);
+	permute(worldAABBs);
+	permute(flags);
+	permute(previousWorldMatrices);
+	permute(indexToHandle);
+
+	for (size_t i = 0; i < liveCount; i++)
+	{
+		if (parentIndices[i] != -1)
+			parentIndices[i] = newIndices[parentIndices[i]];
+		handleToIndex[indexToHandle[i]] = static_cast<int>(i);
+	}
+
+	hierarchyDirty = false;
+}
+
+const glm::mat4& ObjectTransforms::GetParentWorldMatrix(int _index) const
+{
+	static const glm::mat4 identity(1.0f);
+
+	int parentIndex = parentIndices[_index];
+	return (parentIndex == -1) ? identity : models[parentIndex].modelMatrix;
+}
@@ -0,0 +1,111 @@
+#include "Engine/Source/Public/Object/ObjectUpdateScheduler.h"
+
+// Standard Library
+#include <algorithm>
+#include <stdexcept>
+
+// Project Includes
+#include "Engine/Source/Public/Object/ObjectTransforms.h"
+#include "Engine/Source/Public/Threading/JobSystem.h"
+
+int ObjectUpdateScheduler::AddUpdateCallback(const std::string& _name, uint32_t _reads, uint32_t _writes, ObjectUpdateFunction _function)
+{
+	if (_writes & (OBJECT_ACCESS_WORLD_MATRICES | OBJECT_ACCESS_WORLD_AABBS))
+		throw std::runtime_error("Update callback \"" + _name + "\" can not write world matrices or AABBs, write the local matrix instead!");
+
+	ObjectUpdateCallback callback;
+	callback.id = nextCallbackID++;
+	callback.name = _name;
+	callback.reads = _reads;
+	callback.writes = _writes;
+	callback.function = std::move(_function);
+	callbacks.push_back(std::move(callback));
+
+	stagesDirty = true;
+	return callbacks.back().id;
+}
+
+void ObjectUpdateScheduler::RemoveUpdateCallback(int _id)
+{
+	auto callback = std::find_if(callbacks.begin(), callbacks.end(), [_id](const ObjectUpdateCallback& _callback) { return _callback.id == _id; });
+	if (callback == callbacks.end())
+		return;
+
+	callbacks.erase(callback);
+	stagesDirty = true;
+}
+
+void ObjectUpdateScheduler::Update(float _deltaTime, ObjectTransforms* _transforms, JobSystem* _jobSystem)
+{
+	if (stagesDirty)
+		BuildStages();
+
+	// The hierarchy is sorted first so the indices the callbacks are given do not move under them
+	_transforms->UpdateHierarchy();
+
+	size_t count = _transforms->GetCount();
+	for (const std::vector<size_t>& stage : stages)
+	{
+		bool writesLocalMatrices = false;
+		for (size_t callbackIndex : stage)
+			writesLocalMatrices |= (callbacks[callbackIndex].writes & OBJECT_ACCESS_LOCAL_MATRICES) != 0;
+
+		auto runChunk = [&](size_t _first, size_t _last)
+			{
+				ObjectUpdateChunk chunk = { _transforms, _deltaTime, _first, _last };
+				for (size_t callbackIndex : stage)
+					callbacks[callbackIndex].function(chunk);
+			};
+
+		// Callbacks in a stage never touch the same data, so one job runs all of them over its chunk while it is in cache
+		if (_jobSystem == nullptr)
+			runChunk(0, count);
+		else
+			_jobSystem->ParallelFor(count, chunkSize, runChunk);
+
+		if (writesLocalMatrices)
+			_transforms->MarkLocalMatricesChanged();
+	}
+
+	// Propagation reads the local matrices and writes the world, after every callback has finished with them
+	_transforms->UpdateWorldMatrices(_jobSystem);
+	_transforms->UpdateWorldAABBs(_jobSystem);
+}
+
+size_t ObjectUpdateScheduler::GetStageCount()
+{
+	if (stagesDirty)
+		BuildStages();
+
+	return stages.size();
+}
+
+void ObjectUpdateScheduler::BuildStages()
+{
+	stages.clear();
+
+	// Each callback goes in the stage after the last one holding a callback it conflicts with, keeping the added order
+	// between any two callbacks that touch the same data
+	std::vector<size_t> callbackStages(callbacks.size(), 0);
+	for (size_t i = 0; i < callbacks.size(); i++)
+	{
+		size_t stage = 0;
+		for (size_t j = 0; j < i; j++)
+		{
+			if (Conflicts(callbacks[i], callbacks[j]))
+				stage = std::max(stage, callbackStages[j] + 1);
+		}
+
+		callbackStages[i] = stage;
+		if (stage >= stages.size())
+			stages.resize(stage + 1);
+		stages[stage].push_back(i);
+	}
+
+	stagesDirty = false;
+}
+
+bool ObjectUpdateScheduler::Conflicts(const ObjectUpdateCallback& _a, const ObjectUpdateCallback& _b)
+{
+	return (_a.writes & (_b.reads | _b.writes)) || (_b.writes & _a.reads);
+}
@@ -0,0 +1,108 @@
+#include "Engine/Source/Public/Rendering/DeletionQueue.h"
+
+// Project Includes
+#include "Engine/Source/Public/Rendering/Utilities.h"
+
+DeletionQueue::DeletionQueue(VkDevice _logicalDevice)
+	: logicalDevice(_logicalDevice)
+{
+}
+
+void DeletionQueue::BeginFrame(uint64_t _frameNumber)
+{
+	frameNumber = _frameNumber;
+
+	// The fence of the frame released in was waited on MAX_FRAME_DRAWS frames later, same as retired swapchains
+	while (!deletions.empty() && frameNumber >= deletions.front().retiredFrameNumber + MAX_FRAME_DRAWS)
+	{
+		Destroy(deletions.front());
+		deletions.pop_front();
+	}
+}
+
+void DeletionQueue::DestroyAll()
+{
+	for (const DeferredDeletion& deletion : deletions)
+		Destroy(deletion);
+	deletions.clear();
+}
+
+void DeletionQueue::ReleaseBuffer(VkBuffer _buffer)
+{
+	DeferredDeletion deletion;
+	deletion.type = DeferredDeletionType::Buffer;
+	deletion.buffer = _buffer;
+	Push(deletion);
+}
+
+void DeletionQueue::ReleaseImage(VkImage _image)
+{
+	DeferredDeletion deletion;
+	deletion.type = DeferredDeletionType::Image;
+	deletion.image = _image;
+	Push(deletion);
+}
+
+void DeletionQueue::ReleaseImageView(VkImageView _imageView)
+{
+	DeferredDeletion deletion;
+	deletion.type = DeferredDeletionType::ImageView;
+	deletion.imageView = _imageView;
+	Push(deletion);
+}
+
+void DeletionQueue::ReleaseMemory(VkDeviceMemory _memory)
+{
+	DeferredDeletion deletion;
+	deletion.type = DeferredDeletionType::DeviceMemory;
+	deletion.memory = _memory;
+	Push(deletion);
+}
+
+void DeletionQueue::ReleaseSampler(VkSampler _sampler)
+{
+	DeferredDeletion deletion;
+	deletion.type = DeferredDeletionType::Sampler;
+	deletion.sampler = _sampler;
+	Push(deletion);
+}
+
+void DeletionQueue::ReleaseDescriptorSet(VkDescriptorPool _descriptorPool, VkDescriptorSet _descriptorSet)
+{
+	DeferredDeletion deletion;
+	deletion.type = DeferredDeletionType::DescriptorSet;
+	deletion.descriptorSet = _descriptorSet;
+	deletion.descriptorPool = _descriptorPool;
+	Push(deletion);
+}
+
+void DeletionQueue::Push(DeferredDeletion& _deletion)
+{
+	_deletion.retiredFrameNumber = frameNumber;
+	deletions.push_back(_deletion);
+}
+
+void DeletionQueue::Destroy(const DeferredDeletion& _deletion)
+{
+	switch (_deletion.type)
+	{
+	case DeferredDeletionType::Buffer:
+		vkDestroyBuffer(logicalDevice, _deletion.buffer, nullptr);
+		break;
+	case DeferredDeletionType::Image:
+		vkDestroyImage(logicalDevice, _deletion.image, nullptr);
+		break;
+	case DeferredDeletionType::ImageView:
+		vkDestroyImageView(logicalDevice, _deletion.imageView, nullptr);
+		break;
+	case DeferredDeletionType::DeviceMemory:
+		vkFreeMemory(logicalDevice, _deletion.memory, nullptr);
+		break;
+	case DeferredDeletionType::Sampler:
+		vkDestroySampler(logicalDevice, _deletion.sampler, nullptr);
+		break;
+	case DeferredDeletionType::DescriptorSet:
+		vkFreeDescriptorSets(logicalDevice, _deletion.descriptorPool, 1, &_deletion.descriptorSet);
+		break;
+	}
+}
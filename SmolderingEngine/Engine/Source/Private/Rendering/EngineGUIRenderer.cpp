@@ -6,6 +6,12 @@
 #include "Engine/Source/Public/Object/ObjectManager.h"
 
 #include "Engine/Source/Public/Rendering/Renderer.h"
+#include "Engine/Source/Public/Rendering/FrameProfiler.h"
+#include "Engine/Source/Public/Rendering/RenderThread.h"
+#include "Engine/Source/Public/SceneQuery/SceneQuery.h"
+#include "Engine/Source/Public/Input/InputManager.h"
+#include "Engine/Source/Public/Camera/Camera.h"
+#include "Engine/Source/Public/Time/FixedTimestep.h"
 
 EngineGUIRenderer::EngineGUIRenderer(const VulkanResources* _resources)
 	: vulkanResources(_resources)
@@ -24,7 +30,7 @@ void EngineGUIRenderer::DestroyEngineGUIRenderer()
 	delete(this);
 }
 
-void EngineGUIRenderer::RecordToCommandBuffer(VkCommandBuffer _commandBuffer, uint32_t _imageIndex)
+void EngineGUIRenderer::BuildFrame(RenderSnapshot& _snapshot)
 {
 	if (seEngineManager == nullptr)
 		seEngineManager = EngineManager::GetEngineManager();
@@ -33,8 +39,9 @@ void EngineGUIRenderer::RecordToCommandBuffer(VkCommandBuffer _commandBuffer, ui
 	ImGui_ImplGlfw_NewFrame();
 	ImGui::NewFrame();
 
+	// The swapchain is resized to the snapshot's size before this GUI is drawn into it
 	ImGuiIO& io = ImGui::GetIO();
-	io.DisplaySize = ImVec2((float)vulkanResources->swapchainExtent.width, (float)vulkanResources->swapchainExtent.height);
+	io.DisplaySize = ImVec2((float)_snapshot.framebufferWidth, (float)_snapshot.framebufferHeight);
 
 	// Insert your ImGui code here
 
@@ -58,13 +65,25 @@ void EngineGUIRenderer::RecordToCommandBuffer(VkCommandBuffer _commandBuffer, ui
 
 	ImGui::Begin("Edit Object", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
 
-	// Input field for the object ID
-	ImGui::Text("Object ID");
-	ImGui::InputInt("ID", &currentSelectedModelID);
+	ObjectManager* seObjectManager = seEngineManager->GetEngineLevelManager()->GetObjectManager();
+	const std::vector<GameObject*>& gameObjects = seObjectManager->GetGameObjects();
+	GameObject* selectedGameObject = seObjectManager->GetGameObject(selectedObject);
 
-	if (currentSelectedModelID < seEngineManager->GetEngineLevelManager()->GetObjectManager()->GetGameObjects().size())
+	// Input field for the object index, the selection itself is kept as a handle so it survives other objects being destroyed
+	int selectedIndex = -1;
+	if (selectedGameObject != nullptr)
+		selectedIndex = static_cast<int>(std::find(gameObjects.begin(), gameObjects.end(), selectedGameObject) - gameObjects.begin());
+
+	ImGui::Text("Object Index");
+	if (ImGui::InputInt("Index", &selectedIndex) && selectedIndex >= 0 && selectedIndex < static_cast<int>(gameObjects.size()))
 	{
-		glm::mat4 modelMat = seEngineManager->GetEngineLevelManager()->GetObjectManager()->GetGameObjects()[currentSelectedModelID]->GetModel().modelMatrix;
+		selectedGameObject = gameObjects[selectedIndex];
+		selectedObject = selectedGameObject->GetHandle();
+	}
+
+	if (selectedGameObject != nullptr)
+	{
+		glm::mat4 modelMat = selectedGameObject->GetModel().modelMatrix;
 
 		float position[3] = { modelMat[3].x, modelMat[3].y, modelMat[3].z };
 		// Input fields for the position
@@ -77,15 +96,119 @@ void EngineGUIRenderer::RecordToCommandBuffer(VkCommandBuffer _commandBuffer, ui
 			modelMat[3].y = position[1];
 			modelMat[3].z = position[2];
 	
-			seEngineManager->GetEngineLevelManager()->GetObjectManager()->GetGameObjects()[currentSelectedModelID]->SetModel(modelMat);
+			selectedGameObject->SetModel(modelMat);
+			seEngineManager->GetSceneQuery()->MarkDirty();
 		}
+
+		if (ImGui::Button("Destroy"))
+			shouldDestroySelected = true;
 	}
 
 	ImGui::End();
 
-	// Render ImGui's draw data into the command buffer
+	DrawRendererStatistics(_snapshot);
+	PickObjectUnderMouse();
+
+	// ImGui reuses its draw lists next frame, the render thread gets its own copy
 	ImGui::Render();
-	ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), _commandBuffer);
+	_snapshot.gui.CopyFrom(ImGui::GetDrawData());
+}
+
+void EngineGUIRenderer::RecordToCommandBuffer(VkCommandBuffer _commandBuffer, uint32_t _frameIndex, const GUIDrawData& _drawData)
+{
+	// Render ImGui's draw data into the command buffer. The backend only reads it, it just is not declared const.
+	ImGui_ImplVulkan_RenderDrawData(const_cast<ImDrawData*>(&_drawData.drawData), _commandBuffer);
+}
+
+void EngineGUIRenderer::DrawRendererStatistics(RenderSnapshot& _snapshot)
+{
+	Renderer* seRenderer = seEngineManager->GetRenderer();
+	FrameProfiler* seFrameProfiler = seRenderer->GetFrameProfiler();
+
+	ImGui::Begin("Renderer Stats", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
+
+	bool depthPrePass = seRenderer->IsDepthPrePassEnabled();
+	if (ImGui::Checkbox("Depth pre-pass", &depthPrePass))
+		seRenderer->SetDepthPrePassEnabled(depthPrePass);
+
+	// Results lag MAX_FRAME_DRAWS frames behind since they are read once the frame's fence has signaled
+	FrameStatistics statistics = seFrameProfiler->GetLatestStatistics();
+	if (statistics.valid)
+	{
+		ImGui::Text("Scene GPU time: %.3f ms", statistics.sceneTime);
+		ImGui::Text("  Depth pre-pass: %.3f ms", statistics.depthPrePassTime);
+		ImGui::Text("  Opaque: %.3f ms", statistics.opaqueTime);
+		ImGui::Text("  Skybox: %.3f ms", statistics.skyboxTime);
+		ImGui::Text("  Transparent: %.3f ms", statistics.transparentTime);
+		if (seFrameProfiler->IsStatisticsSupported())
+			ImGui::Text("Fragment shader invocations: %llu", static_cast<unsigned long long>(statistics.fragmentShaderInvocations));
+	}
+
+	ImGui::Separator();
+	if (seFrameProfiler->IsBenchmarkRunning())
+		ImGui::Text("Benchmark running...");
+	else if (ImGui::Button("Benchmark depth pre-pass"))
+		_snapshot.depthPrePassBenchmarkFrames = benchmarkFramesPerMode;
+
+	std::string benchmarkReport = seFrameProfiler->GetBenchmarkReport();
+	if (!benchmarkReport.empty())
+		ImGui::TextUnformatted(benchmarkReport.c_str());
+
+	// Rendering is not tied to the tick rate, a lower rate costs less CPU and a higher one lowers input latency
+	FixedTimestep* seFixedTimestep = seEngineManager->GetFixedTimestep();
+	int tickRate = seFixedTimestep->GetTickRate();
+	ImGui::Separator();
+	ImGui::Text("Frame: %.3f ms (%.0f FPS)", ImGui::GetIO().DeltaTime * 1000.0f, ImGui::GetIO().Framerate);
+	if (ImGui::SliderInt("Simulation ticks per second", &tickRate, 10, 240))
+		seFixedTimestep->SetTickRate(tickRate);
+
+	// With the render thread on, simulating the next frame should overlap recording and submitting this one
+	RenderThread* seRenderThread = seEngineManager->GetRenderThread();
+	bool threaded = seRenderThread->IsThreaded();
+	if (ImGui::Checkbox("Render thread", &threaded))
+		seRenderThread->SetThreaded(threaded);
+
+	FrameTimeBreakdown breakdown = seRenderThread->GetFrameTimeline()->GetLatestBreakdown();
+	if (breakdown.valid)
+	{
+		ImGui::Text("CPU per drawn frame: %.3f ms", breakdown.frameTime);
+		ImGui::Text("  Simulation: %.3f ms, snapshot: %.3f ms, handoff wait: %.3f ms", breakdown.phaseTimes[PHASE_SIMULATION],
+			breakdown.phaseTimes[PHASE_SNAPSHOT], breakdown.phaseTimes[PHASE_HANDOFF]);
+		ImGui::Text("  Render idle: %.3f ms, frame wait: %.3f ms, record: %.3f ms, submit: %.3f ms", breakdown.phaseTimes[PHASE_RENDER_IDLE],
+			breakdown.phaseTimes[PHASE_FRAME_WAIT], breakdown.phaseTimes[PHASE_RECORD], breakdown.phaseTimes[PHASE_SUBMIT]);
+		ImGui::Text("  Simulation overlapping record + submit: %.3f ms", breakdown.overlapTime);
+	}
+
+	// Heap calls only grow while a level is bigger than any loaded before it
+	ObjectManager* seObjectManager = seEngineManager->GetEngineLevelManager()->GetObjectManager();
+	const AllocationStatistics& poolStatistics = seObjectManager->GetGameObjectPoolStatistics();
+	const AllocationStatistics& arenaStatistics = seObjectManager->GetLevelArena()->GetStatistics();
+	ImGui::Separator();
+	ImGui::Text("GameObject pool: %zu live, %llu heap calls", poolStatistics.liveObjects, static_cast<unsigned long long>(poolStatistics.heapAllocations));
+	ImGui::Text("Level arena: %zu KB, %llu heap calls", arenaStatistics.bytesReserved / 1024, static_cast<unsigned long long>(arenaStatistics.heapAllocations));
+
+	ImGui::End();
+}
+
+void EngineGUIRenderer::PickObjectUnderMouse()
+{
+	// Only pick with a visible cursor and when the click is not meant for an ImGui window
+	ImGuiIO& io = ImGui::GetIO();
+	if (!ImGui::IsMouseClicked(ImGuiMouseButton_Left) || io.WantCaptureMouse)
+		return;
+	if (glfwGetInputMode(seEngineManager->GetInputManager()->window, GLFW_CURSOR) != GLFW_CURSOR_NORMAL)
+		return;
+
+	const std::vector<GameObject*>& gameObjects = seEngineManager->GetEngineLevelManager()->GetObjectManager()->GetGameObjects();
+	SceneQuery* seSceneQuery = seEngineManager->GetSceneQuery();
+	seSceneQuery->UpdateIfDirty(gameObjects);
+
+	Ray ray = SceneQuery::CreateScreenRay(io.MousePos.x, io.MousePos.y, io.DisplaySize.x, io.DisplaySize.y, seEngineManager->GetCamera()->uboViewProjection);
+	RaycastHit hit = seSceneQuery->Raycast(ray);
+	if (!hit.hit)
+		return;
+
+	selectedObject = hit.gameObject->GetHandle();
 }
 
 void EngineGUIRenderer::ProcessEngineGUIInputs()
@@ -107,6 +230,12 @@ void EngineGUIRenderer::ProcessEngineGUIInputs()
 		seEngineManager->GetEngineLevelManager()->SaveLevel(fileName);
 		shouldSaveLevel = false;
 	}
+	if (shouldDestroySelected)
+	{
+		// Level objects are not subscribed to collision, so nothing else holds on to them
+		seEngineManager->GetEngineLevelManager()->GetObjectManager()->DestroyGameObject(selectedObject);
+		shouldDestroySelected = false;
+	}
 }
 
 bool EngineGUIRenderer::InitImGUI()
@@ -147,7 +276,7 @@ bool EngineGUIRenderer::InitImGUI()
 	//imGuiCreateInfo.QueueFamily = indicies.graphicsFamily;
 
 	imGuiCreateInfo.Queue = vulkanResources->graphicsQueue;
-	imGuiCreateInfo.PipelineCache = nullptr;
+	imGuiCreateInfo.PipelineCache = vulkanResources->pipelineCache;
 	imGuiCreateInfo.DescriptorPool = imguiDescriptorPool;
 	imGuiCreateInfo.Allocator = nullptr;
 	imGuiCreateInfo.MinImageCount = static_cast<uint32_t>(vulkanResources->swapchainImages.size());
@@ -156,7 +285,11 @@ bool EngineGUIRenderer::InitImGUI()
 	imGuiCreateInfo.RenderPass = vulkanResources->renderPass;
 
 	// check ! because if it succeeds ImGui_ImplVulkan_Init returns 1 and that = EXIT_FAILURE.
-	return !ImGui_ImplVulkan_Init(&imGuiCreateInfo);
+	if (!ImGui_ImplVulkan_Init(&imGuiCreateInfo))
+		return EXIT_FAILURE;
+
+	// Uploaded now instead of by the first NewFrame, which runs on the simulation thread while the render thread uses the queue
+	return !ImGui_ImplVulkan_CreateFontsTexture();
 }
 
 void EngineGUIRenderer::ResultCheck(VkResult _error)
@@ -0,0 +1,223 @@
+#include "Engine/Source/Public/Rendering/FrameProfiler.h"
+
+// Standard Library
+#include <sstream>
+#include <iomanip>
+
+// Project Includes
+#include "Engine/Source/Public/Rendering/Renderer.h"
+
+FrameProfiler::FrameProfiler(const VulkanResources* _resources, uint32_t _graphicsQueueFamily)
+	: vulkanResources(_resources)
+{
+	// Timestamps need valid bits on the graphics queue, a value of 0 means the queue can not write them
+	uint32_t queueFamilyCount = 0;
+	vkGetPhysicalDeviceQueueFamilyProperties(vulkanResources->physicalDevice, &queueFamilyCount, nullptr);
+	std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+	vkGetPhysicalDeviceQueueFamilyProperties(vulkanResources->physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+	VkPhysicalDeviceProperties deviceProperties;
+	vkGetPhysicalDeviceProperties(vulkanResources->physicalDevice, &deviceProperties);
+	timestampPeriod = deviceProperties.limits.timestampPeriod;
+	timestampsSupported = _graphicsQueueFamily < queueFamilyCount && queueFamilies[_graphicsQueueFamily].timestampValidBits > 0;
+
+	// The Renderer enables this feature on the logical device whenever the physical device has it
+	VkPhysicalDeviceFeatures deviceFeatures;
+	vkGetPhysicalDeviceFeatures(vulkanResources->physicalDevice, &deviceFeatures);
+	statisticsSupported = deviceFeatures.pipelineStatisticsQuery == VK_TRUE;
+
+	if (timestampsSupported)
+	{
+		VkQueryPoolCreateInfo timestampPoolCreateInfo = {};
+		timestampPoolCreateInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		timestampPoolCreateInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+		timestampPoolCreateInfo.queryCount = TIMESTAMP_COUNT * MAX_FRAME_DRAWS;
+
+		if (vkCreateQueryPool(vulkanResources->logicalDevice, &timestampPoolCreateInfo, nullptr, &timestampQueryPool) != VK_SUCCESS)
+			throw std::runtime_error("Failed to create timestamp query pool!");
+	}
+	else
+		std::cout << "Warning: graphics queue does not support timestamps, GPU timings will not be shown" << std::endl;
+
+	if (statisticsSupported)
+	{
+		// Fragment shader invocations are what the depth pre-pass is meant to cut down
+		VkQueryPoolCreateInfo statisticsPoolCreateInfo = {};
+		statisticsPoolCreateInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		statisticsPoolCreateInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+		statisticsPoolCreateInfo.queryCount = MAX_FRAME_DRAWS;
+		statisticsPoolCreateInfo.pipelineStatistics = VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+
+		if (vkCreateQueryPool(vulkanResources->logicalDevice, &statisticsPoolCreateInfo, nullptr, &statisticsQueryPool) != VK_SUCCESS)
+			throw std::runtime_error("Failed to create pipeline statistics query pool!");
+	}
+	else
+		std::cout << "Warning: device does not support pipeline statistics, fragment shader invocations will not be shown" << std::endl;
+}
+
+void FrameProfiler::DestroyFrameProfiler()
+{
+	if (timestampQueryPool != VK_NULL_HANDLE)
+		vkDestroyQueryPool(vulkanResources->logicalDevice, timestampQueryPool, nullptr);
+	if (statisticsQueryPool != VK_NULL_HANDLE)
+		vkDestroyQueryPool(vulkanResources->logicalDevice, statisticsQueryPool, nullptr);
+
+	delete(this);
+}
+
+void FrameProfiler::ResetQueries(VkCommandBuffer _commandBuffer, uint32_t _frameIndex, bool _usingDepthPrePass)
+{
+	if (timestampsSupported)
+		vkCmdResetQueryPool(_commandBuffer, timestampQueryPool, _frameIndex * TIMESTAMP_COUNT, TIMESTAMP_COUNT);
+	if (statisticsSupported)
+		vkCmdResetQueryPool(_commandBuffer, statisticsQueryPool, _frameIndex, 1);
+
+	queriesWritten[_frameIndex] = true;
+	frameUsedDepthPrePass[_frameIndex] = _usingDepthPrePass;
+	frameInBenchmark[_frameIndex] = benchmarkRunning && benchmarkFrameRequested;
+	benchmarkFrameRequested = false;
+}
+
+void FrameProfiler::WriteTimestamp(VkCommandBuffer _commandBuffer, uint32_t _frameIndex, FrameTimestamp _timestamp)
+{
+	if (!timestampsSupported)
+		return;
+
+	// The first stamp marks when the GPU starts on the scene, the rest mark when all prior work has finished
+	VkPipelineStageFlagBits stage = (_timestamp == TIMESTAMP_SCENE_BEGIN) ? VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+	vkCmdWriteTimestamp(_commandBuffer, stage, timestampQueryPool, _frameIndex * TIMESTAMP_COUNT + _timestamp);
+}
+
+void FrameProfiler::BeginStatistics(VkCommandBuffer _commandBuffer, uint32_t _frameIndex)
+{
+	if (statisticsSupported)
+		vkCmdBeginQuery(_commandBuffer, statisticsQueryPool, _frameIndex, 0);
+}
+
+void FrameProfiler::EndStatistics(VkCommandBuffer _commandBuffer, uint32_t _frameIndex)
+{
+	if (statisticsSupported)
+		vkCmdEndQuery(_commandBuffer, statisticsQueryPool, _frameIndex);
+}
+
+void FrameProfiler::CollectResults(uint32_t _frameIndex)
+{
+	// Nothing has been recorded for this frame yet (first MAX_FRAME_DRAWS frames)
+	if (!queriesWritten[_frameIndex])
+		return;
+	queriesWritten[_frameIndex] = false;
+
+	FrameStatistics statistics;
+	statistics.usedDepthPrePass = frameUsedDepthPrePass[_frameIndex];
+
+	// The frame's fence has been waited on, so results are available without VK_QUERY_RESULT_WAIT_BIT
+	if (timestampsSupported)
+	{
+		std::array<uint64_t, TIMESTAMP_COUNT> timestamps;
+		VkResult result = vkGetQueryPoolResults(vulkanResources->logicalDevice, timestampQueryPool, _frameIndex * TIMESTAMP_COUNT, TIMESTAMP_COUNT,
+			sizeof(timestamps), timestamps.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+		if (result != VK_SUCCESS)
+			return;
+
+		auto toMilliseconds = [this](uint64_t _start, uint64_t _end) { return static_cast<double>(_end - _start) * timestampPeriod / 1000000.0; };
+		statistics.depthPrePassTime = toMilliseconds(timestamps[TIMESTAMP_SCENE_BEGIN], timestamps[TIMESTAMP_DEPTH_PREPASS_END]);
+		statistics.opaqueTime = toMilliseconds(timestamps[TIMESTAMP_DEPTH_PREPASS_END], timestamps[TIMESTAMP_OPAQUE_END]);
+		statistics.skyboxTime = toMilliseconds(timestamps[TIMESTAMP_OPAQUE_END], timestamps[TIMESTAMP_SKYBOX_END]);
+		statistics.transparentTime = toMilliseconds(timestamps[TIMESTAMP_SKYBOX_END], timestamps[TIMESTAMP_TRANSPARENT_END]);
+		statistics.sceneTime = toMilliseconds(timestamps[TIMESTAMP_SCENE_BEGIN], timestamps[TIMESTAMP_TRANSPARENT_END]);
+	}
+
+	if (statisticsSupported)
+	{
+		VkResult result = vkGetQueryPoolResults(vulkanResources->logicalDevice, statisticsQueryPool, _frameIndex, 1,
+			sizeof(uint64_t), &statistics.fragmentShaderInvocations, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+		if (result != VK_SUCCESS)
+			return;
+	}
+
+	statistics.valid = true;
+	{
+		std::lock_guard<std::mutex> lock(resultsMutex);
+		latestStatistics = statistics;
+	}
+
+	if (frameInBenchmark[_frameIndex])
+		AccumulateBenchmark(statistics);
+}
+
+void FrameProfiler::StartDepthPrePassBenchmark(int _framesPerMode)
+{
+	benchmarkRunning = true;
+	benchmarkFramesPerMode = std::max(_framesPerMode, 1);
+	benchmarkFramesRequested = 0;
+	benchmarkFramesCollected = 0;
+	benchmarkFrameRequested = false;
+	benchmarkTotals = {};
+
+	std::lock_guard<std::mutex> lock(resultsMutex);
+	benchmarkReport = "Running...";
+}
+
+bool FrameProfiler::GetBenchmarkDepthPrePass(bool* _useDepthPrePass)
+{
+	if (!benchmarkRunning)
+		return false;
+
+	// First half of the frames without the pre-pass, second half with it. Frames past the end are not counted.
+	*_useDepthPrePass = benchmarkFramesRequested >= benchmarkFramesPerMode;
+	benchmarkFrameRequested = benchmarkFramesRequested < benchmarkFramesPerMode * 2;
+	if (benchmarkFrameRequested)
+		benchmarkFramesRequested++;
+	return true;
+}
+
+void FrameProfiler::AccumulateBenchmark(const FrameStatistics& _statistics)
+{
+	if (!benchmarkRunning)
+		return;
+
+	FrameStatistics& totals = benchmarkTotals[_statistics.usedDepthPrePass ? 1 : 0];
+	totals.depthPrePassTime += _statistics.depthPrePassTime;
+	totals.opaqueTime += _statistics.opaqueTime;
+	totals.skyboxTime += _statistics.skyboxTime;
+	totals.transparentTime += _statistics.transparentTime;
+	totals.sceneTime += _statistics.sceneTime;
+	totals.fragmentShaderInvocations += _statistics.fragmentShaderInvocations;
+
+	benchmarkFramesCollected++;
+	if (benchmarkFramesCollected < benchmarkFramesPerMode * 2)
+		return;
+
+	// Every frame has come back, average both modes and report them side by side
+	std::ostringstream report;
+	report << std::fixed << std::setprecision(3);
+	report << "Depth pre-pass benchmark (" << benchmarkFramesPerMode << " frames each)" << std::endl;
+	for (int mode = 0; mode < 2; mode++)
+	{
+		const FrameStatistics& modeTotals = benchmarkTotals[mode];
+		report << (mode == 0 ? "  Without pre-pass: " : "  With pre-pass:    ")
+			<< "scene " << modeTotals.sceneTime / benchmarkFramesPerMode << "ms, "
+			<< "pre-pass " << modeTotals.depthPrePassTime / benchmarkFramesPerMode << "ms, "
+			<< "opaque " << modeTotals.opaqueTime / benchmarkFramesPerMode << "ms, "
+			<< "fragment invocations " << modeTotals.fragmentShaderInvocations / benchmarkFramesPerMode << std::endl;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(resultsMutex);
+		benchmarkReport = report.str();
+	}
+	benchmarkRunning = false;
+	std::cout << report.str();
+}
+
+FrameStatistics FrameProfiler::GetLatestStatistics()
+{
+	std::lock_guard<std::mutex> lock(resultsMutex);
+	return latestStatistics;
+}
+
+std::string FrameProfiler::GetBenchmarkReport()
+{
+	std::lock_guard<std::mutex> lock(resultsMutex);
+	return benchmarkReport;
+}
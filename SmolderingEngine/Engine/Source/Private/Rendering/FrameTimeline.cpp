@@ -0,0 +1,74 @@
+#include "Engine/Source/Public/Rendering/FrameTimeline.h"
+
+// Standard Library
+#include <algorithm>
+
+void FrameTimeline::Record(FramePhase _phase, Clock::time_point _start)
+{
+	Clock::time_point end = Clock::now();
+
+	std::lock_guard<std::mutex> lock(timelineMutex);
+	phaseTotals[_phase] += std::chrono::duration<double, std::milli>(end - _start).count();
+
+	// Waiting is not work, only the busy phases count towards the overlap
+	if (_phase == PHASE_SIMULATION || _phase == PHASE_SNAPSHOT)
+		simulationIntervals.push_back({ _start, end });
+	else if (_phase == PHASE_RECORD || _phase == PHASE_SUBMIT)
+		renderIntervals.push_back({ _start, end });
+}
+
+void FrameTimeline::EndFrame()
+{
+	Clock::time_point now = Clock::now();
+
+	std::lock_guard<std::mutex> lock(timelineMutex);
+	frameCount++;
+	if (now - periodStart < reportPeriod)
+		return;
+
+	double periodTime = std::chrono::duration<double, std::milli>(now - periodStart).count();
+
+	FrameTimeBreakdown breakdown;
+	breakdown.valid = true;
+	breakdown.frameCount = frameCount;
+	breakdown.frameTime = periodTime / frameCount;
+	for (size_t i = 0; i < PHASE_COUNT; i++)
+		breakdown.phaseTimes[i] = phaseTotals[i] / frameCount;
+	breakdown.overlapTime = IntersectIntervals(simulationIntervals, renderIntervals) / frameCount;
+	latestBreakdown = breakdown;
+
+	// Start the next period, the lists keep their capacity
+	simulationIntervals.clear();
+	renderIntervals.clear();
+	phaseTotals = {};
+	frameCount = 0;
+	periodStart = now;
+}
+
+FrameTimeBreakdown FrameTimeline::GetLatestBreakdown()
+{
+	std::lock_guard<std::mutex> lock(timelineMutex);
+	return latestBreakdown;
+}
+
+double FrameTimeline::IntersectIntervals(const std::vector<PhaseInterval>& _a, const std::vector<PhaseInterval>& _b)
+{
+	// Neither list overlaps itself, so walk both in order and always step past whichever interval ends first
+	double overlap = 0.0;
+	size_t i = 0;
+	size_t j = 0;
+	while (i < _a.size() && j < _b.size())
+	{
+		Clock::time_point start = std::max(_a[i].start, _b[j].start);
+		Clock::time_point end = std::min(_a[i].end, _b[j].end);
+		if (start < end)
+			overlap += std::chrono::duration<double, std::milli>(end - start).count();
+
+		if (_a[i].end < _b[j].end)
+			i++;
+		else
+			j++;
+	}
+
+	return overlap;
+}
@@ -6,7 +6,7 @@
 #include "Engine/Source/Public/Object/ObjectManager.h"
 
 #include "Engine/Source/Public/Rendering/Utilities.h"
-#include "Engine/Source/Public/Camera/Camera.h"
+#include "Engine/Source/Public/Rendering/DeletionQueue.h"
 
 LevelRenderer::LevelRenderer(const VulkanResources* _resources)
 	: vulkanResources(_resources)
@@ -29,8 +29,10 @@ LevelRenderer::LevelRenderer(const VulkanResources* _resources)
 
 void LevelRenderer::DestroyLevelRenderer()
 {
-	// Destroy texture image views, images, and memory
+	// Destroy texture image views, images, memory and descriptor sets. The device is idle at shutdown, so they are
+	// destroyed straight away, and the descriptor sets have to be freed before their pool is destroyed below.
 	DestroyAllRendererTextures();
+	vulkanResources->deletionQueue->DestroyAll();
 
 	// Destroy the texture sampler
 	vkDestroySampler(vulkanResources->logicalDevice, textureSampler, nullptr);
@@ -46,8 +48,10 @@ void LevelRenderer::DestroyLevelRenderer()
 		vkFreeMemory(vulkanResources->logicalDevice, viewProjectionUniformBufferMemory[i], nullptr);
 	}
 
-	// Destroy the graphics pipeline and its layout
-	vkDestroyPipeline(vulkanResources->logicalDevice, graphicsPipeline, nullptr);
+	// Destroy every pipeline variant (the invalid keys are VK_NULL_HANDLE, which is ignored) and the shared layout
+	for (VkPipeline pipeline : graphicsPipelines)
+		vkDestroyPipeline(vulkanResources->logicalDevice, pipeline, nullptr);
+	vkDestroyPipeline(vulkanResources->logicalDevice, depthPrePassPipeline, nullptr);
 	vkDestroyPipelineLayout(vulkanResources->logicalDevice, graphicsPipelineLayout, nullptr);
 
 	// Destroy descriptor set layouts
@@ -59,92 +63,187 @@ void LevelRenderer::DestroyLevelRenderer()
 
 void LevelRenderer::DestroyAllRendererTextures()
 {
-	// Wait until queues and all operations are done before cleaning up
-	vkDeviceWaitIdle(vulkanResources->logicalDevice);
-
-	// Destroy texture-related Vulkan objects for the current level
+	// Frames in flight may still sample these, the deletion queue destroys them once those frames have finished
 	for (size_t i = 0; i < textureImages.size(); i++)
 	{
-		vkDestroyImageView(vulkanResources->logicalDevice, textureImageViews[i], nullptr);
-		vkDestroyImage(vulkanResources->logicalDevice, textureImages[i], nullptr);
-		vkFreeMemory(vulkanResources->logicalDevice, textureImageMemory[i], nullptr);
+		vulkanResources->deletionQueue->ReleaseImageView(textureImageViews[i]);
+		vulkanResources->deletionQueue->ReleaseImage(textureImages[i]);
+		vulkanResources->deletionQueue->ReleaseMemory(textureImageMemory[i]);
 	}
 
+	for (VkDescriptorSet descriptorSet : samplerDescriptorSets)
+		vulkanResources->deletionQueue->ReleaseDescriptorSet(samplerDescriptorPool, descriptorSet);
+
 	textureImageViews.clear();
 	textureImages.clear();
 	textureImageMemory.clear();
+
+	// Texture IDs start from 0 again for the next level
+	samplerDescriptorSets.clear();
+	samplerHasTransparency.clear();
 }
 
-void LevelRenderer::RecordToCommandBuffer(VkCommandBuffer _commandBuffer, uint32_t _imageIndex)
+void LevelRenderer::CollectInstances(std::vector<RenderInstance>& _instances)
 {
 	EngineManager* seEngineManager = EngineManager::GetEngineManager();
-	
+
+	_instances.clear();
+
 	if (seEngineManager == nullptr)
 	{
-		std::cout << "Fatal error: LevelRenderer::RecordToCommandBuffer - EngineManager is nullptr!" << std::endl;
+		std::cout << "Fatal error: LevelRenderer::CollectInstances - EngineManager is nullptr!" << std::endl;
 		return;
 	}
 
-	// Bind the main graphics pipeline and its pipeline layout
-	vkCmdBindPipeline(_commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipeline);
-	
-	// Re-bind descriptor sets for the main pipeline
+	// Models are copied now, the simulation moves the objects again while the render thread records them
+	for (GameObject* gameObject : seEngineManager->GetEngineLevelManager()->GetObjectManager()->GetGameObjects())
+		_instances.push_back({ gameObject->GetRenderModel(), gameObject->objectMeshModel });
+}
+
+void LevelRenderer::CollectTextures(std::vector<VkDescriptorSet>& _descriptorSets, std::vector<bool>& _hasTransparency)
+{
+	// Uploads add textures on the simulation thread while the render thread records, so it only reads these copies
+	_descriptorSets = samplerDescriptorSets;
+	_hasTransparency = samplerHasTransparency;
+}
+
+void LevelRenderer::PrepareDrawCommands(const RenderSnapshot& _snapshot, bool _depthPrePass)
+{
+	drawCommands.clear();
+	transparentDrawStart = 0;
+
+	// Build the draw list, each mesh picks the pipeline variant that matches it
+	for (const RenderInstance& instance : _snapshot.instances)
+	{
+		MeshModel* tempModel = instance.meshModel;
+		for (size_t j = 0; j < tempModel->GetMeshCount(); j++)
+		{
+			Mesh* mesh = tempModel->GetMesh(j);
+
+			int textureID = mesh->GetTextureID();
+			bool hasTexture = textureID >= 0 && textureID < static_cast<int>(_snapshot.textureDescriptorSets.size());
+
+			uint32_t pipelineKey = PIPELINE_FLAG_NONE;
+			if (instance.model.useTexture == 1)
+				pipelineKey |= PIPELINE_FLAG_TEXTURED;
+			if (mesh->GetAlphaBlend() || (hasTexture && _snapshot.textureTransparency[textureID]))
+				pipelineKey |= PIPELINE_FLAG_ALPHA_BLEND;
+			else if (_depthPrePass)
+				pipelineKey |= PIPELINE_FLAG_DEPTH_EQUAL;	// Depth is already laid down, only shade the visible fragment
+
+			drawCommands.push_back({ pipelineKey, &instance, mesh, hasTexture ? _snapshot.textureDescriptorSets[textureID] : VK_NULL_HANDLE });
+		}
+	}
+
+	// Alpha blend is the highest flag bit so sorting by key puts every opaque batch before any transparent one.
+	// Stable so objects keep their level order within a batch.
+	std::stable_sort(drawCommands.begin(), drawCommands.end(),
+		[](const LevelDrawCommand& _a, const LevelDrawCommand& _b) { return _a.pipelineKey < _b.pipelineKey; });
+
+	while (transparentDrawStart < drawCommands.size() && !(drawCommands[transparentDrawStart].pipelineKey & PIPELINE_FLAG_ALPHA_BLEND))
+		transparentDrawStart++;
+}
+
+void LevelRenderer::RecordDepthPrePass(VkCommandBuffer _commandBuffer, uint32_t _frameIndex)
+{
+	vkCmdBindPipeline(_commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, depthPrePassPipeline);
 	vkCmdBindDescriptorSets(_commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipelineLayout,
-		0, 1, &uboDescriptorSets[_imageIndex], 0, nullptr);
+		0, 1, &uboDescriptorSets[_frameIndex], 0, nullptr);
 
-	for (size_t i = 0; i < seEngineManager->GetEngineLevelManager()->GetObjectManager()->GetGameObjects().size(); i++)
+	// Only opaque meshes write depth, transparent ones still need to blend over what is behind them
+	const RenderInstance* pushedInstance = nullptr;
+	for (size_t i = 0; i < transparentDrawStart; i++)
 	{
-		MeshModel* tempModel = seEngineManager->GetEngineLevelManager()->GetObjectManager()->GetGameObjects()[i]->objectMeshModel;
-		// Push constants to given shader stage directly
-		vkCmdPushConstants(_commandBuffer, graphicsPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(Model),
-			&seEngineManager->GetEngineLevelManager()->GetObjectManager()->GetGameObjects()[i]->GetModel());
+		const LevelDrawCommand& drawCommand = drawCommands[i];
 
-		for (size_t j = 0; j < tempModel->GetMeshCount(); j++)
+		if (drawCommand.instance != pushedInstance)
 		{
-			// bind mesh vertex buffer
-			VkBuffer vertexBuffers[] = { tempModel->GetMesh(j)->GetVertexBuffer() }; // Buffers to bind
-			VkDeviceSize offsets[] = { 0 };
-			vkCmdBindVertexBuffers(_commandBuffer, 0, 1, vertexBuffers, offsets);
+			vkCmdPushConstants(_commandBuffer, graphicsPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(Model), &drawCommand.instance->model);
+			pushedInstance = drawCommand.instance;
+		}
 
-			// Bind mesh index buffer
-			vkCmdBindIndexBuffer(_commandBuffer, tempModel->GetMesh(j)->GetIndexBuffer(), 0, VK_INDEX_TYPE_UINT32);
+		VkBuffer vertexBuffers[] = { drawCommand.mesh->GetVertexBuffer() };
+		VkDeviceSize offsets[] = { 0 };
+		vkCmdBindVertexBuffers(_commandBuffer, 0, 1, vertexBuffers, offsets);
+		vkCmdBindIndexBuffer(_commandBuffer, drawCommand.mesh->GetIndexBuffer(), 0, VK_INDEX_TYPE_UINT32);
 
-			// Bind descriptor sets
-			if (tempModel->GetMesh(j)->GetTextureID() >= 0)
+		vkCmdDrawIndexed(_commandBuffer, drawCommand.mesh->GetIndexCount(), 1, 0, 0, 0);
+	}
+}
+
+void LevelRenderer::RecordOpaqueToCommandBuffer(VkCommandBuffer _commandBuffer, uint32_t _frameIndex)
+{
+	RecordDrawCommands(_commandBuffer, _frameIndex, 0, transparentDrawStart);
+}
+
+void LevelRenderer::RecordTransparentToCommandBuffer(VkCommandBuffer _commandBuffer, uint32_t _frameIndex)
+{
+	RecordDrawCommands(_commandBuffer, _frameIndex, transparentDrawStart, drawCommands.size());
+}
+
+void LevelRenderer::RecordDrawCommands(VkCommandBuffer _commandBuffer, uint32_t _frameIndex, size_t _first, size_t _last)
+{
+	if (_first >= _last)
+		return;
+
+	// Set 0 (view projection) is shared by every variant since they all use the same layout
+	vkCmdBindDescriptorSets(_commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipelineLayout,
+		0, 1, &uboDescriptorSets[_frameIndex], 0, nullptr);
+
+	uint32_t boundPipelineKey = PIPELINE_VARIANT_COUNT;
+	const RenderInstance* pushedInstance = nullptr;
+	for (size_t i = _first; i < _last; i++)
+	{
+		const LevelDrawCommand& drawCommand = drawCommands[i];
+
+		// Only switch pipelines between batches
+		if (drawCommand.pipelineKey != boundPipelineKey)
+		{
+			vkCmdBindPipeline(_commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipelines[drawCommand.pipelineKey]);
+			boundPipelineKey = drawCommand.pipelineKey;
+		}
+
+		// Push constants to given shader stage directly
+		if (drawCommand.instance != pushedInstance)
+		{
+			vkCmdPushConstants(_commandBuffer, graphicsPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(Model), &drawCommand.instance->model);
+			pushedInstance = drawCommand.instance;
+		}
+
+		// bind mesh vertex buffer
+		VkBuffer vertexBuffers[] = { drawCommand.mesh->GetVertexBuffer() }; // Buffers to bind
+		VkDeviceSize offsets[] = { 0 };
+		vkCmdBindVertexBuffers(_commandBuffer, 0, 1, vertexBuffers, offsets);
+
+		// Bind mesh index buffer
+		vkCmdBindIndexBuffer(_commandBuffer, drawCommand.mesh->GetIndexBuffer(), 0, VK_INDEX_TYPE_UINT32);
+
+		// Untextured variants never sample, so they do not need the texture set bound
+		if (drawCommand.pipelineKey & PIPELINE_FLAG_TEXTURED)
+		{
+			if (drawCommand.textureDescriptorSet != VK_NULL_HANDLE)
 			{
-				// TODO: MEMORY LEAK -> When loading new level, make sure to remove old sampler descriptor set!!
-				std::array<VkDescriptorSet, 2> descriptorSetGroup = { uboDescriptorSets[_imageIndex],
-					samplerDescriptorSets[tempModel->GetMesh(j)->GetTextureID()] };
-				
 				vkCmdBindDescriptorSets(_commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipelineLayout,
-					0, static_cast<uint32_t>(descriptorSetGroup.size()), descriptorSetGroup.data(), 0, nullptr);
+					1, 1, &drawCommand.textureDescriptorSet, 0, nullptr);
 			}
 			else
 			{
 				std::cout << "Error: Game mesh has no texture AND blank texture is not loaded." << std::endl;
 			}
-
-			// Execute the pipeline
-			vkCmdDrawIndexed(_commandBuffer, tempModel->GetMesh(j)->GetIndexCount(), 1, 0, 0, 0);
 		}
+
+		// Execute the pipeline
+		vkCmdDrawIndexed(_commandBuffer, drawCommand.mesh->GetIndexCount(), 1, 0, 0, 0);
 	}
 }
 
-void LevelRenderer::UpdateUniformBuffer(const Camera* _camera, uint32_t _imageIndex)
+void LevelRenderer::UpdateUniformBuffer(const UniformBufferObjectViewProjection& _viewProjection, uint32_t _frameIndex)
 {
 	// copy view projection data
 	void* data;
-	vkMapMemory(vulkanResources->logicalDevice, viewProjectionUniformBufferMemory[_imageIndex], 0, sizeof(UniformBufferObjectViewProjection), 0, &data);
-	memcpy(data, &_camera->uboViewProjection, sizeof(UniformBufferObjectViewProjection));
-	vkUnmapMemory(vulkanResources->logicalDevice, viewProjectionUniformBufferMemory[_imageIndex]);
-}
-
-void LevelRenderer::ResizeRenderer()
-{
-	vkDestroyPipelineLayout(vulkanResources->logicalDevice, graphicsPipelineLayout, nullptr);
-	vkDestroyPipeline(vulkanResources->logicalDevice, graphicsPipeline, nullptr);
-
-	CreateGraphicsPipeline();
+	vkMapMemory(vulkanResources->logicalDevice, viewProjectionUniformBufferMemory[_frameIndex], 0, sizeof(UniformBufferObjectViewProjection), 0, &data);
+	memcpy(data, &_viewProjection, sizeof(UniformBufferObjectViewProjection));
+	vkUnmapMemory(vulkanResources->logicalDevice, viewProjectionUniformBufferMemory[_frameIndex]);
 }
 
 void LevelRenderer::CreateDescriptorSetLayout()
@@ -221,7 +320,18 @@ void LevelRenderer::CreateGraphicsPipeline()
 	fragmentShaderStageCreateInfo.module = FragmentShaderModule;
 	fragmentShaderStageCreateInfo.pName = "main"; // run the "main" function in the shader
 
-	VkPipelineShaderStageCreateInfo ShaderStages[] = { vertexShaderStageCreateInfo, fragmentShaderStageCreateInfo };
+#pragma endregion
+
+#pragma region Specialization Constants
+	// constant_id 0 in Shader.frag decides if the texture is sampled, so the untextured variant has no branch at all
+	VkSpecializationMapEntry useTextureMapEntry = {};
+	useTextureMapEntry.constantID = 0;
+	useTextureMapEntry.offset = 0;
+	useTextureMapEntry.size = sizeof(VkBool32);
+
+	std::array<VkBool32, PIPELINE_VARIANT_COUNT> useTextureValues;
+	std::array<VkSpecializationInfo, PIPELINE_VARIANT_COUNT> specializationInfos;
+	std::array<std::array<VkPipelineShaderStageCreateInfo, 2>, PIPELINE_VARIANT_COUNT> shaderStages;
 #pragma endregion
 
 #pragma region Vertex Input
@@ -270,35 +380,27 @@ void LevelRenderer::CreateGraphicsPipeline()
 #pragma endregion
 
 #pragma region Viewport and Scissor
-	VkViewport viewport = {};
-	viewport.x = 0.0f;
-	viewport.y = 0.0f;
-	viewport.width = (float)vulkanResources->swapchainExtent.width;
-	viewport.height = (float)vulkanResources->swapchainExtent.height;
-	viewport.minDepth = 0.0f;
-	viewport.maxDepth = 1.0f;
-
-	VkRect2D scissor = {};
-	scissor.offset = { 0,0 };
-	scissor.extent = vulkanResources->swapchainExtent;
-
+	// Viewport and scissor are dynamic (set in Renderer::RecordCommands) so resizing the window does not rebuild the pipeline
 	VkPipelineViewportStateCreateInfo viewportStateCreateInfo = {};
 	viewportStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
 	viewportStateCreateInfo.viewportCount = 1;
-	viewportStateCreateInfo.pViewports = &viewport;
+	viewportStateCreateInfo.pViewports = nullptr;
 	viewportStateCreateInfo.scissorCount = 1;
-	viewportStateCreateInfo.pScissors = &scissor;
+	viewportStateCreateInfo.pScissors = nullptr;
 #pragma endregion
 
-	//// TODO: Dynamic States
-	//std::vector<VkDynamicState> EnabledDynamicStates;
-	//EnabledDynamicStates.push_back(VK_DYNAMIC_STATE_VIEWPORT);	// Dynamic Viewport allows you to resize command buffer with vkCmdSetViewport();
-	//EnabledDynamicStates.push_back(VK_DYNAMIC_STATE_SCISSOR);	// Dynamic Scissor allows you to resize command buffer with vkCmdSetScissor();
-
-	//VkPipelineDynamicStateCreateInfo DynamicStateCreateInfo = {};
-	//DynamicStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-	//DynamicStateCreateInfo.dynamicStateCount = static_cast<uint32_t>(EnabledDynamicStates.size());
-	//DynamicStateCreateInfo.pDynamicStates = EnabledDynamicStates.data();
+#pragma region Dynamic States
+	std::array<VkDynamicState, 2> enabledDynamicStates = 
+	{
+		VK_DYNAMIC_STATE_VIEWPORT,	// Dynamic Viewport allows you to resize command buffer with vkCmdSetViewport();
+		VK_DYNAMIC_STATE_SCISSOR	// Dynamic Scissor allows you to resize command buffer with vkCmdSetScissor();
+	};
+
+	VkPipelineDynamicStateCreateInfo dynamicStateCreateInfo = {};
+	dynamicStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+	dynamicStateCreateInfo.dynamicStateCount = static_cast<uint32_t>(enabledDynamicStates.size());
+	dynamicStateCreateInfo.pDynamicStates = enabledDynamicStates.data();
+#pragma endregion
 
 #pragma region Rasterization Creation
 	VkPipelineRasterizationStateCreateInfo rasterizationCreateInfo = {};
@@ -320,23 +422,30 @@ void LevelRenderer::CreateGraphicsPipeline()
 #pragma endregion
 
 #pragma region Color Blending
-	VkPipelineColorBlendAttachmentState ColorState = {};
-	ColorState.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT	// Colors to apply blending to
+	// Opaque variants write straight through, only alpha blend variants read back the old color
+	VkPipelineColorBlendAttachmentState opaqueColorState = {};
+	opaqueColorState.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT	// Colors to apply blending to
 		| VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-	ColorState.blendEnable = VK_TRUE;
+	opaqueColorState.blendEnable = VK_FALSE;
+
+	VkPipelineColorBlendAttachmentState blendColorState = opaqueColorState;
+	blendColorState.blendEnable = VK_TRUE;
 	// Blending uses equation (srcColorBlendFactor * new color) colorBlendOp (dstColorBlendFactor * old color)
-	ColorState.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
-	ColorState.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
-	ColorState.colorBlendOp = VK_BLEND_OP_ADD;
-	ColorState.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
-	ColorState.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
-	ColorState.alphaBlendOp = VK_BLEND_OP_ADD;
-
-	VkPipelineColorBlendStateCreateInfo ColorBlendingCreateInfo = {};
-	ColorBlendingCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-	ColorBlendingCreateInfo.logicOpEnable = VK_FALSE;
-	ColorBlendingCreateInfo.attachmentCount = 1;
-	ColorBlendingCreateInfo.pAttachments = &ColorState;
+	blendColorState.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+	blendColorState.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+	blendColorState.colorBlendOp = VK_BLEND_OP_ADD;
+	blendColorState.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+	blendColorState.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+	blendColorState.alphaBlendOp = VK_BLEND_OP_ADD;
+
+	VkPipelineColorBlendStateCreateInfo opaqueColorBlendingCreateInfo = {};
+	opaqueColorBlendingCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+	opaqueColorBlendingCreateInfo.logicOpEnable = VK_FALSE;
+	opaqueColorBlendingCreateInfo.attachmentCount = 1;
+	opaqueColorBlendingCreateInfo.pAttachments = &opaqueColorState;
+
+	VkPipelineColorBlendStateCreateInfo blendColorBlendingCreateInfo = opaqueColorBlendingCreateInfo;
+	blendColorBlendingCreateInfo.pAttachments = &blendColorState;
 #pragma endregion
 
 #pragma region Pipeline Layout
@@ -363,18 +472,21 @@ void LevelRenderer::CreateGraphicsPipeline()
 	depthStencilCreateInfo.depthBoundsTestEnable = VK_FALSE;		// Should the depth value exist between two values
 	depthStencilCreateInfo.stencilTestEnable = VK_FALSE;
 
+	// After a depth pre-pass the buffer already holds the nearest depth, so only the matching fragment is shaded
+	VkPipelineDepthStencilStateCreateInfo depthEqualStencilCreateInfo = depthStencilCreateInfo;
+	depthEqualStencilCreateInfo.depthWriteEnable = VK_FALSE;
+	depthEqualStencilCreateInfo.depthCompareOp = VK_COMPARE_OP_EQUAL;
+
 	// Create Graphics Pipeline
 	VkGraphicsPipelineCreateInfo GraphicsPipelineCreateInfo = {};
 	GraphicsPipelineCreateInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
 	GraphicsPipelineCreateInfo.stageCount = 2;
-	GraphicsPipelineCreateInfo.pStages = ShaderStages;
 	GraphicsPipelineCreateInfo.pVertexInputState = &VertexInputCreateInfo;
 	GraphicsPipelineCreateInfo.pInputAssemblyState = &inputAssembly;
 	GraphicsPipelineCreateInfo.pViewportState = &viewportStateCreateInfo;
-	GraphicsPipelineCreateInfo.pDynamicState = nullptr;
+	GraphicsPipelineCreateInfo.pDynamicState = &dynamicStateCreateInfo;
 	GraphicsPipelineCreateInfo.pRasterizationState = &rasterizationCreateInfo;
 	GraphicsPipelineCreateInfo.pMultisampleState = &multisampleCreateInfo;
-	GraphicsPipelineCreateInfo.pColorBlendState = &ColorBlendingCreateInfo;
 	GraphicsPipelineCreateInfo.pDepthStencilState = &depthStencilCreateInfo;
 	GraphicsPipelineCreateInfo.layout = graphicsPipelineLayout;
 	GraphicsPipelineCreateInfo.renderPass = vulkanResources->renderPass;
@@ -383,11 +495,64 @@ void LevelRenderer::CreateGraphicsPipeline()
 	GraphicsPipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
 	GraphicsPipelineCreateInfo.basePipelineIndex = -1;
 
-	Result = vkCreateGraphicsPipelines(vulkanResources->logicalDevice, VK_NULL_HANDLE, 1, &GraphicsPipelineCreateInfo, nullptr, &graphicsPipeline);
+	// Fill out one create info per valid variant, validKeys maps each one back to its index in the table
+	std::array<VkGraphicsPipelineCreateInfo, PIPELINE_VARIANT_COUNT> pipelineCreateInfos;
+	std::array<uint32_t, PIPELINE_VARIANT_COUNT> validKeys;
+	uint32_t validCount = 0;
+	for (uint32_t key = 0; key < PIPELINE_VARIANT_COUNT; key++)
+	{
+		if (!IsValidPipelineKey(key))
+			continue;
+
+		useTextureValues[key] = (key & PIPELINE_FLAG_TEXTURED) ? VK_TRUE : VK_FALSE;
+
+		specializationInfos[key] = {};
+		specializationInfos[key].mapEntryCount = 1;
+		specializationInfos[key].pMapEntries = &useTextureMapEntry;
+		specializationInfos[key].dataSize = sizeof(VkBool32);
+		specializationInfos[key].pData = &useTextureValues[key];
+
+		shaderStages[key] = { vertexShaderStageCreateInfo, fragmentShaderStageCreateInfo };
+		shaderStages[key][1].pSpecializationInfo = &specializationInfos[key];
+
+		VkGraphicsPipelineCreateInfo& pipelineCreateInfo = pipelineCreateInfos[validCount];
+		pipelineCreateInfo = GraphicsPipelineCreateInfo;
+		pipelineCreateInfo.pStages = shaderStages[key].data();
+		pipelineCreateInfo.pColorBlendState = (key & PIPELINE_FLAG_ALPHA_BLEND) ? &blendColorBlendingCreateInfo : &opaqueColorBlendingCreateInfo;
+		pipelineCreateInfo.pDepthStencilState = (key & PIPELINE_FLAG_DEPTH_EQUAL) ? &depthEqualStencilCreateInfo : &depthStencilCreateInfo;
+		validKeys[validCount++] = key;
+	}
+
+	// Every valid variant is built up front so picking one while drawing never compiles anything
+	std::array<VkPipeline, PIPELINE_VARIANT_COUNT> createdPipelines;
+	Result = vkCreateGraphicsPipelines(vulkanResources->logicalDevice, vulkanResources->pipelineCache, validCount,
+		pipelineCreateInfos.data(), nullptr, createdPipelines.data());
 
 	if (Result != VK_SUCCESS)
 		throw std::runtime_error("Failed to create graphics pipeline!");
 
+	graphicsPipelines.fill(VK_NULL_HANDLE);
+	for (uint32_t i = 0; i < validCount; i++)
+		graphicsPipelines[validKeys[i]] = createdPipelines[i];
+
+	// Depth pre-pass has no fragment stage and writes no color, it only lays down depth for the opaque pass
+	VkPipelineColorBlendAttachmentState depthOnlyColorState = {};
+	depthOnlyColorState.colorWriteMask = 0;
+	depthOnlyColorState.blendEnable = VK_FALSE;
+
+	VkPipelineColorBlendStateCreateInfo depthOnlyColorBlendingCreateInfo = opaqueColorBlendingCreateInfo;
+	depthOnlyColorBlendingCreateInfo.pAttachments = &depthOnlyColorState;
+
+	VkGraphicsPipelineCreateInfo depthPrePassCreateInfo = GraphicsPipelineCreateInfo;
+	depthPrePassCreateInfo.stageCount = 1;
+	depthPrePassCreateInfo.pStages = &vertexShaderStageCreateInfo;
+	depthPrePassCreateInfo.pColorBlendState = &depthOnlyColorBlendingCreateInfo;
+	depthPrePassCreateInfo.pDepthStencilState = &depthStencilCreateInfo;
+
+	Result = vkCreateGraphicsPipelines(vulkanResources->logicalDevice, vulkanResources->pipelineCache, 1, &depthPrePassCreateInfo, nullptr, &depthPrePassPipeline);
+	if (Result != VK_SUCCESS)
+		throw std::runtime_error("Failed to create depth pre-pass pipeline!");
+
 	// Destroy shader modules
 	vkDestroyShaderModule(vulkanResources->logicalDevice, FragmentShaderModule, nullptr);
 	vkDestroyShaderModule(vulkanResources->logicalDevice, VertexShaderModule, nullptr);
@@ -421,10 +586,11 @@ void LevelRenderer::CreateUniformBuffers()
 {
 	VkDeviceSize viewProjectionBufferSize = sizeof(UniformBufferObjectViewProjection);
 
-	viewProjectionUniformBuffers.resize(vulkanResources->swapchainImages.size());
-	viewProjectionUniformBufferMemory.resize(vulkanResources->swapchainImages.size());
+	// One per frame in flight, they are written and bound by currentFrame rather than by swapchain image
+	viewProjectionUniformBuffers.resize(MAX_FRAME_DRAWS);
+	viewProjectionUniformBufferMemory.resize(MAX_FRAME_DRAWS);
 
-	for (size_t i = 0; i < vulkanResources->swapchainImages.size(); i++)
+	for (size_t i = 0; i < MAX_FRAME_DRAWS; i++)
 	{
 		CreateBuffer(vulkanResources->physicalDevice, vulkanResources->logicalDevice, viewProjectionBufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
 			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &viewProjectionUniformBuffers[i], &viewProjectionUniformBufferMemory[i]);
@@ -443,7 +609,7 @@ void LevelRenderer::CreateDescriptorPool()
 
 	VkDescriptorPoolCreateInfo descriptorPoolCreateInfo = {};
 	descriptorPoolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-	descriptorPoolCreateInfo.maxSets = static_cast<uint32_t>(vulkanResources->swapchainImages.size());
+	descriptorPoolCreateInfo.maxSets = static_cast<uint32_t>(MAX_FRAME_DRAWS);
 	descriptorPoolCreateInfo.poolSizeCount = static_cast<uint32_t>(descriptorPoolSizes.size());
 	descriptorPoolCreateInfo.pPoolSizes = descriptorPoolSizes.data();
 
@@ -458,6 +624,7 @@ void LevelRenderer::CreateDescriptorPool()
 
 	VkDescriptorPoolCreateInfo samplerPoolCreateInfo = {};
 	samplerPoolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	samplerPoolCreateInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;	// Texture sets are freed one by one when a level is unloaded
 	samplerPoolCreateInfo.maxSets = MAX_OBJECTS;
 	samplerPoolCreateInfo.poolSizeCount = 1;
 	samplerPoolCreateInfo.pPoolSizes = &samplerPoolSize;
@@ -470,14 +637,14 @@ void LevelRenderer::CreateDescriptorPool()
 void LevelRenderer::AllocateDescriptorSets()
 {
 	// resize descriptor set, the uniform buffers are linked
-	uboDescriptorSets.resize(vulkanResources->swapchainImages.size());
+	uboDescriptorSets.resize(MAX_FRAME_DRAWS);
 
-	std::vector<VkDescriptorSetLayout> descriptorSetLayouts(vulkanResources->swapchainImages.size(), uboDescriptorSetLayout);
+	std::vector<VkDescriptorSetLayout> descriptorSetLayouts(MAX_FRAME_DRAWS, uboDescriptorSetLayout);
 
 	VkDescriptorSetAllocateInfo descriptorSetAllocateInfo = {};
 	descriptorSetAllocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
 	descriptorSetAllocateInfo.descriptorPool = uboDescriptorPool;
-	descriptorSetAllocateInfo.descriptorSetCount = static_cast<uint32_t>(vulkanResources->swapchainImages.size());
+	descriptorSetAllocateInfo.descriptorSetCount = static_cast<uint32_t>(MAX_FRAME_DRAWS);
 	descriptorSetAllocateInfo.pSetLayouts = descriptorSetLayouts.data();
 
 	VkResult result = vkAllocateDescriptorSets(vulkanResources->logicalDevice, &descriptorSetAllocateInfo, uboDescriptorSets.data());
@@ -485,7 +652,7 @@ void LevelRenderer::AllocateDescriptorSets()
 		throw std::runtime_error("Failed to allocate descriptor sets!");
 
 	// Update all of descriptor set buffer bindings
-	for (size_t i = 0; i < vulkanResources->swapchainImages.size(); i++)
+	for (size_t i = 0; i < MAX_FRAME_DRAWS; i++)
 	{
 		// View projection descriptor
 		// Buffer info and data offset info
@@ -598,13 +765,24 @@ stbi_uc* LevelRenderer::LoadTextureFile(std::string _fileName, int* _width, int*
 	return image;
 }
 
-int LevelRenderer::CreateTextureImage(std::string _fileName)
+int LevelRenderer::CreateTextureImage(std::string _fileName, bool* _hasTransparency)
 {
 	// Load image file
 	int width, height;
 	VkDeviceSize imageSize;
 	stbi_uc* imageData = LoadTextureFile(_fileName, &width, &height, &imageSize);
 
+	// Any alpha below fully opaque means meshes using this texture need the alpha blend pipeline
+	*_hasTransparency = false;
+	for (VkDeviceSize i = 3; i < imageSize; i += 4)
+	{
+		if (imageData[i] < 255)
+		{
+			*_hasTransparency = true;
+			break;
+		}
+	}
+
 	// Create staging buffer to hold loaded data, ready to copy to device
 	VkBuffer imageStagingBuffer;
 	VkDeviceMemory imageStagingBufferMemory;
@@ -630,14 +808,14 @@ int LevelRenderer::CreateTextureImage(std::string _fileName)
 
 	// COPY DATA TO IMAGE
 	// Transition image to be DST for copy operation
-	TransitionImageLayout(vulkanResources->logicalDevice, vulkanResources->graphicsQueue, vulkanResources->graphicsCommandPool,
+	TransitionImageLayout(vulkanResources->logicalDevice, vulkanResources->graphicsQueue, vulkanResources->uploadCommandPool,
 		texImage, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1);
 
 	// Copy image data
-	CopyImageBuffer(vulkanResources->logicalDevice, vulkanResources->graphicsQueue, vulkanResources->graphicsCommandPool, imageStagingBuffer, texImage, width, height);
+	CopyImageBuffer(vulkanResources->logicalDevice, vulkanResources->graphicsQueue, vulkanResources->uploadCommandPool, imageStagingBuffer, texImage, width, height);
 
 	// Transition image to be shader readable for shader usage
-	TransitionImageLayout(vulkanResources->logicalDevice, vulkanResources->graphicsQueue, vulkanResources->graphicsCommandPool,
+	TransitionImageLayout(vulkanResources->logicalDevice, vulkanResources->graphicsQueue, vulkanResources->uploadCommandPool,
 		texImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, 1);
 
 	// Add texture data to vector for reference
@@ -655,7 +833,8 @@ int LevelRenderer::CreateTextureImage(std::string _fileName)
 int LevelRenderer::CreateTexture(std::string _fileName)
 {
 	// Create Texture Image and get its location in array
-	int textureImageLoc = CreateTextureImage(_fileName);
+	bool hasTransparency;
+	int textureImageLoc = CreateTextureImage(_fileName, &hasTransparency);
 
 	// Create Image View and add to list
 	VkImageView imageView = CreateImageView(textureImages[textureImageLoc], VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_ASPECT_COLOR_BIT);
@@ -664,6 +843,9 @@ int LevelRenderer::CreateTexture(std::string _fileName)
 	// Create Texture Descriptor
 	int descriptorLoc = CreateTextureDescriptor(imageView);
 
+	// Kept alongside the descriptor sets since that is the ID meshes hold on to
+	samplerHasTransparency.push_back(hasTransparency);
+
 	// Return location of set with texture
 	return descriptorLoc;
 }
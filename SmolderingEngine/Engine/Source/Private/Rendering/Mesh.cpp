@@ -1,36 +1,56 @@
 #include "Engine/Source/Public/Rendering/Mesh.h"
 
+// Project Includes
+#include "Engine/Source/Public/Rendering/DeletionQueue.h"
+
+void MeshData::BuildQueryData()
+{
+	// Keep the vertex positions and calculate the object space AABB. World space bounds are derived from this by GameObject.
+	vertexPositions.reserve(vertices.size());
+	// this algorithm just copies the position data of from the Vertex struct instead of having to loop
+	std::transform(vertices.begin(), vertices.end(), std::back_inserter(vertexPositions),
+		[](const Vertex& vertex) {
+			return glm::vec3(vertex.position[0], vertex.position[1], vertex.position[2]);
+		});
+
+	localAABB = CreateEmptyAABB();
+	for (const glm::vec3& position : vertexPositions)
+		GrowAABB(localAABB, position);
+
+	// Built here in the import job, so the SAH build holds up neither the main thread nor the render thread
+	triangleBVH.Build(vertexPositions, indices);
+}
+
 Mesh::Mesh()
 {
 }
 
 Mesh::Mesh(VkPhysicalDevice inPhysicalDevice, VkDevice inLogicalDevice, VkQueue inTransferQueue, VkCommandPool inTransferCommandPool,
-	std::vector<Vertex>* inVertices, std::vector<uint32_t>* inIndicies)
+	MeshData&& inMeshData)
 {
 	physicalDevice = inPhysicalDevice;
 	logicalDevice = inLogicalDevice;
 
-	vertexCount = inVertices->size();
-	indexCount = inIndicies->size();
+	vertexCount = inMeshData.vertices.size();
+	indexCount = inMeshData.indices.size();
 
-	CreateVertexBuffer(inTransferQueue, inTransferCommandPool, inVertices);
-	CreateIndexBuffer(inTransferQueue, inTransferCommandPool, inIndicies);
+	CreateVertexBuffer(inTransferQueue, inTransferCommandPool, &inMeshData.vertices);
+	CreateIndexBuffer(inTransferQueue, inTransferCommandPool, &inMeshData.indices);
 
-	// Define the model matrix and then calculate the AABB in world space.
-	initialVertexPositions.reserve(inVertices->size());
-	// this algorithm just copies the position data of from the Vertex struct instead of having to loop
-	std::transform(inVertices->begin(), inVertices->end(), std::back_inserter(initialVertexPositions),
-		[](const Vertex& vertex) {
-			return glm::vec3(vertex.position[0], vertex.position[1], vertex.position[2]);
-		});
+	// Positions, indices and the triangle BVH are kept for scene queries
+	initialVertexPositions = std::move(inMeshData.vertexPositions);
+	initialIndices = std::move(inMeshData.indices);
+	localAABB = inMeshData.localAABB;
+	triangleBVH = std::move(inMeshData.triangleBVH);
+	alphaBlend = inMeshData.alphaBlend;
 }
 
-void Mesh::DestroyMesh()
+void Mesh::DestroyMesh(DeletionQueue* _deletionQueue)
 {
-	vkDestroyBuffer(logicalDevice, indexBuffer, nullptr);
-	vkFreeMemory(logicalDevice, indexBufferMemory, nullptr);
-	vkDestroyBuffer(logicalDevice, vertexBuffer, nullptr);	
-	vkFreeMemory(logicalDevice, vertexBufferMemory, nullptr);
+	_deletionQueue->ReleaseBuffer(indexBuffer);
+	_deletionQueue->ReleaseMemory(indexBufferMemory);
+	_deletionQueue->ReleaseBuffer(vertexBuffer);
+	_deletionQueue->ReleaseMemory(vertexBufferMemory);
 }
 
 void Mesh::SetTextureFilePath(std::string inFilePath)
@@ -53,6 +73,16 @@ void Mesh::SetTextureID(int inTextureID)
 	textureID = inTextureID;
 }
 
+bool Mesh::GetAlphaBlend()
+{
+	return alphaBlend;
+}
+
+void Mesh::SetAlphaBlend(bool inAlphaBlend)
+{
+	alphaBlend = inAlphaBlend;
+}
+
 int Mesh::GetVertexCount()
 {
 	return vertexCount;
@@ -63,7 +93,7 @@ VkBuffer Mesh::GetVertexBuffer()
 	return vertexBuffer;
 }
 
-std::vector<glm::vec3> Mesh::GetVertices()
+const std::vector<glm::vec3>& Mesh::GetVertices()
 {
 	return initialVertexPositions;
 }
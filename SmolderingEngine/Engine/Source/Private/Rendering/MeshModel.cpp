@@ -1,18 +1,26 @@
 #include "Engine/Source/Public/Rendering/MeshModel.h"
 
+// Project Includes
+#include "Engine/Source/Public/Rendering/DeletionQueue.h"
+
 MeshModel::MeshModel()
 {
+	localAABB = CreateEmptyAABB();
 }
 
-MeshModel::MeshModel(std::vector<Mesh> inMeshList)
+MeshModel::MeshModel(std::vector<Mesh>&& inMeshList)
+	: meshList(std::move(inMeshList))
 {
-	meshList = inMeshList;
+	// Combine the already calculated mesh bounds rather than going over every vertex again
+	localAABB = CreateEmptyAABB();
+	for (Mesh& mesh : meshList)
+		localAABB = MergeAABB(localAABB, mesh.GetLocalAABB());
 }
 
-void MeshModel::DestroyMeshModel()
+void MeshModel::DestroyMeshModel(DeletionQueue* _deletionQueue)
 {
 	for (auto& mesh : meshList)
-		mesh.DestroyMesh();
+		mesh.DestroyMesh(_deletionQueue);
 }
 
 std::vector<std::string> MeshModel::LoadMaterials(const aiScene* inScene)
@@ -45,29 +53,29 @@ std::vector<std::string> MeshModel::LoadMaterials(const aiScene* inScene)
 	return textureList;
 }
 
-std::vector<Mesh> MeshModel::LoadNode(VkPhysicalDevice inPhysicalDevice, VkDevice inLogicalDevice, VkQueue inTransferQueue, VkCommandPool inTransferCommandPool, aiNode* inNode, const aiScene* inScene, std::vector<int> inMaterialToTexture)
+void MeshModel::LoadNode(aiNode* inNode, const aiScene* inScene, std::vector<MeshData>& outMeshData)
 {
-	std::vector<Mesh> meshList;
+	// The whole scene's mesh count is known up front, so the list only grows once
+	if (outMeshData.empty())
+		outMeshData.reserve(inScene->mNumMeshes);
 
 	for (size_t i = 0; i < inNode->mNumMeshes; i++)
 	{
-		meshList.push_back(LoadMesh(inPhysicalDevice, inLogicalDevice, inTransferQueue, inTransferCommandPool, inScene->mMeshes[inNode->mMeshes[i]], inScene, inMaterialToTexture));
+		outMeshData.push_back(LoadMesh(inScene->mMeshes[inNode->mMeshes[i]], inScene));
 	}
 
-	// Go through every child node and add the meshes to the meshList
+	// Go through every child node and add its meshes straight to the same list
 	for (size_t i = 0; i < inNode->mNumChildren; i++)
 	{
-		std::vector<Mesh> newList = LoadNode(inPhysicalDevice, inLogicalDevice, inTransferQueue, inTransferCommandPool, inNode->mChildren[i], inScene, inMaterialToTexture);
-		meshList.insert(meshList.end(), newList.begin(), newList.end());
+		LoadNode(inNode->mChildren[i], inScene, outMeshData);
 	}
-
-	return meshList;
 }
 
-Mesh MeshModel::LoadMesh(VkPhysicalDevice inPhysicalDevice, VkDevice inLogicalDevice, VkQueue inTransferQueue, VkCommandPool inTransferCommandPool, aiMesh* inMesh, const aiScene* inScene, std::vector<int> inMaterialToTexture)
+MeshData MeshModel::LoadMesh(aiMesh* inMesh, const aiScene* inScene)
 {
-	std::vector<Vertex> vertices;
-	std::vector<uint32_t> indices;
+	MeshData meshData;
+	std::vector<Vertex>& vertices = meshData.vertices;
+	std::vector<uint32_t>& indices = meshData.indices;
 
 	vertices.resize(inMesh->mNumVertices);
 	for (size_t i = 0; i < inMesh->mNumVertices; i++)
@@ -85,7 +93,8 @@ Mesh MeshModel::LoadMesh(VkPhysicalDevice inPhysicalDevice, VkDevice inLogicalDe
 			vertices[i].texture = { 0.0f, 0.0f };
 	}
 
-	// This is faces (e.g. trangles)
+	// This is faces (e.g. trangles), always 3 indices each after aiProcess_Triangulate
+	indices.reserve(inMesh->mNumFaces * 3);
 	for (size_t i = 0; i < inMesh->mNumFaces; i++)
 	{
 		// Get the face and then get the indices out of it
@@ -96,11 +105,31 @@ Mesh MeshModel::LoadMesh(VkPhysicalDevice inPhysicalDevice, VkDevice inLogicalDe
 		}
 	}
 
-	// TODO: edit constructor to fix this
-	Mesh newMesh = Mesh(inPhysicalDevice, inLogicalDevice, inTransferQueue, inTransferCommandPool, &vertices, &indices);
-	newMesh.SetTextureID(inMaterialToTexture[inMesh->mMaterialIndex]);
+	meshData.BuildQueryData();
+	meshData.materialIndex = inMesh->mMaterialIndex;
+
+	// Only materials that are see through need the alpha blend pipeline
+	aiMaterial* material = inScene->mMaterials[inMesh->mMaterialIndex];
+	float opacity = 1.0f;
+	material->Get(AI_MATKEY_OPACITY, opacity);
+	meshData.alphaBlend = opacity < 1.0f || material->GetTextureCount(aiTextureType_OPACITY) > 0;
+
+	return meshData;
+}
+
+std::vector<Mesh> MeshModel::CreateMeshes(VkPhysicalDevice inPhysicalDevice, VkDevice inLogicalDevice, VkQueue inTransferQueue, VkCommandPool inTransferCommandPool, std::vector<MeshData>& inMeshData, const std::vector<int>& inMaterialToTexture)
+{
+	std::vector<Mesh> meshes;
+	meshes.reserve(inMeshData.size());
+
+	for (MeshData& meshData : inMeshData)
+	{
+		int textureID = inMaterialToTexture[meshData.materialIndex];
+		meshes.push_back(Mesh(inPhysicalDevice, inLogicalDevice, inTransferQueue, inTransferCommandPool, std::move(meshData)));
+		meshes.back().SetTextureID(textureID);
+	}
 
-	return newMesh;
+	return meshes;
 }
 
 size_t MeshModel::GetMeshCount()
@@ -0,0 +1,29 @@
+#include "Engine/Source/Public/Rendering/RenderSnapshot.h"
+
+GUIDrawData::~GUIDrawData()
+{
+	Clear();
+}
+
+void GUIDrawData::CopyFrom(const ImDrawData* _source)
+{
+	Clear();
+	if (_source == nullptr || !_source->Valid)
+		return;
+
+	// The list of pointers is copied with it, then each list is swapped for a clone ImGui does not reuse next frame
+	drawData = *_source;
+	for (int i = 0; i < drawData.CmdListsCount; i++)
+		drawData.CmdLists[i] = _source->CmdLists[i]->CloneOutput();
+
+	// OwnerViewport is left pointing at ImGui's main viewport, the Vulkan backend reads its RendererUserData.
+	// It lives as long as the ImGui context, which outlives the render thread.
+}
+
+void GUIDrawData::Clear()
+{
+	for (ImDrawList* drawList : drawData.CmdLists)
+		IM_DELETE(drawList);
+
+	drawData.Clear();
+}
@@ -0,0 +1,78 @@
+#include "Engine/Source/Public/Rendering/RenderThread.h"
+
+RenderThread::RenderThread(DrawFunction _drawSnapshot)
+	: drawSnapshot(std::move(_drawSnapshot))
+{
+	thread = std::thread(&RenderThread::RenderLoop, this);
+}
+
+RenderThread::~RenderThread()
+{
+	{
+		std::lock_guard<std::mutex> lock(handoffMutex);
+		running = false;
+	}
+	handoffCondition.notify_all();
+
+	thread.join();
+}
+
+void RenderThread::PublishSnapshot()
+{
+	snapshots.GetWriteBuffer().simulationFrame = ++publishedCount;
+
+	if (!threaded)
+	{
+		// Serial frame, publish and draw it right away. The frame lock keeps the render thread out of the way.
+		std::unique_lock<std::mutex> frameLock(frameMutex);
+		snapshots.Publish();
+		DrawPendingSnapshot();
+		return;
+	}
+
+	// Replacing a snapshot the render thread has not taken would throw away a whole simulated frame, and it keeps
+	// the simulation from running ahead of rendering
+	FrameTimeline::Clock::time_point handoffStart = FrameTimeline::Now();
+	{
+		std::unique_lock<std::mutex> lock(handoffMutex);
+		handoffCondition.wait(lock, [this]() { return !snapshots.HasPending(); });
+		snapshots.Publish();
+	}
+	handoffCondition.notify_all();
+	frameTimeline.Record(PHASE_HANDOFF, handoffStart);
+}
+
+void RenderThread::RenderLoop()
+{
+	while (true)
+	{
+		FrameTimeline::Clock::time_point idleStart = FrameTimeline::Now();
+		{
+			std::unique_lock<std::mutex> lock(handoffMutex);
+			handoffCondition.wait(lock, [this]() { return !running || snapshots.HasPending(); });
+			if (!running)
+				return;
+		}
+		frameTimeline.Record(PHASE_RENDER_IDLE, idleStart);
+
+		std::unique_lock<std::mutex> frameLock(frameMutex);
+		DrawPendingSnapshot();
+	}
+}
+
+void RenderThread::DrawPendingSnapshot()
+{
+	// Someone holding the frame lock before us may have drawn or discarded it already
+	if (!snapshots.Acquire())
+		return;
+
+	// The simulation thread may be waiting to publish the next one. Taking the lock means it is either already
+	// waiting and gets the notify, or has not checked yet and will see the snapshot is gone.
+	{
+		std::lock_guard<std::mutex> lock(handoffMutex);
+	}
+	handoffCondition.notify_all();
+
+	drawSnapshot(snapshots.GetReadBuffer());
+	frameTimeline.EndFrame();
+}
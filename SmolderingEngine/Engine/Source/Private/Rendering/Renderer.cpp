@@ -4,6 +4,11 @@
 #include "Engine/Source/Public/Rendering/SkyboxRenderer.h"
 #include "Engine/Source/Public/Rendering/EngineGUIRenderer.h"
 #include "Engine/Source/Public/Rendering/LevelRenderer.h"
+#include "Engine/Source/Public/Rendering/FrameProfiler.h"
+#include "Engine/Source/Public/Rendering/DeletionQueue.h"
+#include "Engine/Source/Public/Rendering/RenderSnapshot.h"
+#include "Engine/Source/Public/Rendering/FrameTimeline.h"
+#include "Engine/Source/Public/Rendering/RenderThread.h"
 
 #include "Engine/Source/Public/Camera/Camera.h"
 #include "Engine/Source/Public/EngineLevel/EngineLevelManager.h"
@@ -11,6 +16,12 @@
 Renderer::Renderer(GLFWwindow* _window, Camera* _camera)
 	: window(_window), seCamera(_camera)
 {
+	// Time how long startup takes so cold (no pipeline cache) and warm launches can be compared
+	auto startupStartTime = std::chrono::high_resolution_clock::now();
+
+	// The swapchain is made for this size, later sizes come in with each snapshot
+	glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+
 	try
 	{
 		vulkanResources = new VulkanResources();
@@ -22,6 +33,8 @@ Renderer::Renderer(GLFWwindow* _window, Camera* _camera)
 		CreateVulkanSurface();
 		RetrievePhysicalDevice();
 		CreateLogicalDevice();
+		vulkanResources->deletionQueue = new DeletionQueue(vulkanResources->logicalDevice);
+		CreatePipelineCache();
 		CreateSwapChain();
 		CreateRenderpass();
 		CreateDepthBufferImage();
@@ -29,6 +42,8 @@ Renderer::Renderer(GLFWwindow* _window, Camera* _camera)
 		CreateCommandPool();
 		AllocateCommandBuffers();
 		CreateSynchronizationPrimatives();
+
+		seFrameProfiler = new FrameProfiler(vulkanResources, static_cast<uint32_t>(GetQueueFamilies(vulkanResources->physicalDevice).graphicsFamily));
 	}
 	catch (const std::runtime_error& error)
 	{
@@ -53,26 +68,75 @@ Renderer::Renderer(GLFWwindow* _window, Camera* _camera)
 	ImGui_ImplGlfw_InitForVulkan(window, true);
 	seEngineGUIRenderer = new EngineGUIRenderer(vulkanResources);
 	// --- CREATE ENGINE GUI RENDERER ---
+
+	std::chrono::duration<double, std::milli> startupTime = std::chrono::high_resolution_clock::now() - startupStartTime;
+	std::cout << "Renderer startup took " << startupTime.count() << "ms (pipeline cache "
+		<< (pipelineCacheLoadedFromFile ? "warm" : "cold") << ")" << std::endl;
+}
+
+void Renderer::PrepareSnapshot(RenderSnapshot& _snapshot)
+{
+	// Act on what was clicked last frame (loading a level, destroying an object) before the level is copied
+	seEngineGUIRenderer->ProcessEngineGUIInputs();
+
+	glfwGetFramebufferSize(window, &_snapshot.framebufferWidth, &_snapshot.framebufferHeight);
+	_snapshot.depthPrePassBenchmarkFrames = 0;
+
+	// The GUI can move objects and change settings, so it is built before anything else is copied
+	seEngineGUIRenderer->BuildFrame(_snapshot);
+
+	_snapshot.depthPrePass = depthPrePassEnabled;
+	_snapshot.viewProjection = seCamera->uboViewProjection;
+	seLevelRenderer->CollectInstances(_snapshot.instances);
+	seLevelRenderer->CollectTextures(_snapshot.textureDescriptorSets, _snapshot.textureTransparency);
 }
 
-void Renderer::Draw()
+void Renderer::Draw(const RenderSnapshot& _snapshot)
 {
+	// Follow the window size the simulation thread saw
+	ResizeRenderer(_snapshot.framebufferWidth, _snapshot.framebufferHeight);
+
+	FrameTimeline::Clock::time_point frameWaitStart = FrameTimeline::Now();
+
 	// Wait for given fence to signal/open from last draw call before continuing
 	vkWaitForFences(vulkanResources->logicalDevice, 1, &drawFences[currentFrame], VK_TRUE , std::numeric_limits<uint64_t>::max());
-	// Reset/close the fence again as we work on this new draw call.
-	vkResetFences(vulkanResources->logicalDevice, 1, &drawFences[currentFrame]);
 
-	// Process any GUI inputs prior to rendering
-	seEngineGUIRenderer->ProcessEngineGUIInputs();
+	// Any swapchain retired MAX_FRAME_DRAWS frames ago is no longer referenced by the GPU, nor is anything else released then
+	DestroyRetiredSwapchains(false);
+	{
+		// Other threads release into the deletion queue and allocate from the descriptor pools it frees back to
+		std::unique_lock<std::mutex> deviceLock = seRenderThread->LockDevice();
+		vulkanResources->deletionQueue->BeginFrame(frameNumber);
+	}
+
+	// This frame's queries from MAX_FRAME_DRAWS frames ago are finished, read them before they are reset
+	seFrameProfiler->CollectResults(currentFrame);
 
 	// Aquire the next image we want to draw
 	uint32_t ImageIndex;
 	VkResult Result = vkAcquireNextImageKHR(vulkanResources->logicalDevice, vulkanResources->swapchain, std::numeric_limits<uint64_t>::max(), imageAvailableSemaphores[currentFrame], VK_NULL_HANDLE, &ImageIndex);
-	if (Result != VK_SUCCESS)
+	if (Result == VK_ERROR_OUT_OF_DATE_KHR)
+	{
+		// Nothing was submitted this frame so the fence is still signaled, rebuild and try again next frame
+		swapchainOutOfDate = true;
+		RecreateSwapchain();
+		return;
+	}
+	else if (Result == VK_SUBOPTIMAL_KHR)
+		swapchainOutOfDate = true;	// Image was still acquired, draw it and recreate after presenting
+	else if (Result != VK_SUCCESS)
 		throw std::runtime_error("Failed to acquire next image!");
 
+	seFrameTimeline->Record(PHASE_FRAME_WAIT, frameWaitStart);
+
+	// Reset/close the fence again as we work on this new draw call. Only done once we know we will submit.
+	vkResetFences(vulkanResources->logicalDevice, 1, &drawFences[currentFrame]);
+
 	// Record commands for all renderers
-	RecordCommands(ImageIndex);
+	FrameTimeline::Clock::time_point recordStart = FrameTimeline::Now();
+	RecordCommands(ImageIndex, _snapshot);
+	seFrameTimeline->Record(PHASE_RECORD, recordStart);
+	FrameTimeline::Clock::time_point submitStart = FrameTimeline::Now();
 
 	// Submit the command buffer we want to render
 	VkSubmitInfo SubmitInfo = {};
@@ -85,14 +149,10 @@ void Renderer::Draw()
 	};
 	SubmitInfo.pWaitDstStageMask = WaitStages;
 	SubmitInfo.commandBufferCount = 1;
-	SubmitInfo.pCommandBuffers = &commandBuffers[ImageIndex];
+	SubmitInfo.pCommandBuffers = &commandBuffers[currentFrame];
 	SubmitInfo.signalSemaphoreCount = 1;
 	SubmitInfo.pSignalSemaphores = &renderingCompleteSemaphores[currentFrame];
 
-	Result = vkQueueSubmit(vulkanResources->graphicsQueue, 1, &SubmitInfo, drawFences[currentFrame]);
-	if (Result != VK_SUCCESS)
-		throw std::runtime_error("Failed to submit command buffer to queue!");
-
 	// Present the image to the screen when it has signaled it has finished rendering
 	VkPresentInfoKHR PresentInfo = {};
 	PresentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
@@ -102,11 +162,28 @@ void Renderer::Draw()
 	PresentInfo.pSwapchains = &vulkanResources->swapchain;
 	PresentInfo.pImageIndices = &ImageIndex;
 
-	Result = vkQueuePresentKHR(presentationQueue, &PresentInfo);
-	if (Result != VK_SUCCESS)
+	{
+		// Uploads submit to the same queue from the main thread, it is only held for the submit and present
+		std::unique_lock<std::mutex> deviceLock = seRenderThread->LockDevice();
+
+		Result = vkQueueSubmit(vulkanResources->graphicsQueue, 1, &SubmitInfo, drawFences[currentFrame]);
+		if (Result != VK_SUCCESS)
+			throw std::runtime_error("Failed to submit command buffer to queue!");
+
+		Result = vkQueuePresentKHR(presentationQueue, &PresentInfo);
+	}
+	if (Result == VK_ERROR_OUT_OF_DATE_KHR || Result == VK_SUBOPTIMAL_KHR)
+		swapchainOutOfDate = true;
+	else if (Result != VK_SUCCESS)
 		throw std::runtime_error("Failed to present image!");
 
 	currentFrame = (currentFrame + 1) % MAX_FRAME_DRAWS;
+	frameNumber++;
+
+	if (swapchainOutOfDate)
+		RecreateSwapchain();
+
+	seFrameTimeline->Record(PHASE_SUBMIT, submitStart);
 }
 
 void Renderer::DestroyRenderer()
@@ -115,6 +192,7 @@ void Renderer::DestroyRenderer()
 	vkDeviceWaitIdle(vulkanResources->logicalDevice);
 
 	// Destroy other renderers first
+	seFrameProfiler->DestroyFrameProfiler();
 	seEngineGUIRenderer->DestroyEngineGUIRenderer();
 	seLevelRenderer->DestroyLevelRenderer();
 	seSkyboxRenderer->DestroySkyboxRenderer();
@@ -122,6 +200,11 @@ void Renderer::DestroyRenderer()
 	// Destroy game objects 
 	//seLevelManager->DestroyGameMeshes();
 
+	// Device is idle so every retired swapchain and released resource can go now
+	DestroyRetiredSwapchains(true);
+	vulkanResources->deletionQueue->DestroyAll();
+	delete(vulkanResources->deletionQueue);
+
 	// Destroy all general vulkan stuffz
 	vkDestroyImageView(vulkanResources->logicalDevice, depthBufferImageView, nullptr);
 	vkDestroyImage(vulkanResources->logicalDevice, depthBufferImage, nullptr);
@@ -134,8 +217,13 @@ void Renderer::DestroyRenderer()
 		vkDestroyFence(vulkanResources->logicalDevice, drawFences[i], nullptr);
 	}
 
+	vkDestroyCommandPool(vulkanResources->logicalDevice, vulkanResources->uploadCommandPool, nullptr);
 	vkDestroyCommandPool(vulkanResources->logicalDevice, vulkanResources->graphicsCommandPool, nullptr);
 
+	// Save the pipeline cache before it is destroyed so the next launch starts warm
+	SavePipelineCache();
+	vkDestroyPipelineCache(vulkanResources->logicalDevice, vulkanResources->pipelineCache, nullptr);
+
 	for (auto framebuffer : swapchainFramebuffers)
 		vkDestroyFramebuffer(vulkanResources->logicalDevice, framebuffer, nullptr);
 
@@ -243,6 +331,11 @@ void Renderer::CreateLogicalDevice()
 	// Features on physical device that the logical device will use.
 	VkPhysicalDeviceFeatures PhysicalDeviceFeatures = {};
 	PhysicalDeviceFeatures.samplerAnisotropy = VK_TRUE;		// Enable Anisotropy
+
+	// Optional, only used by the FrameProfiler to count fragment shader invocations
+	VkPhysicalDeviceFeatures SupportedFeatures;
+	vkGetPhysicalDeviceFeatures(vulkanResources->physicalDevice, &SupportedFeatures);
+	PhysicalDeviceFeatures.pipelineStatisticsQuery = SupportedFeatures.pipelineStatisticsQuery;
 	DeviceCreateInfo.pEnabledFeatures = &PhysicalDeviceFeatures;
 
 	VkResult Result = vkCreateDevice(vulkanResources->physicalDevice, &DeviceCreateInfo, nullptr, &vulkanResources->logicalDevice);
@@ -264,7 +357,7 @@ void Renderer::CreateVulkanSurface()
 		throw std::runtime_error("Failed to create a presentation surface!");
 }
 
-void Renderer::CreateSwapChain()
+void Renderer::CreateSwapChain(VkSwapchainKHR _oldSwapchain)
 {
 	SwapchainDetails SwapchainInfo = GetSwapchainDetails(vulkanResources->physicalDevice);
 
@@ -314,7 +407,7 @@ void Renderer::CreateSwapChain()
 	SwapchainCreateInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;					// How to handle blending other windows over this application
 	SwapchainCreateInfo.presentMode = PresentationMode;
 	SwapchainCreateInfo.clipped = VK_TRUE;													// Wether to clip parts of image behind other windows / off screen.
-	SwapchainCreateInfo.oldSwapchain = VK_NULL_HANDLE;
+	SwapchainCreateInfo.oldSwapchain = _oldSwapchain;										// Lets the driver hand resources over from the swapchain being replaced
 
 	VkResult Result = vkCreateSwapchainKHR(vulkanResources->logicalDevice, &SwapchainCreateInfo, nullptr, &vulkanResources->swapchain);
 
@@ -470,7 +563,8 @@ void Renderer::CreateFramebuffers()
 
 void Renderer::AllocateCommandBuffers()
 {
-	commandBuffers.resize(swapchainFramebuffers.size());
+	// One per frame in flight, not per swapchain image, so the count never changes when the swapchain is rebuilt
+	commandBuffers.resize(MAX_FRAME_DRAWS);
 
 	/*
 	VkStructureType         sType;
@@ -510,6 +604,13 @@ void Renderer::CreateCommandPool()
 
 	if (result != VK_SUCCESS)
 		throw std::runtime_error("Failed to create a command pool!");
+
+	// Uploads allocate from their own pool so they never touch the one the render thread records from
+	commandPoolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+	result = vkCreateCommandPool(vulkanResources->logicalDevice, &commandPoolInfo, nullptr, &vulkanResources->uploadCommandPool);
+
+	if (result != VK_SUCCESS)
+		throw std::runtime_error("Failed to create the upload command pool!");
 }
 
 void Renderer::CreateSynchronizationPrimatives()
@@ -534,6 +635,65 @@ void Renderer::CreateSynchronizationPrimatives()
 	}
 }
 
+void Renderer::CreatePipelineCache()
+{
+	std::vector<char> cacheData;
+
+	// A missing cache file is normal (first launch), so only read it if it exists
+	std::ifstream file(pipelineCacheFilePath, std::ios::binary | std::ios::ate);
+	if (file.is_open())
+	{
+		cacheData.resize(static_cast<size_t>(file.tellg()));
+		file.seekg(0);
+		file.read(cacheData.data(), cacheData.size());
+		file.close();
+
+		// Cache data from another GPU or driver version can not be used, start with an empty cache instead
+		if (!IsPipelineCacheDataValid(cacheData))
+		{
+			std::cout << "Pipeline cache file does not match this device, it will be rebuilt." << std::endl;
+			cacheData.clear();
+		}
+	}
+
+	VkPipelineCacheCreateInfo pipelineCacheCreateInfo = {};
+	pipelineCacheCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+	pipelineCacheCreateInfo.initialDataSize = cacheData.size();
+	pipelineCacheCreateInfo.pInitialData = cacheData.empty() ? nullptr : cacheData.data();
+
+	VkResult result = vkCreatePipelineCache(vulkanResources->logicalDevice, &pipelineCacheCreateInfo, nullptr, &vulkanResources->pipelineCache);
+	if (result != VK_SUCCESS)
+		throw std::runtime_error("Failed to create a pipeline cache!");
+
+	pipelineCacheLoadedFromFile = !cacheData.empty();
+}
+
+void Renderer::SavePipelineCache()
+{
+	size_t cacheSize = 0;
+	VkResult result = vkGetPipelineCacheData(vulkanResources->logicalDevice, vulkanResources->pipelineCache, &cacheSize, nullptr);
+	if (result != VK_SUCCESS || cacheSize == 0)
+		return;
+
+	std::vector<char> cacheData(cacheSize);
+	result = vkGetPipelineCacheData(vulkanResources->logicalDevice, vulkanResources->pipelineCache, &cacheSize, cacheData.data());
+	if (result != VK_SUCCESS)
+		return;
+
+	// Make sure the cache folder exists before writing to it
+	std::filesystem::create_directories(std::filesystem::path(pipelineCacheFilePath).parent_path());
+
+	std::ofstream file(pipelineCacheFilePath, std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		std::cout << "Failed to save the pipeline cache to: " << pipelineCacheFilePath << std::endl;
+		return;
+	}
+
+	file.write(cacheData.data(), cacheSize);
+	file.close();
+}
+
 void Renderer::RetrievePhysicalDevice()
 {
 	uint32_t deviceCount = 0;
@@ -649,6 +809,25 @@ bool Renderer::CheckDeviceExtentionSupport(VkPhysicalDevice InPhysicalDevice)
 	return true;
 }
 
+bool Renderer::IsPipelineCacheDataValid(const std::vector<char>& _cacheData)
+{
+	if (_cacheData.size() < sizeof(VkPipelineCacheHeaderVersionOne))
+		return false;
+
+	VkPipelineCacheHeaderVersionOne header = {};
+	memcpy(&header, _cacheData.data(), sizeof(VkPipelineCacheHeaderVersionOne));
+
+	VkPhysicalDeviceProperties deviceProperties;
+	vkGetPhysicalDeviceProperties(vulkanResources->physicalDevice, &deviceProperties);
+
+	// The header tells us which GPU + driver made the cache, all of it has to match this device
+	return header.headerSize >= sizeof(VkPipelineCacheHeaderVersionOne)
+		&& header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+		&& header.vendorID == deviceProperties.vendorID
+		&& header.deviceID == deviceProperties.deviceID
+		&& memcmp(header.pipelineCacheUUID, deviceProperties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
 bool Renderer::CheckValidationLayerSupport()
 {
 	// Check all layers that are supported on this PC
@@ -758,16 +937,28 @@ VkImageView Renderer::CreateImageView(VkImage InImage, VkFormat InFormat, VkImag
 	return ImageView;
 }
 
-void Renderer::RecordCommands(uint32_t _imageIndex)
+void Renderer::RecordCommands(uint32_t _imageIndex, const RenderSnapshot& _snapshot)
 {
+	// Command buffers are per frame in flight, the fence waited on in Draw guarantees this one is no longer in use
+	VkCommandBuffer commandBuffer = commandBuffers[currentFrame];
+
 	VkCommandBufferBeginInfo bufferBeginInfo = {};
 	bufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
 
 	// Start recording
-	VkResult result = vkBeginCommandBuffer(commandBuffers[_imageIndex],&bufferBeginInfo);
+	VkResult result = vkBeginCommandBuffer(commandBuffer,&bufferBeginInfo);
 	if (result != VK_SUCCESS)
 		throw std::runtime_error("Failed to start recording a command buffer!");
 
+	// The depth pre-pass benchmark overrides the user's setting while it runs
+	if (_snapshot.depthPrePassBenchmarkFrames > 0)
+		seFrameProfiler->StartDepthPrePassBenchmark(_snapshot.depthPrePassBenchmarkFrames);
+	bool useDepthPrePass = _snapshot.depthPrePass;
+	seFrameProfiler->GetBenchmarkDepthPrePass(&useDepthPrePass);
+
+	// Queries have to be reset outside of the render pass
+	seFrameProfiler->ResetQueries(commandBuffer, currentFrame, useDepthPrePass);
+
 	// Info on how to begin a render pass
 	VkRenderPassBeginInfo renderPassBeginInfo = {};
 	renderPassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
@@ -784,26 +975,61 @@ void Renderer::RecordCommands(uint32_t _imageIndex)
 	renderPassBeginInfo.framebuffer = swapchainFramebuffers[_imageIndex];
 
 	// start the render pass
-	vkCmdBeginRenderPass(commandBuffers[_imageIndex], &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+	vkCmdBeginRenderPass(commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+	// Viewport and scissor are dynamic pipeline state, so they follow the swapchain size without rebuilding any pipelines
+	VkViewport viewport = {};
+	viewport.x = 0.0f;
+	viewport.y = 0.0f;
+	viewport.width = (float)vulkanResources->swapchainExtent.width;
+	viewport.height = (float)vulkanResources->swapchainExtent.height;
+	viewport.minDepth = 0.0f;
+	viewport.maxDepth = 1.0f;
+	vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+	VkRect2D scissor = {};
+	scissor.offset = { 0, 0 };
+	scissor.extent = vulkanResources->swapchainExtent;
+	vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
 
 	/*
 	The order we want to draw is:
-	1- Skybox
-	2- Level
-	3- GUI
+	1- Level depth pre-pass (optional)
+	2- Level opaque
+	3- Skybox (at max depth, so only pixels nothing else covered get shaded)
+	4- Level transparent
+	5- GUI
 	*/
-	seSkyboxRenderer->UpdateUniformBuffer(seCamera, _imageIndex);
-	seSkyboxRenderer->RecordToCommandBuffer(commandBuffers[_imageIndex], _imageIndex);
+	// Uniform buffers are indexed by frame in flight rather than swapchain image, so they stay valid if the image count changes on resize
+	seSkyboxRenderer->UpdateUniformBuffer(_snapshot.viewProjection, currentFrame);
+	seLevelRenderer->UpdateUniformBuffer(_snapshot.viewProjection, currentFrame);
+	seLevelRenderer->PrepareDrawCommands(_snapshot, useDepthPrePass);
+
+	seFrameProfiler->WriteTimestamp(commandBuffer, currentFrame, TIMESTAMP_SCENE_BEGIN);
+	seFrameProfiler->BeginStatistics(commandBuffer, currentFrame);
 
-	seLevelRenderer->UpdateUniformBuffer(seCamera, _imageIndex);
-	seLevelRenderer->RecordToCommandBuffer(commandBuffers[_imageIndex], _imageIndex);
+	if (useDepthPrePass)
+		seLevelRenderer->RecordDepthPrePass(commandBuffer, currentFrame);
+	seFrameProfiler->WriteTimestamp(commandBuffer, currentFrame, TIMESTAMP_DEPTH_PREPASS_END);
 
-	seEngineGUIRenderer->RecordToCommandBuffer(commandBuffers[_imageIndex], _imageIndex);
+	seLevelRenderer->RecordOpaqueToCommandBuffer(commandBuffer, currentFrame);
+	seFrameProfiler->WriteTimestamp(commandBuffer, currentFrame, TIMESTAMP_OPAQUE_END);
 
-	vkCmdEndRenderPass(commandBuffers[_imageIndex]);
+	seSkyboxRenderer->RecordToCommandBuffer(commandBuffer, currentFrame);
+	seFrameProfiler->WriteTimestamp(commandBuffer, currentFrame, TIMESTAMP_SKYBOX_END);
+
+	seLevelRenderer->RecordTransparentToCommandBuffer(commandBuffer, currentFrame);
+	seFrameProfiler->WriteTimestamp(commandBuffer, currentFrame, TIMESTAMP_TRANSPARENT_END);
+
+	// GUI is left out of the statistics so they only show the cost of the scene
+	seFrameProfiler->EndStatistics(commandBuffer, currentFrame);
+
+	seEngineGUIRenderer->RecordToCommandBuffer(commandBuffer, currentFrame, _snapshot.gui);
+
+	vkCmdEndRenderPass(commandBuffer);
 
 	// Stop recording
-	result = vkEndCommandBuffer(commandBuffers[_imageIndex]);
+	result = vkEndCommandBuffer(commandBuffer);
 	if (result != VK_SUCCESS)
 		throw std::runtime_error("Failed to stop recording a command buffer!");
 }
@@ -879,12 +1105,9 @@ VkExtent2D Renderer::ChooseSwapChainExtent(const VkSurfaceCapabilitiesKHR& InSur
 	else
 	{
 		// Otherwise we need to set size of window manually
-		int width, height;
-		glfwGetFramebufferSize(window, &width, &height);
-
 		VkExtent2D NewExtent = {};
-		NewExtent.width = static_cast<uint32_t>(width);
-		NewExtent.height = static_cast<uint32_t>(height);
+		NewExtent.width = static_cast<uint32_t>(framebufferWidth);
+		NewExtent.height = static_cast<uint32_t>(framebufferHeight);
 
 		// Make sure we are not larger than the max or min set by surface
 		NewExtent.width = std::max(InSurfaceCapabilities.minImageExtent.width, std::min(InSurfaceCapabilities.maxImageExtent.width, NewExtent.width));
@@ -988,39 +1211,80 @@ void Renderer::SetupDebugMessenger()
 
 void Renderer::ResizeRenderer(int inWidth, int inHeight)
 {
-	// Wait for commands to finish
-	vkDeviceWaitIdle(vulkanResources->logicalDevice);
-
-	// Destroy Depth Buffer stuff
-	vkDestroyImageView(vulkanResources->logicalDevice, depthBufferImageView, nullptr);
-	vkDestroyImage(vulkanResources->logicalDevice, depthBufferImage, nullptr);
-	vkFreeMemory(vulkanResources->logicalDevice, depthBufferImageMemory, nullptr);
-
-	// Destroy Frame Buffers
-	for (auto framebuffer : swapchainFramebuffers)
-		vkDestroyFramebuffer(vulkanResources->logicalDevice, framebuffer, nullptr);
-
-	// Destroy the Swapchain Images
-	for (auto image : vulkanResources->swapchainImages)
-		vkDestroyImageView(vulkanResources->logicalDevice, image.imageView, nullptr);
-
-	// Destroy the Swapchain
-	vkDestroySwapchainKHR(vulkanResources->logicalDevice, vulkanResources->swapchain, nullptr);
+	// Minimized windows report a 0x0 framebuffer, a swapchain can not be made that small
+	if (inWidth == 0 || inHeight == 0)
+		return;
+
+	// Called every frame with the snapshot's size, nothing to do unless it changed
+	if (inWidth == framebufferWidth && inHeight == framebufferHeight)
+		return;
+	framebufferWidth = inWidth;
+	framebufferHeight = inHeight;
+
+	// Draw may have already rebuilt the swapchain for this size after being told it was out of date
+	if (!swapchainOutOfDate && vulkanResources->swapchainExtent.width == static_cast<uint32_t>(inWidth)
+		&& vulkanResources->swapchainExtent.height == static_cast<uint32_t>(inHeight))
+		return;
+
+	RecreateSwapchain();
+}
 
-	// Clear vectors that are now holding nullptrs
+void Renderer::RecreateSwapchain()
+{
+	if (framebufferWidth == 0 || framebufferHeight == 0)
+		return;
+
+	// Frames still in flight reference the current swapchain, framebuffers and depth buffer, so hand them to the
+	// retired list instead of waiting for the device to go idle. They are destroyed once those frames have finished.
+	RetiredSwapchain retired = {};
+	retired.swapchain = vulkanResources->swapchain;
+	retired.swapchainImages = vulkanResources->swapchainImages;
+	retired.framebuffers = swapchainFramebuffers;
+	retired.depthBufferImage = depthBufferImage;
+	retired.depthBufferImageMemory = depthBufferImageMemory;
+	retired.depthBufferImageView = depthBufferImageView;
+	retired.retiredFrameNumber = frameNumber;
+
+	// Clear vectors that now belong to the retired swapchain
 	vulkanResources->swapchainImages.clear();
 	swapchainFramebuffers.clear();
 
-	// re-create them all
-	CreateSwapChain();
+	// re-create them all, passing the old swapchain so presentation can carry on during the handoff
+	CreateSwapChain(retired.swapchain);
 	CreateDepthBufferImage();
 	CreateFramebuffers();
 
-	// Do the same for the other renderers 
-	seSkyboxRenderer->ResizeRenderer();
-	seLevelRenderer->ResizeRenderer();
+	retiredSwapchains.push_back(retired);
+	swapchainOutOfDate = false;
+
+	// NOTE: The other renderers do not need to be resized, their viewport and scissor are dynamic state
+}
 
-	// NOTE: seEngineGUIRenderer->Resize() Is not needed, ImGUI is smart AF
+void Renderer::DestroyRetiredSwapchains(bool _destroyAll)
+{
+	for (auto it = retiredSwapchains.begin(); it != retiredSwapchains.end();)
+	{
+		// Each frame in flight has waited on its fence by the time it comes back around
+		if (!_destroyAll && frameNumber < it->retiredFrameNumber + MAX_FRAME_DRAWS)
+		{
+			++it;
+			continue;
+		}
+
+		vkDestroyImageView(vulkanResources->logicalDevice, it->depthBufferImageView, nullptr);
+		vkDestroyImage(vulkanResources->logicalDevice, it->depthBufferImage, nullptr);
+		vkFreeMemory(vulkanResources->logicalDevice, it->depthBufferImageMemory, nullptr);
+
+		for (auto framebuffer : it->framebuffers)
+			vkDestroyFramebuffer(vulkanResources->logicalDevice, framebuffer, nullptr);
+
+		for (auto image : it->swapchainImages)
+			vkDestroyImageView(vulkanResources->logicalDevice, image.imageView, nullptr);
+
+		vkDestroySwapchainKHR(vulkanResources->logicalDevice, it->swapchain, nullptr);
+
+		it = retiredSwapchains.erase(it);
+	}
 }
 
 VKAPI_ATTR VkBool32 VKAPI_CALL Renderer::DebugCallback(VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity, VkDebugUtilsMessageTypeFlagsEXT messageType, const VkDebugUtilsMessengerCallbackDataEXT* pCallbackData, void* pUserData)
@@ -6,8 +6,6 @@
 // Project Includes
 #include "Engine/Source/Public/Rendering/Utilities.h"
 
-#include "Engine/Source/Public/Camera/Camera.h"
-
 SkyboxRenderer::SkyboxRenderer()
 {
 	CreateSkyboxVertices();
@@ -70,8 +68,19 @@ void SkyboxRenderer::DestroySkyboxRenderer()
 }
 
 
-void SkyboxRenderer::RecordToCommandBuffer(VkCommandBuffer _commandBuffer, uint32_t _imageIndex)
+void SkyboxRenderer::RecordToCommandBuffer(VkCommandBuffer _commandBuffer, uint32_t _frameIndex)
 {
+	// Skybox is drawn after opaque geometry, forcing its depth to the far plane means LESS_OR_EQUAL only passes
+	// where nothing has been drawn yet, so covered pixels are rejected by early-Z instead of being shaded twice
+	VkViewport viewport = {};
+	viewport.x = 0.0f;
+	viewport.y = 0.0f;
+	viewport.width = (float)vulkanResources->swapchainExtent.width;
+	viewport.height = (float)vulkanResources->swapchainExtent.height;
+	viewport.minDepth = 1.0f;
+	viewport.maxDepth = 1.0f;
+	vkCmdSetViewport(_commandBuffer, 0, 1, &viewport);
+
 	// Bind the skybox pipeline
 	vkCmdBindPipeline(_commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, cubemapGraphicsPipeline);
 
@@ -82,18 +91,23 @@ void SkyboxRenderer::RecordToCommandBuffer(VkCommandBuffer _commandBuffer, uint3
 
 	// Bind descriptor sets (using the skybox pipeline layout)
 	vkCmdBindDescriptorSets(_commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, cubemapPipelineLayout,
-		0, 1, &cubemapUBODescriptorSets[_imageIndex], 0, nullptr); // Set 0
+		0, 1, &cubemapUBODescriptorSets[_frameIndex], 0, nullptr); // Set 0
 	vkCmdBindDescriptorSets(_commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, cubemapPipelineLayout,
 		1, 1, &cubemapSamplerDescriptorSet, 0, nullptr); // Set 1 remains the same if texture doesn't change
 
 	// Draw the skybox cube
 	vkCmdDraw(_commandBuffer, static_cast<uint32_t>(skyboxVertices.size()), 1, 0, 0);
+
+	// Put the full depth range back for anything drawn after the skybox
+	viewport.minDepth = 0.0f;
+	viewport.maxDepth = 1.0f;
+	vkCmdSetViewport(_commandBuffer, 0, 1, &viewport);
 }
 
-void SkyboxRenderer::UpdateUniformBuffer(const Camera* _camera, uint32_t _imageIndex)
+void SkyboxRenderer::UpdateUniformBuffer(const UniformBufferObjectViewProjection& _viewProjection, uint32_t _frameIndex)
 {
 	// Make local copies of the camera's matrices
-	UniformBufferObjectViewProjection ubo = _camera->uboViewProjection;
+	UniformBufferObjectViewProjection ubo = _viewProjection;
 
 	// Modify the view matrix to remove translation
 	ubo.view[3][0] = 0.0f;
@@ -102,17 +116,9 @@ void SkyboxRenderer::UpdateUniformBuffer(const Camera* _camera, uint32_t _imageI
 
 	// Copy the modified data to the uniform buffer
 	void* data;
-	vkMapMemory(vulkanResources->logicalDevice, cubemapUniformBufferMemories[_imageIndex], 0, sizeof(ubo), 0, &data);
+	vkMapMemory(vulkanResources->logicalDevice, cubemapUniformBufferMemories[_frameIndex], 0, sizeof(ubo), 0, &data);
 	memcpy(data, &ubo, sizeof(ubo));
-	vkUnmapMemory(vulkanResources->logicalDevice, cubemapUniformBufferMemories[_imageIndex]);
-}
-
-void SkyboxRenderer::ResizeRenderer()
-{
-	vkDestroyPipelineLayout(vulkanResources->logicalDevice, cubemapPipelineLayout, nullptr);
-	vkDestroyPipeline(vulkanResources->logicalDevice, cubemapGraphicsPipeline, nullptr);
-
-	CreateCubemapGraphicsPipeline();
+	vkUnmapMemory(vulkanResources->logicalDevice, cubemapUniformBufferMemories[_frameIndex]);
 }
 
 void SkyboxRenderer::CreateCubemapTextureSampler()
@@ -179,10 +185,11 @@ void SkyboxRenderer::CreateCubemapUniformBuffer()
 {
 	VkDeviceSize bufferSize = sizeof(UniformBufferObjectViewProjection);
 
-	cubemapUniformBuffers.resize(vulkanResources->swapchainImages.size());
-	cubemapUniformBufferMemories.resize(vulkanResources->swapchainImages.size());
+	// One per frame in flight, they are written and bound by currentFrame rather than by swapchain image
+	cubemapUniformBuffers.resize(MAX_FRAME_DRAWS);
+	cubemapUniformBufferMemories.resize(MAX_FRAME_DRAWS);
 
-	for (size_t i = 0; i < vulkanResources->swapchainImages.size(); i++)
+	for (size_t i = 0; i < MAX_FRAME_DRAWS; i++)
 	{
 		CreateBuffer(vulkanResources->physicalDevice, vulkanResources->logicalDevice, bufferSize,
 			VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
@@ -209,7 +216,7 @@ void SkyboxRenderer::CreateCubemapDescriptorPool()
 	// Create UBO descriptor pool
 	VkDescriptorPoolSize uboPoolSize = {};
 	uboPoolSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-	uboPoolSize.descriptorCount = vulkanResources->swapchainImages.size();
+	uboPoolSize.descriptorCount = MAX_FRAME_DRAWS;
 
 	VkDescriptorPoolSize samplerPoolSize = {};
 	samplerPoolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
@@ -221,7 +228,7 @@ void SkyboxRenderer::CreateCubemapDescriptorPool()
 	poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
 	poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
 	poolInfo.pPoolSizes = poolSizes.data();
-	poolInfo.maxSets = static_cast<uint32_t>(vulkanResources->swapchainImages.size() + 1); // +1 for the sampler descriptor set
+	poolInfo.maxSets = static_cast<uint32_t>(MAX_FRAME_DRAWS + 1); // +1 for the sampler descriptor set
 
 	if (vkCreateDescriptorPool(vulkanResources->logicalDevice, &poolInfo, nullptr, &cubemapUBODescriptorPool) != VK_SUCCESS)
 		throw std::runtime_error("failed to create cubemap descriptor pool!");
@@ -278,32 +285,20 @@ void SkyboxRenderer::CreateCubemapGraphicsPipeline()
 	cubemapInputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
 	cubemapInputAssembly.primitiveRestartEnable = VK_FALSE;
 
-	// Define the Viewport and Scissor 
-	VkViewport cubemapViewport = {};
-	cubemapViewport.x = 0.0f;
-	cubemapViewport.y = 0.0f;
-	cubemapViewport.width = (float)vulkanResources->swapchainExtent.width;
-	cubemapViewport.height = (float)vulkanResources->swapchainExtent.height;
-	cubemapViewport.minDepth = 0.0f;
-	cubemapViewport.maxDepth = 1.0f;
-
-	VkRect2D cubemapScissor = {};
-	cubemapScissor.offset = { 0,0 };
-	cubemapScissor.extent = vulkanResources->swapchainExtent;
-
-	VkPipelineViewportStateCreateInfo viewportStateCreateInfo = {};
-	viewportStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-	viewportStateCreateInfo.viewportCount = 1;
-	viewportStateCreateInfo.pViewports = &cubemapViewport;
-	viewportStateCreateInfo.scissorCount = 1;
-	viewportStateCreateInfo.pScissors = &cubemapScissor;
-
+	// Viewport and scissor are dynamic (set in Renderer::RecordCommands) so resizing the window does not rebuild the pipeline
 	VkPipelineViewportStateCreateInfo cubemapViewportStateCreateInfo = {};
 	cubemapViewportStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
 	cubemapViewportStateCreateInfo.viewportCount = 1;
-	cubemapViewportStateCreateInfo.pViewports = &cubemapViewport;
+	cubemapViewportStateCreateInfo.pViewports = nullptr;
 	cubemapViewportStateCreateInfo.scissorCount = 1;
-	cubemapViewportStateCreateInfo.pScissors = &cubemapScissor;
+	cubemapViewportStateCreateInfo.pScissors = nullptr;
+
+	std::array<VkDynamicState, 2> cubemapDynamicStates = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+
+	VkPipelineDynamicStateCreateInfo cubemapDynamicStateCreateInfo = {};
+	cubemapDynamicStateCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+	cubemapDynamicStateCreateInfo.dynamicStateCount = static_cast<uint32_t>(cubemapDynamicStates.size());
+	cubemapDynamicStateCreateInfo.pDynamicStates = cubemapDynamicStates.data();
 
 	// Rasterization info
 	VkPipelineRasterizationStateCreateInfo cubemapRasterizationCreateInfo = {};
@@ -367,6 +362,7 @@ void SkyboxRenderer::CreateCubemapGraphicsPipeline()
 	cubemapGraphicsPipelineCreateInfo.pVertexInputState = &cubemapVertexInputCreateInfo;
 	cubemapGraphicsPipelineCreateInfo.pInputAssemblyState = &cubemapInputAssembly;
 	cubemapGraphicsPipelineCreateInfo.pViewportState = &cubemapViewportStateCreateInfo;
+	cubemapGraphicsPipelineCreateInfo.pDynamicState = &cubemapDynamicStateCreateInfo;
 	cubemapGraphicsPipelineCreateInfo.pRasterizationState = &cubemapRasterizationCreateInfo;
 	cubemapGraphicsPipelineCreateInfo.pMultisampleState = &cubemapMultisampleCreateInfo;
 	cubemapGraphicsPipelineCreateInfo.pColorBlendState = &cubemapColorBlending;
@@ -377,7 +373,7 @@ void SkyboxRenderer::CreateCubemapGraphicsPipeline()
 	cubemapGraphicsPipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
 	cubemapGraphicsPipelineCreateInfo.basePipelineIndex = -1;
 
-	VkResult result = vkCreateGraphicsPipelines(vulkanResources->logicalDevice, VK_NULL_HANDLE, 1, &cubemapGraphicsPipelineCreateInfo, nullptr, &cubemapGraphicsPipeline);
+	VkResult result = vkCreateGraphicsPipelines(vulkanResources->logicalDevice, vulkanResources->pipelineCache, 1, &cubemapGraphicsPipelineCreateInfo, nullptr, &cubemapGraphicsPipeline);
 	if (result != VK_SUCCESS)
 		throw std::runtime_error("Failed to create cubemap graphics pipeline!");
 
@@ -410,7 +406,7 @@ void SkyboxRenderer::CreateVertexBuffer()
 		&skyboxVertexBuffer, &skyboxVertexBufferMemory);
 
 	// Copy data from staging buffer to vertex buffer
-	CopyBuffer(vulkanResources->logicalDevice, vulkanResources->graphicsQueue, vulkanResources->graphicsCommandPool,
+	CopyBuffer(vulkanResources->logicalDevice, vulkanResources->graphicsQueue, vulkanResources->uploadCommandPool,
 		stagingBuffer, skyboxVertexBuffer, bufferSize);
 
 	// Clean up staging buffer
@@ -464,15 +460,15 @@ void SkyboxRenderer::CreateCubemapTextureImage(std::string _fileLocation, std::v
 		VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &cubemapImageMemory);
 
 	// Transition image to TRANSFER_DST_OPTIMAL
-	TransitionImageLayout(vulkanResources->logicalDevice, vulkanResources->graphicsQueue, vulkanResources->graphicsCommandPool,
+	TransitionImageLayout(vulkanResources->logicalDevice, vulkanResources->graphicsQueue, vulkanResources->uploadCommandPool,
 		cubemapImage, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 6);
 
 	// Copy buffer to image
-	CopyBufferToCubemapImage(vulkanResources->logicalDevice, vulkanResources->graphicsQueue, vulkanResources->graphicsCommandPool,
+	CopyBufferToCubemapImage(vulkanResources->logicalDevice, vulkanResources->graphicsQueue, vulkanResources->uploadCommandPool,
 		stagingBuffer, cubemapImage, width, height);
 
 	// Transition image to SHADER_READ_ONLY_OPTIMAL
-	TransitionImageLayout(vulkanResources->logicalDevice, vulkanResources->graphicsQueue, vulkanResources->graphicsCommandPool,
+	TransitionImageLayout(vulkanResources->logicalDevice, vulkanResources->graphicsQueue, vulkanResources->uploadCommandPool,
 		cubemapImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, 6);
 
 	// Create image view
@@ -582,19 +578,19 @@ void SkyboxRenderer::CreateCubemapTextureDescriptor(VkImageView _cubemapImageVie
 	vkUpdateDescriptorSets(vulkanResources->logicalDevice, 1, &descriptorWrite, 0, nullptr);
 
 	// Descriptor Set for UBO
-	cubemapUBODescriptorSets.resize(vulkanResources->swapchainImages.size());
+	cubemapUBODescriptorSets.resize(MAX_FRAME_DRAWS);
 
-	std::vector<VkDescriptorSetLayout> layouts(vulkanResources->swapchainImages.size(), cubemapUBOSetLayout);
+	std::vector<VkDescriptorSetLayout> layouts(MAX_FRAME_DRAWS, cubemapUBOSetLayout);
 	VkDescriptorSetAllocateInfo allocInfo = {};
 	allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
 	allocInfo.descriptorPool = cubemapUBODescriptorPool;
-	allocInfo.descriptorSetCount = vulkanResources->swapchainImages.size();
+	allocInfo.descriptorSetCount = MAX_FRAME_DRAWS;
 	allocInfo.pSetLayouts = layouts.data();
 
 	if (vkAllocateDescriptorSets(vulkanResources->logicalDevice, &allocInfo, cubemapUBODescriptorSets.data()) != VK_SUCCESS)
 		throw std::runtime_error("failed to allocate cubemap uniform buffer descriptor sets!");
 
-	for (size_t i = 0; i < vulkanResources->swapchainImages.size(); i++)
+	for (size_t i = 0; i < MAX_FRAME_DRAWS; i++)
 	{
 		VkDescriptorBufferInfo bufferInfo = {};
 		bufferInfo.buffer = cubemapUniformBuffers[i];
@@ -0,0 +1,153 @@
+#include "Engine/Source/Public/SceneQuery/BoundingVolumeHierarchy.h"
+
+// Standard Library
+#include <array>
+
+// Number of buckets the centroids are sorted into when looking for the best split
+const int SAH_BIN_COUNT = 12;
+
+struct SAHBin
+{
+	AABB bounds = CreateEmptyAABB();
+	int primitiveCount = 0;
+};
+
+void BoundingVolumeHierarchy::Build(const std::vector<AABB>& _primitiveBounds)
+{
+	Clear();
+	if (_primitiveBounds.empty())
+		return;
+
+	std::vector<glm::vec3> centroids(_primitiveBounds.size());
+	primitiveIndices.resize(_primitiveBounds.size());
+	for (size_t i = 0; i < _primitiveBounds.size(); i++)
+	{
+		const AABB& bounds = _primitiveBounds[i];
+		centroids[i] = glm::vec3(bounds.minimumX + bounds.maximumX, bounds.minimumY + bounds.maximumY, bounds.minimumZ + bounds.maximumZ) * 0.5f;
+		primitiveIndices[i] = static_cast<int>(i);
+	}
+
+	// A binary tree with n leaves has at most 2n - 1 nodes
+	nodes.reserve(_primitiveBounds.size() * 2);
+	nodes.emplace_back();
+	nodes[0].leftFirst = 0;
+	nodes[0].primitiveCount = static_cast<int>(_primitiveBounds.size());
+	UpdateNodeBounds(0, _primitiveBounds);
+	Subdivide(0, 0, _primitiveBounds, centroids);
+}
+
+void BoundingVolumeHierarchy::Clear()
+{
+	nodes.clear();
+	primitiveIndices.clear();
+}
+
+void BoundingVolumeHierarchy::UpdateNodeBounds(int _nodeID, const std::vector<AABB>& _primitiveBounds)
+{
+	BVHNode& node = nodes[_nodeID];
+	node.bounds = CreateEmptyAABB();
+	for (int i = 0; i < node.primitiveCount; i++)
+		node.bounds = MergeAABB(node.bounds, _primitiveBounds[primitiveIndices[node.leftFirst + i]]);
+}
+
+void BoundingVolumeHierarchy::Subdivide(int _nodeID, int _depth, const std::vector<AABB>& _primitiveBounds, const std::vector<glm::vec3>& _centroids)
+{
+	if (nodes[_nodeID].primitiveCount <= 2 || _depth >= MAX_DEPTH)
+		return;
+
+	int first = nodes[_nodeID].leftFirst;
+	int count = nodes[_nodeID].primitiveCount;
+
+	// Bin by centroid rather than bounds so large primitives do not squash every bin together
+	glm::vec3 centroidMinimum(std::numeric_limits<float>::max());
+	glm::vec3 centroidMaximum(std::numeric_limits<float>::lowest());
+	for (int i = 0; i < count; i++)
+	{
+		centroidMinimum = glm::min(centroidMinimum, _centroids[primitiveIndices[first + i]]);
+		centroidMaximum = glm::max(centroidMaximum, _centroids[primitiveIndices[first + i]]);
+	}
+
+	// Find the cheapest split plane over every axis
+	int bestAxis = -1;
+	int bestSplit = 0;
+	float bestCost = std::numeric_limits<float>::max();
+	for (int axis = 0; axis < 3; axis++)
+	{
+		float extent = centroidMaximum[axis] - centroidMinimum[axis];
+		if (extent <= 0.0f)
+			continue;
+
+		std::array<SAHBin, SAH_BIN_COUNT> bins;
+		float binScale = SAH_BIN_COUNT / extent;
+		for (int i = 0; i < count; i++)
+		{
+			int primitive = primitiveIndices[first + i];
+			int bin = std::min(SAH_BIN_COUNT - 1, static_cast<int>((_centroids[primitive][axis] - centroidMinimum[axis]) * binScale));
+			bins[bin].primitiveCount++;
+			bins[bin].bounds = MergeAABB(bins[bin].bounds, _primitiveBounds[primitive]);
+		}
+
+		// Sweep from both sides so every split's area and count is known in O(bins)
+		std::array<float, SAH_BIN_COUNT - 1> leftArea, rightArea;
+		std::array<int, SAH_BIN_COUNT - 1> leftCount, rightCount;
+		AABB leftBounds = CreateEmptyAABB();
+		AABB rightBounds = CreateEmptyAABB();
+		int leftSum = 0;
+		int rightSum = 0;
+		for (int i = 0; i < SAH_BIN_COUNT - 1; i++)
+		{
+			leftSum += bins[i].primitiveCount;
+			leftCount[i] = leftSum;
+			leftBounds = MergeAABB(leftBounds, bins[i].bounds);
+			leftArea[i] = leftSum > 0 ? AABBSurfaceArea(leftBounds) : 0.0f;
+
+			rightSum += bins[SAH_BIN_COUNT - 1 - i].primitiveCount;
+			rightCount[SAH_BIN_COUNT - 2 - i] = rightSum;
+			rightBounds = MergeAABB(rightBounds, bins[SAH_BIN_COUNT - 1 - i].bounds);
+			rightArea[SAH_BIN_COUNT - 2 - i] = rightSum > 0 ? AABBSurfaceArea(rightBounds) : 0.0f;
+		}
+
+		for (int i = 0; i < SAH_BIN_COUNT - 1; i++)
+		{
+			float cost = leftCount[i] * leftArea[i] + rightCount[i] * rightArea[i];
+			if (leftCount[i] > 0 && rightCount[i] > 0 && cost < bestCost)
+			{
+				bestCost = cost;
+				bestAxis = axis;
+				bestSplit = i;
+			}
+		}
+	}
+
+	// Stop when splitting costs more than testing every primitive in this node
+	float leafCost = count * AABBSurfaceArea(nodes[_nodeID].bounds);
+	if (bestAxis == -1 || bestCost >= leafCost)
+		return;
+
+	// Partition the primitive indices around the chosen plane
+	float binScale = SAH_BIN_COUNT / (centroidMaximum[bestAxis] - centroidMinimum[bestAxis]);
+	int* middle = std::partition(primitiveIndices.data() + first, primitiveIndices.data() + first + count, [&](int _primitive)
+		{
+			int bin = std::min(SAH_BIN_COUNT - 1, static_cast<int>((_centroids[_primitive][bestAxis] - centroidMinimum[bestAxis]) * binScale));
+			return bin <= bestSplit;
+		});
+	int leftCount = static_cast<int>(middle - (primitiveIndices.data() + first));
+
+	// Children are allocated next to each other so only the left index has to be stored
+	int leftChild = static_cast<int>(nodes.size());
+	nodes.emplace_back();
+	nodes.emplace_back();
+
+	nodes[leftChild].leftFirst = first;
+	nodes[leftChild].primitiveCount = leftCount;
+	nodes[leftChild + 1].leftFirst = first + leftCount;
+	nodes[leftChild + 1].primitiveCount = count - leftCount;
+
+	nodes[_nodeID].leftFirst = leftChild;
+	nodes[_nodeID].primitiveCount = 0;
+
+	UpdateNodeBounds(leftChild, _primitiveBounds);
+	UpdateNodeBounds(leftChild + 1, _primitiveBounds);
+	Subdivide(leftChild, _depth + 1, _primitiveBounds, _centroids);
+	Subdivide(leftChild + 1, _depth + 1, _primitiveBounds, _centroids);
+}
@@ -0,0 +1,155 @@
+#include "Engine/Source/Public/SceneQuery/SceneQuery.h"
+
+// Project Includes
+#include "Engine/Source/Public/Object/GameObject.h"
+#include "Engine/Source/Public/Rendering/Mesh.h"
+#include "Engine/Source/Public/Rendering/MeshModel.h"
+
+void SceneQuery::UpdateIfDirty(const std::vector<GameObject*>& _gameObjects)
+{
+	if (dirty.exchange(false))
+		Build(_gameObjects);
+}
+
+void SceneQuery::Build(const std::vector<GameObject*>& _gameObjects)
+{
+	objects.clear();
+	objects.reserve(_gameObjects.size());
+
+	std::vector<AABB> objectBounds;
+	objectBounds.reserve(_gameObjects.size());
+
+	for (GameObject* gameObject : _gameObjects)
+	{
+		SceneQueryObject object;
+		object.gameObject = gameObject;
+		object.worldAABB = gameObject->GetWorldAABB();
+
+		glm::mat4 modelMatrix = gameObject->GetModel().modelMatrix;
+		object.inverseModelMatrix = glm::inverse(modelMatrix);
+		object.normalMatrix = glm::transpose(glm::mat3(object.inverseModelMatrix));
+
+		if (gameObject->objectMeshModel != nullptr)
+		{
+			for (size_t i = 0; i < gameObject->objectMeshModel->GetMeshCount(); i++)
+				object.meshes.push_back(gameObject->objectMeshModel->GetMesh(i));
+		}
+		else if (gameObject->objectMesh != nullptr)
+			object.meshes.push_back(gameObject->objectMesh);
+
+		objects.push_back(object);
+		objectBounds.push_back(object.worldAABB);
+	}
+
+	sceneBVH.Build(objectBounds);
+}
+
+RaycastHit SceneQuery::Raycast(const Ray& _ray) const
+{
+	RaycastHit result;
+	float closestDistance = _ray.maxDistance;
+
+	sceneBVH.Raycast(_ray, closestDistance, [&](int _objectIndex, float& _closest)
+		{
+			const SceneQueryObject& object = objects[_objectIndex];
+
+			// The ray is moved into object space without normalizing, so distances along it stay in world units
+			Ray localRay;
+			localRay.origin = glm::vec3(object.inverseModelMatrix * glm::vec4(_ray.origin, 1.0f));
+			localRay.direction = glm::vec3(object.inverseModelMatrix * glm::vec4(_ray.direction, 0.0f));
+			localRay.maxDistance = _closest;
+
+			bool hit = false;
+			glm::vec3 localNormal;
+			for (Mesh* mesh : object.meshes)
+				hit |= mesh->GetTriangleBVH().Raycast(localRay, mesh->GetVertices(), mesh->GetIndices(), _closest, &localNormal);
+
+			if (!hit)
+				return false;
+
+			result.hit = true;
+			result.gameObject = object.gameObject;
+			result.distance = _closest;
+			result.normal = glm::normalize(object.normalMatrix * localNormal);
+			return true;
+		});
+
+	if (result.hit)
+	{
+		result.position = _ray.origin + _ray.direction * result.distance;
+
+		// Triangles are double sided, always report the side the ray came from
+		if (glm::dot(result.normal, _ray.direction) > 0.0f)
+			result.normal = -result.normal;
+	}
+
+	return result;
+}
+
+void SceneQuery::OverlapSphere(const Sphere& _sphere, std::vector<GameObject*>& _results) const
+{
+	AABB sphereAABB;
+	sphereAABB.minimumX = _sphere.center.x - _sphere.radius;
+	sphereAABB.minimumY = _sphere.center.y - _sphere.radius;
+	sphereAABB.minimumZ = _sphere.center.z - _sphere.radius;
+	sphereAABB.maximumX = _sphere.center.x + _sphere.radius;
+	sphereAABB.maximumY = _sphere.center.y + _sphere.radius;
+	sphereAABB.maximumZ = _sphere.center.z + _sphere.radius;
+
+	sceneBVH.Query(sphereAABB, [&](int _objectIndex)
+		{
+			if (SphereOverlapsAABB(_sphere.center, _sphere.radius, objects[_objectIndex].worldAABB))
+				_results.push_back(objects[_objectIndex].gameObject);
+		});
+}
+
+void SceneQuery::OverlapBox(const AABB& _box, std::vector<GameObject*>& _results) const
+{
+	sceneBVH.Query(_box, [&](int _objectIndex)
+		{
+			if (AABBOverlaps(_box, objects[_objectIndex].worldAABB))
+				_results.push_back(objects[_objectIndex].gameObject);
+		});
+}
+
+void SceneQuery::RaycastBatch(const std::vector<Ray>& _rays, std::vector<RaycastHit>& _results) const
+{
+	_results.resize(_rays.size());
+	ParallelFor(_rays.size(), minimumQueriesPerThread, [&](size_t _index) { _results[_index] = Raycast(_rays[_index]); });
+}
+
+void SceneQuery::OverlapSphereBatch(const std::vector<Sphere>& _spheres, std::vector<std::vector<GameObject*>>& _results) const
+{
+	_results.resize(_spheres.size());
+	ParallelFor(_spheres.size(), minimumQueriesPerThread, [&](size_t _index)
+		{
+			_results[_index].clear();
+			OverlapSphere(_spheres[_index], _results[_index]);
+		});
+}
+
+void SceneQuery::OverlapBoxBatch(const std::vector<AABB>& _boxes, std::vector<std::vector<GameObject*>>& _results) const
+{
+	_results.resize(_boxes.size());
+	ParallelFor(_boxes.size(), minimumQueriesPerThread, [&](size_t _index)
+		{
+			_results[_index].clear();
+			OverlapBox(_boxes[_index], _results[_index]);
+		});
+}
+
+Ray SceneQuery::CreateScreenRay(float _screenX, float _screenY, float _screenWidth, float _screenHeight, const UniformBufferObjectViewProjection& _viewProjection)
+{
+	// The projection already flips Y for Vulkan, so screen Y maps straight to NDC Y
+	float ndcX = (2.0f * _screenX) / _screenWidth - 1.0f;
+	float ndcY = (2.0f * _screenY) / _screenHeight - 1.0f;
+
+	// Depth 1 is the far plane with both the [0, 1] and [-1, 1] depth conventions, the origin is the camera itself
+	glm::mat4 inverseView = glm::inverse(_viewProjection.view);
+	glm::vec4 farPoint = glm::inverse(_viewProjection.projection * _viewProjection.view) * glm::vec4(ndcX, ndcY, 1.0f, 1.0f);
+
+	Ray ray;
+	ray.origin = glm::vec3(inverseView[3]);
+	ray.direction = glm::normalize(glm::vec3(farPoint) / farPoint.w - ray.origin);
+	return ray;
+}
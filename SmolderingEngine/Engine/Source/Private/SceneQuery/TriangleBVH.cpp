@@ -0,0 +1,38 @@
+#include "Engine/Source/Public/SceneQuery/TriangleBVH.h"
+
+void TriangleBVH::Build(const std::vector<glm::vec3>& _vertices, const std::vector<uint32_t>& _indices)
+{
+	std::vector<AABB> triangleBounds(_indices.size() / 3);
+	for (size_t triangle = 0; triangle < triangleBounds.size(); triangle++)
+	{
+		AABB bounds = CreateEmptyAABB();
+		for (int corner = 0; corner < 3; corner++)
+			GrowAABB(bounds, _vertices[_indices[triangle * 3 + corner]]);
+		triangleBounds[triangle] = bounds;
+	}
+
+	bvh.Build(triangleBounds);
+}
+
+bool TriangleBVH::Raycast(const Ray& _ray, const std::vector<glm::vec3>& _vertices, const std::vector<uint32_t>& _indices,
+	float& _closestDistance, glm::vec3* _normal) const
+{
+	bool hit = false;
+	bvh.Raycast(_ray, _closestDistance, [&](int _triangle, float& _closest)
+		{
+			const glm::vec3& vertex0 = _vertices[_indices[_triangle * 3]];
+			const glm::vec3& vertex1 = _vertices[_indices[_triangle * 3 + 1]];
+			const glm::vec3& vertex2 = _vertices[_indices[_triangle * 3 + 2]];
+
+			float distance = RayIntersectTriangle(_ray.origin, _ray.direction, vertex0, vertex1, vertex2);
+			if (distance < 0.0f || distance >= _closest || distance > _ray.maxDistance)
+				return false;
+
+			_closest = distance;
+			*_normal = glm::normalize(glm::cross(vertex1 - vertex0, vertex2 - vertex0));
+			hit = true;
+			return true;
+		});
+
+	return hit;
+}
@@ -0,0 +1,182 @@
+#include "Engine/Source/Public/Threading/JobSystem.h"
+
+// Standard Library
+#include <stdexcept>
+#include <string>
+
+thread_local int JobSystem::threadIndex = -1;
+thread_local JobSystem* JobSystem::threadJobSystem = nullptr;
+
+JobSystem::JobSystem(size_t _workerCount)
+{
+	// The thread that creates the job system is the main thread
+	threadIndex = 0;
+	threadJobSystem = this;
+
+	for (size_t i = 0; i <= _workerCount; i++)
+	{
+		queues.push_back(std::make_unique<WorkStealingDeque>());
+		jobRings.push_back(std::make_unique<JobRing>());
+	}
+
+	for (size_t i = 1; i <= _workerCount; i++)
+		workers.emplace_back(&JobSystem::WorkerLoop, this, static_cast<int>(i));
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		running = false;
+	}
+	wakeCondition.notify_all();
+
+	for (std::thread& worker : workers)
+		worker.join();
+
+	if (threadJobSystem == this)
+	{
+		threadIndex = -1;
+		threadJobSystem = nullptr;
+	}
+}
+
+void JobSystem::RunMainThreadJobs()
+{
+	if (threadIndex != 0)
+		throw std::runtime_error("Main thread jobs can only be run from the main thread!");
+
+	mainThreadTasks.RunPending();
+}
+
+void JobSystem::Wait(JobCounter* _counter)
+{
+	while (!_counter->IsDone())
+	{
+		Job* job = GetJob();
+		if (job != nullptr)
+		{
+			Execute(job);
+			continue;
+		}
+
+		// The counter may be waiting on a main thread job, which nobody else can run
+		if (threadIndex == 0)
+			RunMainThreadJobs();
+
+		std::this_thread::yield();
+	}
+}
+
+void JobSystem::WorkerLoop(int _threadIndex)
+{
+	threadIndex = _threadIndex;
+	threadJobSystem = this;
+
+	while (running)
+	{
+		Job* job = GetJob();
+		if (job != nullptr)
+		{
+			Execute(job);
+			continue;
+		}
+
+		// Nothing to take anywhere, sleep until a job is pushed. Counting ourselves as asleep before checking
+		// queuedJobs means a push either sees us and wakes us, or we see its job.
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		sleepingWorkers.fetch_add(1);
+		wakeCondition.wait(lock, [this]() { return !running || queuedJobs.load() > 0; });
+		sleepingWorkers.fetch_sub(1);
+	}
+}
+
+Job* JobSystem::AllocateJob()
+{
+	if (threadIndex < 0)
+		throw std::runtime_error("Jobs can only be started from the main thread or from inside a job!");
+
+	JobRing& jobRing = *jobRings[threadIndex];
+	for (size_t i = 0; i < JobRing::capacity; i++)
+	{
+		Job* job = &jobRing.jobs[jobRing.next];
+		jobRing.next = (jobRing.next + 1) % JobRing::capacity;
+
+		if (!job->inUse.load(std::memory_order_acquire))
+		{
+			job->inUse.store(true, std::memory_order_relaxed);
+			return job;
+		}
+	}
+
+	throw std::runtime_error("More than " + std::to_string(JobRing::capacity) + " unfinished jobs were started from one thread!");
+}
+
+void JobSystem::Push(Job* _job)
+{
+	// A full deque means this thread has thousands of jobs waiting already, running this one now costs nothing extra
+	if (!queues[threadIndex]->Push(_job))
+	{
+		Execute(_job);
+		return;
+	}
+
+	queuedJobs.fetch_add(1);
+	if (sleepingWorkers.load() > 0)
+	{
+		// Taking the lock means a worker that counted itself asleep is now waiting and gets the notify
+		{
+			std::lock_guard<std::mutex> lock(sleepMutex);
+		}
+		wakeCondition.notify_one();
+	}
+}
+
+Job* JobSystem::GetJob()
+{
+	if (queuedJobs.load(std::memory_order_relaxed) == 0)
+		return nullptr;
+
+	// Newest own job first, its data is most likely still in this core's cache
+	if (threadIndex >= 0)
+	{
+		Job* job = queues[threadIndex]->Pop();
+		if (job != nullptr)
+		{
+			queuedJobs.fetch_sub(1);
+			return job;
+		}
+	}
+
+	// Oldest job of another thread, usually the biggest piece of work left and the least likely to be in its cache.
+	// Start at a different victim per thread so thieves do not all pile onto the same deque.
+	int queueCount = static_cast<int>(queues.size());
+	int start = (threadIndex >= 0) ? threadIndex + 1 : 0;
+	for (int i = 0; i < queueCount; i++)
+	{
+		int victimIndex = (start + i) % queueCount;
+		if (victimIndex == threadIndex)
+			continue;
+
+		Job* job = queues[victimIndex]->Steal();
+		if (job != nullptr)
+		{
+			queuedJobs.fetch_sub(1);
+			return job;
+		}
+	}
+
+	return nullptr;
+}
+
+void JobSystem::Execute(Job* _job)
+{
+	JobCounter* counter = _job->counter;
+	_job->invoke(_job);
+	_job->destroy(_job);
+	_job->inUse.store(false, std::memory_order_release);
+
+	// Released so the waiting thread sees everything the job wrote
+	if (counter != nullptr)
+		counter->value.fetch_sub(1, std::memory_order_release);
+}
@@ -0,0 +1,97 @@
+#include "Engine/Source/Public/Threading/MPSCTaskQueue.h"
+
+MPSCTaskQueue::MPSCTaskQueue()
+{
+	// Cell i is free for the producer that claims position i
+	for (size_t i = 0; i < capacity; i++)
+		cells[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+MPSCTaskQueue::~MPSCTaskQueue()
+{
+	// Tasks that never ran still own what they captured
+	size_t position = dequeuePosition;
+	while (true)
+	{
+		TaskCell* cell = &cells[position & (capacity - 1)];
+		if (cell->sequence.load(std::memory_order_acquire) != position + 1)
+			break;
+
+		cell->destroy(cell->storage);
+		position++;
+	}
+}
+
+size_t MPSCTaskQueue::RunPending()
+{
+	// Tasks pushed while these run wait for the next call, so a task that queues itself can not loop forever
+	size_t lastPosition = enqueuePosition.load(std::memory_order_acquire);
+	size_t taskCount = 0;
+
+	while (dequeuePosition < lastPosition)
+	{
+		TaskCell* cell = &cells[dequeuePosition & (capacity - 1)];
+
+		// Claimed but still being filled in, it runs next call rather than making the consumer wait on a producer
+		size_t position = dequeuePosition;
+		if (cell->sequence.load(std::memory_order_acquire) != position + 1)
+			break;
+
+		// Moved on before running, a task that runs the queue itself starts at the next cell
+		dequeuePosition++;
+		RunCell(cell);
+
+		// Free for the producer one lap later
+		cell->sequence.store(position + capacity, std::memory_order_release);
+		taskCount++;
+	}
+
+	return taskCount;
+}
+
+TaskCell* MPSCTaskQueue::ClaimCell(size_t& _position)
+{
+	size_t position = enqueuePosition.load(std::memory_order_relaxed);
+	while (true)
+	{
+		TaskCell* cell = &cells[position & (capacity - 1)];
+		intptr_t difference = static_cast<intptr_t>(cell->sequence.load(std::memory_order_acquire)) - static_cast<intptr_t>(position);
+
+		if (difference == 0)
+		{
+			// Free on this lap, take it unless another producer got there first
+			if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+			{
+				_position = position;
+				return cell;
+			}
+		}
+		else if (difference < 0)
+		{
+			// Still holds the task from the last lap, the consumer is a full ring behind
+			return nullptr;
+		}
+		else
+		{
+			// Another producer claimed it, try the newest position
+			position = enqueuePosition.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+void MPSCTaskQueue::PublishCell(TaskCell* _cell, size_t _position)
+{
+	// Released so the consumer sees the task written into the cell
+	_cell->sequence.store(_position + 1, std::memory_order_release);
+}
+
+void MPSCTaskQueue::RunCell(TaskCell* _cell)
+{
+	JobCounter* counter = _cell->counter;
+	_cell->invoke(_cell->storage);
+	_cell->destroy(_cell->storage);
+
+	// Released so the waiting thread sees everything the task wrote
+	if (counter != nullptr)
+		counter->value.fetch_sub(1, std::memory_order_release);
+}
@@ -0,0 +1,58 @@
+#include "Engine/Source/Public/Threading/WorkStealingDeque.h"
+
+bool WorkStealingDeque::Push(Job* _job)
+{
+	int64_t currentBottom = bottom.load(std::memory_order_relaxed);
+	int64_t currentTop = top.load(std::memory_order_acquire);
+	if (currentBottom - currentTop >= capacity)
+		return false;
+
+	// Released so a thief that reads the slot also sees everything written into the job
+	buffer[currentBottom & (capacity - 1)].store(_job, std::memory_order_release);
+	bottom.store(currentBottom + 1, std::memory_order_release);
+	return true;
+}
+
+Job* WorkStealingDeque::Pop()
+{
+	// Claim the bottom slot first, then look at top. The full fence orders the two against a thief doing the opposite.
+	int64_t currentBottom = bottom.load(std::memory_order_relaxed) - 1;
+	bottom.store(currentBottom, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t currentTop = top.load(std::memory_order_relaxed);
+
+	if (currentTop > currentBottom)
+	{
+		// Empty, put bottom back
+		bottom.store(currentBottom + 1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	Job* job = buffer[currentBottom & (capacity - 1)].load(std::memory_order_relaxed);
+	if (currentTop == currentBottom)
+	{
+		// The last job, thieves can see it too so whoever moves top first gets it
+		if (!top.compare_exchange_strong(currentTop, currentTop + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			job = nullptr;
+		bottom.store(currentBottom + 1, std::memory_order_relaxed);
+	}
+
+	return job;
+}
+
+Job* WorkStealingDeque::Steal()
+{
+	int64_t currentTop = top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t currentBottom = bottom.load(std::memory_order_acquire);
+
+	if (currentTop >= currentBottom)
+		return nullptr;
+
+	// Read before the compare and swap, once top moves the owner may reuse the slot
+	Job* job = buffer[currentTop & (capacity - 1)].load(std::memory_order_acquire);
+	if (!top.compare_exchange_strong(currentTop, currentTop + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		return nullptr;
+
+	return job;
+}
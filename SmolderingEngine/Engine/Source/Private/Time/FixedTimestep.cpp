@@ -0,0 +1,46 @@
+#include "Engine/Source/Public/Time/FixedTimestep.h"
+
+// Standard Library
+#include <algorithm>
+#include <cmath>
+
+FixedTimestep::FixedTimestep(int _ticksPerSecond)
+{
+	SetTickRate(_ticksPerSecond);
+}
+
+int FixedTimestep::Advance()
+{
+	Clock::time_point currentTime = Clock::now();
+
+	// The first frame runs one tick so there is a state to show, rather than counting the time it took to start up
+	if (!started)
+	{
+		started = true;
+		previousTime = currentTime;
+		return 1;
+	}
+
+	accumulator += std::chrono::duration<double>(currentTime - previousTime).count();
+	previousTime = currentTime;
+
+	int tickCount = static_cast<int>(accumulator / tickInterval);
+	if (tickCount > maxTicksPerFrame)
+	{
+		// Drop the time that would not fit, keeping the fraction so interpolation does not jump
+		accumulator = std::fmod(accumulator, tickInterval);
+		tickCount = maxTicksPerFrame;
+	}
+	else
+	{
+		accumulator -= tickCount * tickInterval;
+	}
+
+	return tickCount;
+}
+
+void FixedTimestep::SetTickRate(int _ticksPerSecond)
+{
+	tickInterval = 1.0 / std::clamp(_ticksPerSecond, 1, 1000);
+	accumulator = std::min(accumulator, tickInterval);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+// Standard Library
+#include <string>
+#include <vector>
+#include <utility>
+
+/*
+* CPU benchmarks that run without creating a window or a Vulkan device.
+* Run with: SmolderingEngine --benchmark <name>
+*/
+class Benchmarks
+{
+	/* Variables */
+private:
+	using BenchmarkFunction = void(*)();
+
+	/* Functions */
+public:
+	// Runs the benchmark with the given name, prints the list of benchmarks and returns false if there is none
+	static bool RunBenchmark(const std::string& _name);
+
+	/* Getters */
+	static std::vector<std::string> GetBenchmarkNames();
+
+private:
+	static const std::vector<std::pair<std::string, BenchmarkFunction>>& GetBenchmarkTable();
+
+	// 10k static AABBs against 100 moving AABBs, brute force nested loop vs every broadphase
+	static void CollisionBroadphase();
+
+	// Loads and unloads the same level several times through the GameObject pool and level arena, counting heap calls
+	static void LevelAllocation();
+
+	// 100k moving objects through the update phase, serially and on the job system with more and more workers
+	static void ObjectUpdate();
+
+	// Cost of starting, stealing and waiting on jobs, against starting a thread per task
+	static void JobSystemOverhead();
+
+	// Loader threads handing tasks to the main thread, the old mutex guarded std::queue against the lock-free ring
+	static void TaskQueueContention();
+};
@@ -8,13 +8,26 @@ class Camera : public Object
 	/* Variables */
 public:
 	Model objectModel;
+	// View is interpolated between the last two simulation ticks each frame, see InterpolateView
 	UniformBufferObjectViewProjection uboViewProjection;
 
+private:
+	// Where the camera was at the end of the previous and the latest simulation tick
+	glm::vec3 previousPosition = glm::vec3(0.0f);
+	glm::vec3 previousFront = glm::vec3(0.0f, 0.0f, -1.0f);
+	glm::vec3 currentPosition = glm::vec3(0.0f);
+	glm::vec3 currentFront = glm::vec3(0.0f, 0.0f, -1.0f);
+
 	/* Functions */
 public:
 	Camera();
 	Camera(float _fovAngle, float _width, float _height, float _nearPlane, float _farPlane);
 
+	// Called once per simulation tick with where the camera is now, the previous tick's state is kept to blend from
+	void SetSimulationState(const glm::vec3& _position, const glm::vec3& _front);
+	// Builds the view from the two tick states, _alpha 0 is the previous tick and 1 the latest
+	void InterpolateView(float _alpha);
+
 	virtual void SetModel(glm::mat4 _model) override;
 	virtual Model GetModel() override;
 	int GetUseTexture() override;
@@ -0,0 +1,182 @@
+#pragma once
+
+// Standard Library
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// SIMD, AVX2 needs SMOLDERING_ENABLE_AVX2 in CMake. SSE2 is always there on x64.
+#if defined(__AVX2__)
+#define SE_AABB_BATCH_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SE_AABB_BATCH_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Project includes
+#include "Engine/Source/Public/Rendering/Utilities.h"
+
+// How many AABBs one call of OverlapMask8 tests
+const int AABB_BATCH_WIDTH = 8;
+
+/*
+* Structure of arrays AABBs so one query can be tested against AABB_BATCH_WIDTH boxes at once.
+* The arrays are padded to a multiple of AABB_BATCH_WIDTH with empty AABBs that never overlap anything,
+* so the kernel can always read a full batch.
+*/
+struct AABBArrays
+{
+	std::vector<float> minimumX;
+	std::vector<float> minimumY;
+	std::vector<float> minimumZ;
+	std::vector<float> maximumX;
+	std::vector<float> maximumY;
+	std::vector<float> maximumZ;
+
+	int count = 0;
+
+	// Returns the index of the new AABB
+	int Add(const AABB& _aabb)
+	{
+		if (count >= static_cast<int>(minimumX.size()))
+			Pad(count + AABB_BATCH_WIDTH);
+
+		Set(count, _aabb);
+		return count++;
+	}
+
+	void Set(int _index, const AABB& _aabb)
+	{
+		minimumX[_index] = _aabb.minimumX;
+		minimumY[_index] = _aabb.minimumY;
+		minimumZ[_index] = _aabb.minimumZ;
+		maximumX[_index] = _aabb.maximumX;
+		maximumY[_index] = _aabb.maximumY;
+		maximumZ[_index] = _aabb.maximumZ;
+	}
+
+	AABB Get(int _index) const
+	{
+		AABB aabb;
+		aabb.minimumX = minimumX[_index];
+		aabb.minimumY = minimumY[_index];
+		aabb.minimumZ = minimumZ[_index];
+		aabb.maximumX = maximumX[_index];
+		aabb.maximumY = maximumY[_index];
+		aabb.maximumZ = maximumZ[_index];
+
+		return aabb;
+	}
+
+	// Moves the last AABB into _index, returns the index it was moved from so the caller can fix up its own arrays
+	int RemoveSwap(int _index)
+	{
+		int lastIndex = --count;
+		Set(_index, Get(lastIndex));
+		Set(lastIndex, CreateEmptyAABB());
+
+		return lastIndex;
+	}
+
+	// Keeps the memory so refilling does not allocate
+	void Clear()
+	{
+		for (int i = 0; i < count; i++)
+			Set(i, CreateEmptyAABB());
+		count = 0;
+	}
+
+private:
+	void Pad(int _size)
+	{
+		AABB emptyAABB = CreateEmptyAABB();
+		minimumX.resize(_size, emptyAABB.minimumX);
+		minimumY.resize(_size, emptyAABB.minimumY);
+		minimumZ.resize(_size, emptyAABB.minimumZ);
+		maximumX.resize(_size, emptyAABB.maximumX);
+		maximumY.resize(_size, emptyAABB.maximumY);
+		maximumZ.resize(_size, emptyAABB.maximumZ);
+	}
+};
+
+// Bit i is set if _boxes[_first + i] overlaps _query, same rules as AABBOverlaps. _first must be a multiple of AABB_BATCH_WIDTH.
+static uint32_t OverlapMask8(const AABB& _query, const AABBArrays& _boxes, int _first)
+{
+#if defined(SE_AABB_BATCH_AVX2)
+	__m256 overlap = _mm256_and_ps(
+		_mm256_cmp_ps(_mm256_loadu_ps(&_boxes.minimumX[_first]), _mm256_set1_ps(_query.maximumX), _CMP_LE_OQ),
+		_mm256_cmp_ps(_mm256_loadu_ps(&_boxes.maximumX[_first]), _mm256_set1_ps(_query.minimumX), _CMP_GE_OQ));
+	overlap = _mm256_and_ps(overlap, _mm256_and_ps(
+		_mm256_cmp_ps(_mm256_loadu_ps(&_boxes.minimumY[_first]), _mm256_set1_ps(_query.maximumY), _CMP_LE_OQ),
+		_mm256_cmp_ps(_mm256_loadu_ps(&_boxes.maximumY[_first]), _mm256_set1_ps(_query.minimumY), _CMP_GE_OQ)));
+	overlap = _mm256_and_ps(overlap, _mm256_and_ps(
+		_mm256_cmp_ps(_mm256_loadu_ps(&_boxes.minimumZ[_first]), _mm256_set1_ps(_query.maximumZ), _CMP_LE_OQ),
+		_mm256_cmp_ps(_mm256_loadu_ps(&_boxes.maximumZ[_first]), _mm256_set1_ps(_query.minimumZ), _CMP_GE_OQ)));
+
+	return static_cast<uint32_t>(_mm256_movemask_ps(overlap));
+#elif defined(SE_AABB_BATCH_SSE2)
+	// Two halves of 4
+	uint32_t mask = 0;
+	for (int half = 0; half < 2; half++)
+	{
+		int index = _first + half * 4;
+		__m128 overlap = _mm_and_ps(
+			_mm_cmple_ps(_mm_loadu_ps(&_boxes.minimumX[index]), _mm_set1_ps(_query.maximumX)),
+			_mm_cmpge_ps(_mm_loadu_ps(&_boxes.maximumX[index]), _mm_set1_ps(_query.minimumX)));
+		overlap = _mm_and_ps(overlap, _mm_and_ps(
+			_mm_cmple_ps(_mm_loadu_ps(&_boxes.minimumY[index]), _mm_set1_ps(_query.maximumY)),
+			_mm_cmpge_ps(_mm_loadu_ps(&_boxes.maximumY[index]), _mm_set1_ps(_query.minimumY))));
+		overlap = _mm_and_ps(overlap, _mm_and_ps(
+			_mm_cmple_ps(_mm_loadu_ps(&_boxes.minimumZ[index]), _mm_set1_ps(_query.maximumZ)),
+			_mm_cmpge_ps(_mm_loadu_ps(&_boxes.maximumZ[index]), _mm_set1_ps(_query.minimumZ))));
+
+		mask |= static_cast<uint32_t>(_mm_movemask_ps(overlap)) << (half * 4);
+	}
+
+	return mask;
+#else
+	uint32_t mask = 0;
+	for (int i = 0; i < AABB_BATCH_WIDTH; i++)
+	{
+		int index = _first + i;
+		bool overlap = (_boxes.minimumX[index] <= _query.maximumX) && (_boxes.maximumX[index] >= _query.minimumX)
+			&& (_boxes.minimumY[index] <= _query.maximumY) && (_boxes.maximumY[index] >= _query.minimumY)
+			&& (_boxes.minimumZ[index] <= _query.maximumZ) && (_boxes.maximumZ[index] >= _query.minimumZ);
+
+		mask |= (overlap ? 1u : 0u) << i;
+	}
+
+	return mask;
+#endif
+}
+
+static int CountTrailingZeros(uint32_t _value)
+{
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward(&index, _value);
+	return static_cast<int>(index);
+#else
+	return __builtin_ctz(_value);
+#endif
+}
+
+// Calls _callback(index) for every AABB in _boxes that overlaps _query, in index order
+template<typename Callback>
+void QueryOverlaps(const AABB& _query, const AABBArrays& _boxes, Callback&& _callback)
+{
+	for (int first = 0; first < _boxes.count; first += AABB_BATCH_WIDTH)
+	{
+		uint32_t mask = OverlapMask8(_query, _boxes, first);
+		while (mask != 0)
+		{
+			_callback(first + CountTrailingZeros(mask));
+			mask &= mask - 1;
+		}
+	}
+}
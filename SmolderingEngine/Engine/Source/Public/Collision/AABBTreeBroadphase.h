@@ -0,0 +1,50 @@
+#pragma once
+
+// Standard Library
+#include <vector>
+
+// Project includes
+#include "Engine/Source/Public/Collision/Broadphase.h"
+#include "Engine/Source/Public/Collision/DynamicAABBTree.h"
+
+/*
+* Broadphase that keeps static and movable objects in separate dynamic AABB trees so each mover only
+* walks the parts of the static tree it overlaps. Best when most objects never move.
+*/
+class AABBTreeBroadphase : public Broadphase
+{
+	/* Variables */
+private:
+	DynamicAABBTree staticTree;
+	DynamicAABBTree movableTree;
+
+	// Tree proxy IDs of every movable, UpdatePairs queries from each of them
+	std::vector<int> movableProxies;
+
+	/* Functions */
+public:
+	int CreateProxy(const AABB& _aabb, class GameObject* _gameObject, CollisionTypes _collisionType) override;
+	void DestroyProxy(int _proxyID) override;
+	void MoveProxy(int _proxyID, const AABB& _aabb) override;
+
+	void UpdatePairs(std::vector<BroadphasePair>& _pairs) override;
+	void QueryProxy(int _proxyID, std::vector<BroadphasePair>& _pairs) override;
+	void QueryAABB(const AABB& _aabb, std::vector<int>& _proxyIDs) override;
+
+	/* Getters */
+	class GameObject* GetGameObject(int _proxyID) const override;
+	CollisionTypes GetCollisionType(int _proxyID) const override;
+	const char* GetName() const override { return "Dynamic AABB tree"; };
+
+	const DynamicAABBTree& GetStaticTree() { return staticTree; };
+	const DynamicAABBTree& GetMovableTree() { return movableTree; };
+
+private:
+	// Both trees hand out IDs from 0, the lowest bit of a broadphase proxy ID says which tree it is in
+	static int ToProxyID(int _treeProxyID, bool _movable) { return (_treeProxyID << 1) | (_movable ? 1 : 0); };
+	static int ToTreeProxyID(int _proxyID) { return _proxyID >> 1; };
+	static bool IsMovable(int _proxyID) { return (_proxyID & 1) != 0; };
+
+	// With _onlyHigherMovables movable pairs are only added from the lower ID so each one is added once
+	void AddPairs(int _treeProxyID, bool _onlyHigherMovables, std::vector<BroadphasePair>& _pairs);
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+// Standard Library
+#include <vector>
+
+// Project includes
+#include "Engine/Source/Public/Rendering/Utilities.h"
+
+enum class BroadphaseType
+{
+	DynamicAABBTree,
+	SweepAndPrune,
+	BruteForce,
+	SpatialHashGrid
+};
+
+// Two proxies whose broadphase bounds overlap, proxyID is always a movable proxy
+struct BroadphasePair
+{
+	int proxyID;
+	int otherProxyID;
+};
+
+/*
+* Finds the pairs of objects that might be colliding so only those reach the exact test.
+* Static vs static pairs are never reported and every pair is only reported once.
+*/
+class Broadphase
+{
+	/* Functions */
+public:
+	virtual ~Broadphase() {};
+
+	// Returns the proxy ID, only valid for this broadphase until DestroyProxy is called
+	virtual int CreateProxy(const AABB& _aabb, class GameObject* _gameObject, CollisionTypes _collisionType) = 0;
+	virtual void DestroyProxy(int _proxyID) = 0;
+	virtual void MoveProxy(int _proxyID, const AABB& _aabb) = 0;
+
+	// Appends every pair, _pairs is not cleared so the caller can reuse its capacity
+	virtual void UpdatePairs(std::vector<BroadphasePair>& _pairs) = 0;
+	// Appends every pair that includes _proxyID (which must be movable)
+	virtual void QueryProxy(int _proxyID, std::vector<BroadphasePair>& _pairs) = 0;
+	// Appends every proxy, static or movable, whose broadphase bounds overlap _aabb
+	virtual void QueryAABB(const AABB& _aabb, std::vector<int>& _proxyIDs) = 0;
+
+	/* Getters */
+	virtual class GameObject* GetGameObject(int _proxyID) const = 0;
+	virtual CollisionTypes GetCollisionType(int _proxyID) const = 0;
+	virtual const char* GetName() const = 0;
+
+	static Broadphase* CreateBroadphase(BroadphaseType _broadphaseType);
+};
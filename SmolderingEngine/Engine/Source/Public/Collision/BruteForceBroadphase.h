@@ -0,0 +1,55 @@
+#pragma once
+
+// Standard Library
+#include <vector>
+
+// Project includes
+#include "Engine/Source/Public/Collision/Broadphase.h"
+#include "Engine/Source/Public/Collision/AABBBatch.h"
+
+struct BruteForceProxy
+{
+	class GameObject* gameObject = nullptr;
+	CollisionTypes collisionType = CollisionTypes::StaticCollision;
+
+	// Index into the static or movable bounds, next free proxy when in the free list
+	int indexOrNext = -1;
+	bool free = false;
+};
+
+/*
+* Tests every movable against every other object, with the bounds in structure of arrays form so each
+* test covers AABB_BATCH_WIDTH objects. No build or update cost, so it wins for small levels.
+*/
+class BruteForceBroadphase : public Broadphase
+{
+	/* Variables */
+private:
+	std::vector<BruteForceProxy> proxies;
+	int freeList = -1;
+
+	// Packed bounds and the proxy each one belongs to
+	AABBArrays staticBounds;
+	std::vector<int> staticProxyIDs;
+	AABBArrays movableBounds;
+	std::vector<int> movableProxyIDs;
+
+	/* Functions */
+public:
+	int CreateProxy(const AABB& _aabb, class GameObject* _gameObject, CollisionTypes _collisionType) override;
+	void DestroyProxy(int _proxyID) override;
+	void MoveProxy(int _proxyID, const AABB& _aabb) override;
+
+	void UpdatePairs(std::vector<BroadphasePair>& _pairs) override;
+	void QueryProxy(int _proxyID, std::vector<BroadphasePair>& _pairs) override;
+	void QueryAABB(const AABB& _aabb, std::vector<int>& _proxyIDs) override;
+
+	/* Getters */
+	class GameObject* GetGameObject(int _proxyID) const override { return proxies[_proxyID].gameObject; };
+	CollisionTypes GetCollisionType(int _proxyID) const override { return proxies[_proxyID].collisionType; };
+	const char* GetName() const override { return "Brute force (SIMD)"; };
+
+private:
+	// With _onlyHigherMovables movable pairs are only added from the lower index so each one is added once
+	void AddPairs(int _movableIndex, bool _onlyHigherMovables, std::vector<BroadphasePair>& _pairs);
+};
@@ -4,12 +4,100 @@
 #include <iostream>s
 #include <vector>
 #include <unordered_map>
+#include <functional>
 
 // Project includes
 #include "Game/Source/Public/Game.h"
 #include "Engine/Source/Public/Rendering/Utilities.h"
 #include "Engine/Source/Public/Object/GameObject.h"
 #include "Engine/Source/Public/Rendering/Mesh.h"
+#include "Engine/Source/Public/Collision/Broadphase.h"
+#include "Engine/Source/Public/Threading/ParallelFor.h"
+
+/*
+* One colliding pair, the normal points from otherObject towards object and moving object by normal * penetrationDepth separates them.
+* Pairs that only touched part way through the motion since the last check (tunnelling) have a penetrationDepth of 0.
+*/
+struct CollisionContact
+{
+	GameObject* object = nullptr;		// Always a movable object
+	GameObject* otherObject = nullptr;
+	CollisionTypes otherCollisionType = CollisionTypes::StaticCollision;
+
+	glm::vec3 normal = glm::vec3(0.0f);
+	float penetrationDepth = 0.0f;
+
+	// Fraction of the motion since the last check where the objects first touched, 0 if they already overlapped
+	float timeOfImpact = 0.0f;
+};
+
+enum class CollisionEventType
+{
+	Enter,		// The pair started colliding this check
+	Stay,		// The pair was already colliding at the last check
+	Exit		// The pair stopped colliding, or one of the objects was unsubscribed. Only the objects in the contact are set.
+};
+
+struct CollisionEvent
+{
+	CollisionEventType type = CollisionEventType::Enter;
+	CollisionContact contact;
+};
+
+// A pair from the last check, first is always the lower address so a pair has the same key whichever object found it
+struct CachedCollisionPair
+{
+	GameObject* first = nullptr;
+	GameObject* second = nullptr;
+
+	// Latest contact between the two, sent again with the exit event
+	CollisionContact contact;
+
+	bool operator<(const CachedCollisionPair& _other) const
+	{
+		if (first != _other.first)
+			return std::less<GameObject*>()(first, _other.first);
+		return std::less<GameObject*>()(second, _other.second);
+	};
+};
+
+// Fixed capacity FIFO of collision events, the storage is allocated once so pushing never allocates
+class CollisionEventQueue
+{
+	/* Variables */
+private:
+	std::vector<CollisionEvent> events;
+	size_t head = 0;
+	size_t count = 0;
+
+	/* Functions */
+public:
+	CollisionEventQueue() { events.resize(MAX_COLLISION_EVENTS); };
+
+	// Returns false and drops the event when the queue is full
+	bool Push(const CollisionEvent& _event)
+	{
+		if (count == events.size())
+			return false;
+
+		events[(head + count) % events.size()] = _event;
+		count++;
+		return true;
+	};
+
+	bool Pop(CollisionEvent* _event)
+	{
+		if (count == 0)
+			return false;
+
+		*_event = events[head];
+		head = (head + 1) % events.size();
+		count--;
+		return true;
+	};
+
+	size_t GetCount() const { return count; };
+};
 
 class CollisionManager
 {
@@ -19,19 +107,108 @@ public:
 private:
 	std::unordered_map<CollisionTypes, std::vector<GameObject*>> collisionObserver;
 
+	// Finds the pairs that reach the exact test, can be swapped per level with SetBroadphaseType
+	Broadphase* broadphase = nullptr;
+	BroadphaseType broadphaseType = BroadphaseType::DynamicAABBTree;
+	// Only used by the spatial hash grid broadphase
+	float spatialHashCellSize = 4.0f;
+	std::unordered_map<GameObject*, int> proxyIDs;
+	std::vector<BroadphasePair> broadphasePairs;
+	std::vector<int> broadphaseProxyIDs;
+
+	// World bounds of each movable at the last check, the broadphase holds the AABB swept from here to the current bounds
+	std::unordered_map<GameObject*, AABB> previousAABBs;
+
+	// Reserved once to MAX_COLLISION_CONTACTS and reused every check, contacts past the capacity are dropped
+	std::vector<CollisionContact> contacts;
+
+	// Pairs are tested in fixed size batches, each writing to its own buffer. Merging the buffers in batch order
+	// keeps the contacts in the same order however many threads ran them.
+	const size_t narrowphaseBatchSize = 64;
+	// Starting threads is not free, a few batches are quicker on the calling thread
+	const size_t minimumBatchesPerThread = 4;
+	std::vector<std::vector<CollisionContact>> batchContacts;
+	bool contactsOverflowed = false;
+
+	// Sorted pairs from the last check, this check's sorted contacts are merged against it into nextPairCache to find
+	// enter/stay/exit and the two are swapped, so the capacity is reused every check
+	std::vector<CachedCollisionPair> pairCache;
+	std::vector<CachedCollisionPair> nextPairCache;
+	std::vector<CachedCollisionPair> contactPairs;
+
+	// Filled by every check and emptied by DispatchCollisionEvents or PollCollisionEvent
+	CollisionEventQueue collisionEvents;
+	bool eventsOverflowed = false;
+	std::vector<std::pair<int, std::function<void(const CollisionEvent&)>>> eventListeners;
+	int nextEventListenerID = 0;
+
 	/* Functions */
 public:
+	CollisionManager();
+	~CollisionManager();
 
 	// Adds an object to the collision manager.
 	void SubscribeObjectToCollisionManager(GameObject* inObject, CollisionTypes inCollisionType);
 	// Removes a specific object from the collision manager.
 	void UnsubscribeObjectFromCollisionManager(GameObject* inObject);
-	// Notifies all objects of a collision
-	std::pair<float, float> NotifyCollisionManagerOfMovement(GameObject* inObject);
-	// Checks for collisions of objects within the collision system
-	std::pair<float, float> CheckForCollisions();
+	// Checks the moved object against everything else, returns every contact it is part of
+	const std::vector<CollisionContact>& NotifyCollisionManagerOfMovement(GameObject* inObject);
+	// Checks every movable object against everything else, returns each overlapping pair once
+	const std::vector<CollisionContact>& CheckForCollisions();
+
+	/*
+	* Sweeps the object's current bounds by _displacement before it is moved and finds the first thing it would hit.
+	* Clamp the motion to displacement * timeOfImpact to stop fast objects tunnelling without substepping.
+	*/
+	bool SweepObject(GameObject* inObject, const glm::vec3& _displacement, CollisionContact* _earliestContact);
+
+	// Listeners are called for every queued event on DispatchCollisionEvents, returns the ID to remove it with
+	int AddCollisionEventListener(const std::function<void(const CollisionEvent&)>& _listener);
+	void RemoveCollisionEventListener(int _listenerID);
+	// Drains the event queue into every listener, call once after each tick's checks
+	void DispatchCollisionEvents();
+	// Takes the oldest queued event, for callers that would rather drain the queue themselves
+	bool PollCollisionEvent(CollisionEvent* _event) { return collisionEvents.Pop(_event); };
+
+	// Appends every subscribed object whose world AABB is within _radius of _center, e.g. everything within 10m
+	void QueryRadius(const glm::vec3& _center, float _radius, std::vector<GameObject*>& _results);
+
+	// Moves every subscribed object into a new broadphase of the given type
+	void SetBroadphaseType(BroadphaseType _broadphaseType);
+	// Cell size of the spatial hash grid broadphase, best around the size of a typical movable
+	void SetSpatialHashCellSize(float _cellSize);
+
+	/* Getters */
+	BroadphaseType GetBroadphaseType() { return broadphaseType; };
+	float GetSpatialHashCellSize() { return spatialHashCellSize; };
+	const Broadphase* GetBroadphase() { return broadphase; };
+
+	// Contacts from the last check, valid until the next one
+	const std::vector<CollisionContact>& GetContacts() { return contacts; };
+	// If the last check found more than MAX_COLLISION_CONTACTS contacts
+	bool GetContactsOverflowed() { return contactsOverflowed; };
+	// Earliest time of impact of the object in the last check, 1 if it did not hit anything
+	float GetEarliestTimeOfImpact(GameObject* inObject);
 
 private:
-	AABB CalculateMeshAABB(GameObject* inObject);
-	bool AABBIntersect(AABB first, AABB second);
+	// Bounds covering the object's motion since the last check
+	AABB GetSweptAABB(GameObject* _object);
+	// How far the centre of the object has moved since the last check
+	glm::vec3 GetDisplacement(GameObject* _object);
+
+	// Runs the narrowphase on every broadphase pair across threads and appends the contacts in pair order
+	void AddContacts(const std::vector<BroadphasePair>& _pairs);
+	// Exact and swept tests for one pair, safe to run from several threads once every object's world AABB is up to date
+	bool NarrowphasePair(const BroadphasePair& _pair, CollisionContact* _contact);
+	void AddContact(const CollisionContact& _contact);
+
+	/*
+	* Compares the contacts from this check against the pair cache and queues enter/stay/exit events.
+	* With _onlyObject only that object's pairs can exit, every other cached pair is carried over untouched.
+	*/
+	void UpdatePairCache(GameObject* _onlyObject);
+	void PushCollisionEvent(CollisionEventType _type, const CollisionContact& _contact);
+
+	// Fills in the normal and penetration depth if the AABBs overlap
+	bool AABBIntersect(const AABB& _first, const AABB& _second, CollisionContact* _contact);
 };
@@ -0,0 +1,129 @@
+#pragma once
+
+// Standard Library
+#include <vector>
+#include <initializer_list>
+
+// Project includes
+#include "Engine/Source/Public/Rendering/Utilities.h"
+
+struct DynamicAABBTreeNode
+{
+	// Leaves store a fattened AABB so small movements do not need the tree to be updated
+	AABB aabb;
+	class GameObject* gameObject = nullptr;
+
+	// Parent when in the tree, next free node when in the free list
+	int parentOrNext = -1;
+	int child1 = -1;
+	int child2 = -1;
+
+	// Leaf = 0, free node = -1
+	int height = -1;
+
+	bool IsLeaf() const { return child1 == -1; };
+};
+
+/*
+* Bounding volume hierarchy whose leaves can be inserted, removed and moved at any time.
+* Based on the dynamic tree in Box2D (Erin Catto): new leaves are placed where they grow the
+* tree's surface area the least and the tree is kept height balanced with AVL style rotations.
+* Proxy IDs are node indices and stay valid until DestroyProxy is called.
+*/
+class DynamicAABBTree
+{
+	/* Variables */
+public:
+	static const int NULL_NODE = -1;
+
+private:
+	std::vector<DynamicAABBTreeNode> nodes;
+	int rootNode = NULL_NODE;
+	int freeList = NULL_NODE;
+	int proxyCount = 0;
+
+	// How much leaf AABBs are grown by on every side
+	float aabbMargin;
+
+	/* Functions */
+public:
+	DynamicAABBTree(float _aabbMargin = 0.1f);
+
+	// Returns the proxy ID of the new leaf
+	int CreateProxy(const AABB& _aabb, class GameObject* _gameObject);
+	void DestroyProxy(int _proxyID);
+
+	// Only re-inserts the leaf when the new AABB has left its fat AABB. Returns true if it was re-inserted.
+	bool MoveProxy(int _proxyID, const AABB& _aabb);
+
+	/*
+	* Calls _callback(proxyID) for every leaf whose fat AABB overlaps _aabb.
+	* The callback returns false to stop the query early.
+	*/
+	template<typename Callback>
+	void Query(const AABB& _aabb, Callback&& _callback) const;
+
+	/* Getters */
+	class GameObject* GetGameObject(int _proxyID) const { return nodes[_proxyID].gameObject; };
+	const AABB& GetFatAABB(int _proxyID) const { return nodes[_proxyID].aabb; };
+	int GetProxyCount() const { return proxyCount; };
+	int GetHeight() const { return rootNode == NULL_NODE ? 0 : nodes[rootNode].height; };
+
+private:
+	int AllocateNode();
+	void FreeNode(int _nodeID);
+
+	void InsertLeaf(int _leafID);
+	void RemoveLeaf(int _leafID);
+
+	// Rotates the subtree at _nodeID if it is out of balance and returns the new root of that subtree
+	int Balance(int _nodeID);
+};
+
+template<typename Callback>
+void DynamicAABBTree::Query(const AABB& _aabb, Callback&& _callback) const
+{
+	if (rootNode == NULL_NODE)
+		return;
+
+	// Stack lives on the call stack so queries never allocate and can run from several threads at once.
+	// A balanced tree is nowhere near this deep, the vector is only there so a bad tree can not overflow it.
+	const int fixedStackSize = 256;
+	int fixedStack[fixedStackSize];
+	std::vector<int> overflowStack;
+	int stackCount = 0;
+
+	fixedStack[stackCount++] = rootNode;
+	while (stackCount > 0 || !overflowStack.empty())
+	{
+		int nodeID;
+		if (!overflowStack.empty())
+		{
+			nodeID = overflowStack.back();
+			overflowStack.pop_back();
+		}
+		else
+			nodeID = fixedStack[--stackCount];
+
+		// Scalar on purpose, unlike the flat AABBArrays users of OverlapMask8. Nodes are reached one at a time down the
+		// tree and are not contiguous, gathering them into batches of 8 would cost more than the tests it saves.
+		const DynamicAABBTreeNode& node = nodes[nodeID];
+		if (!AABBOverlaps(node.aabb, _aabb))
+			continue;
+
+		if (node.IsLeaf())
+		{
+			if (!_callback(nodeID))
+				return;
+			continue;
+		}
+
+		for (int childID : { node.child1, node.child2 })
+		{
+			if (stackCount < fixedStackSize)
+				fixedStack[stackCount++] = childID;
+			else
+				overflowStack.push_back(childID);
+		}
+	}
+}
@@ -0,0 +1,178 @@
+#pragma once
+
+// Standard Library
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+// Project includes
+#include "Engine/Source/Public/Collision/Broadphase.h"
+
+struct SpatialHashProxy
+{
+	AABB aabb;
+	class GameObject* gameObject = nullptr;
+	CollisionTypes collisionType = CollisionTypes::StaticCollision;
+
+	// Next free proxy when in the free list
+	int next = -1;
+	bool free = false;
+};
+
+// One occupied cell in the hash table, its proxies are cellProxyIDs[start, start + count)
+struct SpatialHashCell
+{
+	int x = 0;
+	int y = 0;
+	int z = 0;
+	int start = 0;
+	int count = -1;		// -1 = empty slot
+
+	bool IsEmpty() const { return count == -1; };
+};
+
+// Range of cells an AABB covers, inclusive on both ends
+struct SpatialHashCellRange
+{
+	int minimumX, minimumY, minimumZ;
+	int maximumX, maximumY, maximumZ;
+
+	// 64 bit since a huge AABB can cover more cells than fit in an int, an empty AABB covers none
+	int64_t GetCellCount() const
+	{
+		return std::max<int64_t>(0, int64_t(maximumX) - minimumX + 1) * std::max<int64_t>(0, int64_t(maximumY) - minimumY + 1) * std::max<int64_t>(0, int64_t(maximumZ) - minimumZ + 1);
+	};
+};
+
+// Open addressing (linear probing) hash table from cell coordinates to a compact list of proxy IDs
+struct SpatialHashTable
+{
+	// Capacity is always a power of two so the hash can be masked
+	std::vector<SpatialHashCell> cells;
+	std::vector<int> cellProxyIDs;
+
+	// Proxies covering more than maxCellsPerProxy cells are kept out of the cells and tested against every query
+	std::vector<int> oversizedProxyIDs;
+	// Every proxy of the table's type, in ID order. Kept up to date on create and destroy so a rebuild only walks these.
+	std::vector<int> proxyIDs;
+
+	// Set whenever one of its proxies is added, removed or moved, the table is rebuilt before it is next read
+	bool dirty = true;
+};
+
+/*
+* Uniform grid broadphase. Statics and movables each have their own hash table, rebuilt from scratch in O(n) of its
+* own proxies whenever one of them has changed and pairs or queries are asked for. There is nothing to keep balanced,
+* which suits lots of similarly sized objects that all move every tick. The per tick cost scales with the movables,
+* statics are only rebuilt when they change.
+*/
+class SpatialHashGrid : public Broadphase
+{
+	/* Variables */
+private:
+	std::vector<SpatialHashProxy> proxies;
+	int freeList = -1;
+
+	float cellSize;
+	float inverseCellSize;
+	const int maxCellsPerProxy = 64;
+
+	SpatialHashTable staticTable;
+	SpatialHashTable movableTable;
+
+	/* Functions */
+public:
+	SpatialHashGrid(float _cellSize = 4.0f);
+
+	int CreateProxy(const AABB& _aabb, class GameObject* _gameObject, CollisionTypes _collisionType) override;
+	void DestroyProxy(int _proxyID) override;
+	void MoveProxy(int _proxyID, const AABB& _aabb) override;
+
+	void UpdatePairs(std::vector<BroadphasePair>& _pairs) override;
+	void QueryProxy(int _proxyID, std::vector<BroadphasePair>& _pairs) override;
+	void QueryAABB(const AABB& _aabb, std::vector<int>& _proxyIDs) override;
+
+	// Best around the size of a typical movable, much smaller puts every object in many cells
+	void SetCellSize(float _cellSize);
+
+	/* Getters */
+	class GameObject* GetGameObject(int _proxyID) const override { return proxies[_proxyID].gameObject; };
+	CollisionTypes GetCollisionType(int _proxyID) const override { return proxies[_proxyID].collisionType; };
+	const char* GetName() const override { return "Spatial hash grid"; };
+
+	float GetCellSize() const { return cellSize; };
+
+private:
+	void RebuildIfDirty();
+	// Rebuilds the table's cells from its proxy list
+	void Rebuild(SpatialHashTable& _table);
+	SpatialHashTable& GetTable(CollisionTypes _collisionType) { return _collisionType == CollisionTypes::MovableCollision ? movableTable : staticTable; };
+
+	SpatialHashCellRange GetCellRange(const AABB& _aabb) const;
+	int GetCell(float _value) const;
+	unsigned int HashCell(int _x, int _y, int _z) const;
+
+	// Returns the slot for the cell, or the empty slot where it would go
+	int FindCellSlot(const SpatialHashTable& _table, int _x, int _y, int _z) const;
+
+	/*
+	* Adds the pairs between a movable proxy and everything its bounds overlap.
+	* With _onlyHigherMovables movable pairs are only added from the lower proxy ID so each one is added once.
+	*/
+	void AddPairs(int _proxyID, bool _onlyHigherMovables, std::vector<BroadphasePair>& _pairs) const;
+
+	// Calls _callback(proxyID) once for every proxy in the table whose AABB overlaps _aabb
+	template<typename Callback>
+	void ForEachOverlap(const SpatialHashTable& _table, const AABB& _aabb, Callback&& _callback) const;
+};
+
+template<typename Callback>
+void SpatialHashGrid::ForEachOverlap(const SpatialHashTable& _table, const AABB& _aabb, Callback&& _callback) const
+{
+	SpatialHashCellRange range = GetCellRange(_aabb);
+
+	// Very large queries touch fewer proxies by walking the list than by walking the cells
+	if (range.GetCellCount() > maxCellsPerProxy)
+	{
+		for (int proxyID : _table.proxyIDs)
+		{
+			if (AABBOverlaps(_aabb, proxies[proxyID].aabb))
+				_callback(proxyID);
+		}
+		return;
+	}
+
+	for (int z = range.minimumZ; z <= range.maximumZ; z++)
+	{
+		for (int y = range.minimumY; y <= range.maximumY; y++)
+		{
+			for (int x = range.minimumX; x <= range.maximumX; x++)
+			{
+				const SpatialHashCell& cell = _table.cells[FindCellSlot(_table, x, y, z)];
+				if (cell.IsEmpty())
+					continue;
+
+				for (int i = cell.start; i < cell.start + cell.count; i++)
+				{
+					const AABB& otherAABB = proxies[_table.cellProxyIDs[i]].aabb;
+					if (!AABBOverlaps(_aabb, otherAABB))
+						continue;
+
+					// A pair can share several cells, only the cell holding the corner where the overlap starts reports it
+					if (GetCell(std::max(_aabb.minimumX, otherAABB.minimumX)) != x ||
+						GetCell(std::max(_aabb.minimumY, otherAABB.minimumY)) != y ||
+						GetCell(std::max(_aabb.minimumZ, otherAABB.minimumZ)) != z)
+						continue;
+
+					_callback(_table.cellProxyIDs[i]);
+				}
+			}
+		}
+	}
+
+	for (int proxyID : _table.oversizedProxyIDs)
+	{
+		if (AABBOverlaps(_aabb, proxies[proxyID].aabb))
+			_callback(proxyID);
+	}
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+// Standard Library
+#include <vector>
+
+// Project includes
+#include "Engine/Source/Public/Collision/Broadphase.h"
+#include "Engine/Source/Public/Collision/AABBBatch.h"
+
+struct SweepAndPruneProxy
+{
+	AABB aabb;
+	class GameObject* gameObject = nullptr;
+	CollisionTypes collisionType = CollisionTypes::StaticCollision;
+
+	// Index in the active list while sweeping, next free proxy when in the free list
+	int activeIndexOrNext = -1;
+	bool free = false;
+};
+
+// The start or end of a proxy's AABB along the sort axis
+struct SweepAndPruneEndpoint
+{
+	float value;
+	int proxyID;
+	bool isMinimum;
+};
+
+/*
+* Sort and sweep broadphase. Keeps the AABB endpoints on one axis in a sorted array and re-sorts it with an
+* insertion sort before every sweep, which is close to O(n) when objects only move a little between frames.
+* The axis is switched to the one where the objects are most spread out when it clearly beats the current one.
+*/
+class SweepAndPrune : public Broadphase
+{
+	/* Variables */
+private:
+	std::vector<SweepAndPruneProxy> proxies;
+	std::vector<SweepAndPruneEndpoint> endpoints;
+	int freeList = -1;
+
+	// 0 = X, 1 = Y, 2 = Z
+	int sortAxis = 0;
+
+	// Endpoints added since the last sort, a lot of them is faster with a full sort than an insertion sort
+	int unsortedEndpointCount = 0;
+
+	// Proxies overlapping the sweep position and their bounds, kept between sweeps so it does not allocate.
+	// Statics entering the sweep are only tested against the active movables.
+	AABBArrays activeStaticBounds;
+	std::vector<int> activeStaticProxies;
+	AABBArrays activeMovableBounds;
+	std::vector<int> activeMovableProxies;
+
+	/* Functions */
+public:
+	int CreateProxy(const AABB& _aabb, class GameObject* _gameObject, CollisionTypes _collisionType) override;
+	void DestroyProxy(int _proxyID) override;
+	void MoveProxy(int _proxyID, const AABB& _aabb) override;
+
+	void UpdatePairs(std::vector<BroadphasePair>& _pairs) override;
+	void QueryProxy(int _proxyID, std::vector<BroadphasePair>& _pairs) override;
+	void QueryAABB(const AABB& _aabb, std::vector<int>& _proxyIDs) override;
+
+	/* Getters */
+	class GameObject* GetGameObject(int _proxyID) const override { return proxies[_proxyID].gameObject; };
+	CollisionTypes GetCollisionType(int _proxyID) const override { return proxies[_proxyID].collisionType; };
+	const char* GetName() const override { return "Sweep and prune"; };
+
+	int GetSortAxis() { return sortAxis; };
+
+private:
+	// Refreshes endpoint values from the proxies and brings the array back into order
+	void SortEndpoints();
+	// Picks the axis with the highest variance of AABB centres, returns true if it changed
+	bool ChooseSortAxis();
+
+	float GetAxisMinimum(const AABB& _aabb) const;
+	float GetAxisMaximum(const AABB& _aabb) const;
+
+	// Adds the pair with the movable proxy first, static vs static pairs are skipped
+	void AddPair(int _first, int _second, std::vector<BroadphasePair>& _pairs) const;
+};
@@ -9,10 +9,6 @@
 #include <iomanip>  // Required for std::setprecision
 #include <limits>   // Required for std::numeric_limits
 
-#include <queue>
-#include <mutex>
-#include <functional>
-
 // Third Party
 #include <vulkan/vulkan.h>
 #include <glm/glm.hpp>
@@ -21,10 +17,8 @@
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
-struct VulkanTask
-{
-	std::function<void()> function;
-};
+// Project includes
+#include "Engine/Source/Public/Threading/JobCounter.h"
 
 class EngineLevelManager
 {
@@ -32,7 +26,9 @@ class EngineLevelManager
 private:
 	class ObjectManager* seObjectManager;
 	class Renderer* seRenderer;
+	class RenderThread* seRenderThread;
 	class EngineManager* seEngineManager;
+	class JobSystem* seJobSystem;
 
 	// Basic vulkan variables needed for loading models
 	VkPhysicalDevice physicalDevice;
@@ -40,14 +36,13 @@ private:
 	VkQueue transferQueue;
 	VkCommandPool transferCommandPool;
 
-	// Multi-thread/synchronize loading objects
-	std::queue<VulkanTask> vulkanTaskQueue;
-	std::mutex taskQueueMutex;
+	// Import and upload jobs of every model still loading, they use the level manager until they have finished
+	JobCounter loadCounter;
 
 	/* Functions*/
 public:
 	EngineLevelManager() {};
-	EngineLevelManager(class Renderer* _renderer);
+	EngineLevelManager(class Renderer* _renderer, class RenderThread* _renderThread, class JobSystem* _jobSystem);
 
 	/*
 	* Loads a level from the specified file path and level name.
@@ -55,11 +50,6 @@ public:
 	*/
 	void LoadLevel(std::string inLevelFilePath);
 
-	/*
-	* Loads level models asynchronously when they are done loading
-	*/
-	void ProcessLevelModelTasks();
-
 	/*
 	* Saves a level to wherever you specify
 	*/
@@ -72,13 +62,17 @@ public:
 
 	void LoadNewScene();
 
+	// Main thread. Runs jobs until every model that is loading has been created, call it before deleting the manager.
+	void WaitForLoads();
+
 	/* Getters + Setters */
 	class ObjectManager* GetObjectManager() { return seObjectManager; };
 
 private:
 	/*
 	* Loads a MeshModel (e.g. holds multiple meshes to form one model)
-	* From the file path provided!
+	* From the file path provided! The file is imported in a job, the buffers and textures are then
+	* created by a main thread job while the render thread is held off the graphics queue.
 	*/
 	void LoadMeshModel(struct ObjectData inObject);
 };
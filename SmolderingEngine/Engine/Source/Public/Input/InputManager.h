@@ -18,8 +18,9 @@ public:
     GLFWwindow* window = nullptr;
     std::unordered_map<int, bool> keyStates;
     
-    float keyboardMovementSpeed = 1.0f;
-    float mouseMovementSpeed = 1.0f;
+    // Units per second, and degrees per pixel the mouse moves
+    float keyboardMovementSpeed = 10.0f;
+    float mouseMovementSpeed = 0.033f;
 
     float yaw = -90.0f;
     float pitch = 0.0f;
@@ -37,7 +38,6 @@ public:
     float deltaTime = 0.0f;
     float lastTime = 0.0f;
     bool playerJumping = false;
-    float floorHeight = -2.4f;
 
     bool mouseModeChanged = false;
 
@@ -53,6 +53,7 @@ public:
     void InitKeyStates();
     //void InitRendererCallback(class Renderer* inRenderer);
 
+    // Called once per fixed simulation tick, inDeltaTime is the tick interval
     void processInput(float inDeltaTime, class Camera* inCamera);
 
 private:
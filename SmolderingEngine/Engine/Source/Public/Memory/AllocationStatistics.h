@@ -0,0 +1,18 @@
+#pragma once
+
+// Standard Library
+#include <cstdint>
+#include <cstddef>
+
+// Counters kept by the engine allocators, heap calls are the blocks they get from (and give back to) operator new
+struct AllocationStatistics
+{
+	uint64_t heapAllocations = 0;
+	uint64_t heapFrees = 0;
+	// Objects handed out and given back, served from the blocks without touching the heap
+	uint64_t allocations = 0;
+	uint64_t frees = 0;
+
+	size_t bytesReserved = 0;
+	size_t liveObjects = 0;
+};
@@ -0,0 +1,90 @@
+#pragma once
+
+// Standard Library
+#include <new>
+#include <utility>
+#include <cstddef>
+#include <type_traits>
+#include <string_view>
+
+// Project includes
+#include "Engine/Source/Public/Memory/AllocationStatistics.h"
+
+struct ArenaBlock
+{
+	ArenaBlock* next = nullptr;
+	size_t size = 0;
+	size_t used = 0;
+
+	unsigned char* GetData() { return reinterpret_cast<unsigned char*>(this + 1); };
+};
+
+// Destructor of an object created in the arena, kept in the arena itself so registering one is not a heap call
+struct ArenaDestructor
+{
+	void (*destroy)(void*) = nullptr;
+	void* object = nullptr;
+	ArenaDestructor* next = nullptr;
+};
+
+/*
+* Bump allocator for data that lives exactly as long as a level. Allocating is a pointer bump into large blocks,
+* and Reset releases everything in one go, running the destructors of non trivial objects newest first.
+* The blocks are kept for the next level, so reloading a level of the same size makes no heap calls at all.
+* Not thread safe.
+*/
+class LevelArena
+{
+	/* Variables */
+private:
+	ArenaBlock* firstBlock = nullptr;
+	ArenaBlock* currentBlock = nullptr;
+	size_t blockSize;
+
+	ArenaDestructor* destructors = nullptr;
+
+	AllocationStatistics statistics;
+
+	/* Functions */
+public:
+	LevelArena(size_t _blockSize = 64 * 1024);
+	~LevelArena();
+
+	LevelArena(const LevelArena&) = delete;
+	LevelArena& operator=(const LevelArena&) = delete;
+
+	void* Allocate(size_t _size, size_t _alignment);
+
+	// The object is destructed by the next Reset, there is no way to free a single one
+	template<typename T, typename... Arguments>
+	T* Create(Arguments&&... _arguments);
+
+	// Copies _string into the arena with a null after it, the view is valid until the next Reset
+	std::string_view CreateString(std::string_view _string);
+
+	// Destructs every object and rewinds to the first block, keeping the memory
+	void Reset();
+	// Reset and give every block back to the heap
+	void Release();
+
+	/* Getters */
+	const AllocationStatistics& GetStatistics() const { return statistics; };
+};
+
+template<typename T, typename... Arguments>
+T* LevelArena::Create(Arguments&&... _arguments)
+{
+	T* object = new (Allocate(sizeof(T), alignof(T))) T(std::forward<Arguments>(_arguments)...);
+
+	if constexpr (!std::is_trivially_destructible_v<T>)
+	{
+		ArenaDestructor* destructor = new (Allocate(sizeof(ArenaDestructor), alignof(ArenaDestructor))) ArenaDestructor();
+		destructor->destroy = [](void* _object) { static_cast<T*>(_object)->~T(); };
+		destructor->object = object;
+		destructor->next = destructors;
+		destructors = destructor;
+	}
+
+	statistics.liveObjects++;
+	return object;
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+// Standard Library
+#include <new>
+#include <utility>
+#include <cstddef>
+
+// Project includes
+#include "Engine/Source/Public/Memory/AllocationStatistics.h"
+
+/*
+* Fixed size pool for one object type. Memory is taken from the heap a block of _ObjectsPerBlock objects at a time
+* and freed objects go on an intrusive free list, so Create and Destroy are O(1) and never touch the heap once the
+* pool has grown to the peak object count. Blocks are only given back when the pool itself is destroyed.
+* Not thread safe.
+*/
+template<typename T, size_t _ObjectsPerBlock = 256>
+class PoolAllocator
+{
+	/* Variables */
+private:
+	union PoolSlot
+	{
+		PoolSlot* nextFree;
+		alignas(T) unsigned char storage[sizeof(T)];
+	};
+
+	struct PoolBlock
+	{
+		PoolBlock* next;
+		PoolSlot slots[_ObjectsPerBlock];
+	};
+
+	PoolBlock* blocks = nullptr;
+	PoolSlot* freeList = nullptr;
+
+	AllocationStatistics statistics;
+
+	/* Functions */
+public:
+	PoolAllocator() {};
+	~PoolAllocator();
+
+	PoolAllocator(const PoolAllocator&) = delete;
+	PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+	template<typename... Arguments>
+	T* Create(Arguments&&... _arguments);
+	// _object must have come from this pool
+	void Destroy(T* _object);
+
+	// Grows the pool so at least _count objects fit without another heap call
+	void Reserve(size_t _count);
+
+	/* Getters */
+	const AllocationStatistics& GetStatistics() const { return statistics; };
+
+private:
+	void AllocateBlock();
+};
+
+template<typename T, size_t _ObjectsPerBlock>
+PoolAllocator<T, _ObjectsPerBlock>::~PoolAllocator()
+{
+	// Objects still alive are not destructed, their owner has to destroy them first
+	while (blocks != nullptr)
+	{
+		PoolBlock* next = blocks->next;
+		::operator delete(blocks);
+		blocks = next;
+	}
+}
+
+template<typename T, size_t _ObjectsPerBlock>
+template<typename... Arguments>
+T* PoolAllocator<T, _ObjectsPerBlock>::Create(Arguments&&... _arguments)
+{
+	if (freeList == nullptr)
+		AllocateBlock();
+
+	PoolSlot* slot = freeList;
+	freeList = slot->nextFree;
+
+	statistics.allocations++;
+	statistics.liveObjects++;
+	return new (slot->storage) T(std::forward<Arguments>(_arguments)...);
+}
+
+template<typename T, size_t _ObjectsPerBlock>
+void PoolAllocator<T, _ObjectsPerBlock>::Destroy(T* _object)
+{
+	if (_object == nullptr)
+		return;
+
+	_object->~T();
+
+	PoolSlot* slot = reinterpret_cast<PoolSlot*>(_object);
+	slot->nextFree = freeList;
+	freeList = slot;
+
+	statistics.frees++;
+	statistics.liveObjects--;
+}
+
+template<typename T, size_t _ObjectsPerBlock>
+void PoolAllocator<T, _ObjectsPerBlock>::Reserve(size_t _count)
+{
+	size_t capacity = (statistics.bytesReserved / sizeof(PoolBlock)) * _ObjectsPerBlock;
+	while (capacity < _count)
+	{
+		AllocateBlock();
+		capacity += _ObjectsPerBlock;
+	}
+}
+
+template<typename T, size_t _ObjectsPerBlock>
+void PoolAllocator<T, _ObjectsPerBlock>::AllocateBlock()
+{
+	PoolBlock* block = static_cast<PoolBlock*>(::operator new(sizeof(PoolBlock)));
+	block->next = blocks;
+	blocks = block;
+
+	// Thread the new slots onto the free list in address order so objects created together sit together
+	for (size_t i = 0; i < _ObjectsPerBlock; i++)
+		block->slots[i].nextFree = (i + 1 < _ObjectsPerBlock) ? &block->slots[i + 1] : freeList;
+	freeList = &block->slots[0];
+
+	statistics.heapAllocations++;
+	statistics.bytesReserved += sizeof(PoolBlock);
+}
@@ -2,10 +2,26 @@
 
 // Standard Library
 #include <iostream>
+#include <cstdint>
 
 // Project Includes
 #include "Object.h"
 
+/*
+* Stable reference to a GameObject, resolved with ObjectManager::GetGameObject.
+* The generation is bumped whenever the slot is freed, so a handle kept past the object's destruction
+* resolves to nullptr instead of whichever object reuses the slot.
+*/
+struct GameObjectHandle
+{
+	uint32_t index = UINT32_MAX;
+	uint32_t generation = 0;
+
+	bool IsValid() const { return index != UINT32_MAX; };
+	bool operator==(const GameObjectHandle& _other) const { return index == _other.index && generation == _other.generation; };
+	bool operator!=(const GameObjectHandle& _other) const { return !(*this == _other); };
+};
+
 class GameObject : public Object
 {
 	/* Variables */
@@ -14,16 +30,22 @@ public:
 	class MeshModel* objectMeshModel;
 
 private:
-	Model objectModel;
+	// The model matrix and bounds live in the ObjectManager's arrays, the object is only a handle into them
+	class ObjectTransforms* objectTransforms = nullptr;
+	int transformHandle = -1;
+
+	GameObjectHandle handle;
+
+	GameObject* parentObject = nullptr;
 
 
 	/* Functions */
 public:
-	GameObject();
-	GameObject(ObjectData _data, class Mesh* _mesh, class MeshModel* _meshModel);
+	GameObject(ObjectData _data, class Mesh* _mesh, class MeshModel* _meshModel, class ObjectTransforms* _transforms, int _transformHandle, GameObjectHandle _handle);
 
-	// TODO: RE-DO THESE PROPERLY
+	// Sets the translation of the local matrix, relative to the parent
 	void ApplyLocalTransform(glm::vec3 inTransform);
+	// Rotates the object about the world Y axis, children follow on the next transform update
 	void ApplyLocalYRotation(float inAngle);
 	//void ApplyGlobalTransform(glm::vec3 inTransform);
 	// void ApplyGlobalRotation
@@ -31,8 +53,22 @@ public:
 
 	/* Getters + Setters */
 public:
+	// The model matrix is the world matrix, setting it works out the local matrix under the current parent
 	void SetModel(glm::mat4 inModel) override;
 	Model GetModel() override;
+	// What to draw this frame, between the last two simulation ticks
+	Model GetRenderModel() const;
+	void SetLocalMatrix(const glm::mat4& _localMatrix);
+	const glm::mat4& GetLocalMatrix();
 	int GetUseTexture() override;
 	void SetUseTexture(int inUseTexture) override;
+
+	// Local mesh bounds transformed by the model matrix
+	const AABB& GetWorldAABB();
+	int GetTransformHandle() { return transformHandle; };
+	GameObjectHandle GetHandle() const { return handle; };
+
+	// Use ObjectManager::SetParent to change it, so the transform and child lists stay in step
+	GameObject* GetParentObject() { return parentObject; };
+	void SetParentObject(GameObject* _parent) { parentObject = _parent; };
 };
\ No newline at end of file
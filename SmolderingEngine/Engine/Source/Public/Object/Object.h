@@ -3,6 +3,7 @@
 // Standard Library
 #include <vector>
 #include <memory>
+#include <string_view>
 
 // Third party
 #include <glm/glm.hpp>
@@ -15,9 +16,11 @@ struct ObjectData
 {
 	int objectID = -1;
 	int parentID = -1;
-	std::string objectPath;
-	std::string texturePath;
-	glm::mat4 objectMatrix;
+	// Strings in the level arena (ObjectManager::GetLevelArena), so copying ObjectData never copies the paths.
+	// They stay valid until the level is unloaded.
+	std::string_view objectPath;
+	std::string_view texturePath;
+	glm::mat4 objectMatrix;		// Matrix the object was loaded with, GetModel() has the current one
 };
 
 class Object
@@ -52,6 +55,7 @@ private:
 
 public:
 	Object() {};
+	virtual ~Object() {};
 	
 
 	void AddChildObject(Object* inChild);
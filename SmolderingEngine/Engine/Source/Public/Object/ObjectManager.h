@@ -1,18 +1,69 @@
 #pragma once
 
 // Standard Library
-#include <set>
-#include <vector> // TODO: eventually maybe move to MAP instead of VECTOR to hold game objects. For now, one thing at a time.
+#include <vector>
+#include <cstdint>
 
+// Project includes
+#include "Engine/Source/Public/Object/GameObject.h"
+#include "Engine/Source/Public/Object/ObjectTransforms.h"
+#include "Engine/Source/Public/Object/ObjectUpdateScheduler.h"
+#include "Engine/Source/Public/Memory/PoolAllocator.h"
+#include "Engine/Source/Public/Memory/LevelArena.h"
+
+struct GameObjectSlot
+{
+	class GameObject* gameObject = nullptr;
+	uint32_t generation = 0;
+	// Index into the dense gameObjects list while in use, the next free slot while free
+	uint32_t denseIndexOrNextFree = UINT32_MAX;
+};
+
+// A level objectID's object, and the children loaded before it that are waiting to be parented to it
+struct LevelObjectLink
+{
+	GameObjectHandle handle;
+	uint32_t firstWaitingChild = UINT32_MAX;	// Index into waitingChildren
+};
+
+struct LevelWaitingChild
+{
+	GameObjectHandle child;
+	uint32_t next = UINT32_MAX;		// Next child waiting for the same parent
+};
+
+/*
+* Owns every GameObject in a slot map. Handles index the slots and carry a generation, so create, destroy and
+* GetGameObject are all O(1) and a handle to a destroyed object is detected instead of aliasing a new one.
+* The live objects are also kept packed in gameObjects (with the slot each came from) for iteration.
+*/
 class ObjectManager
 {
 	/* Variables */
 public:
 
 private:
-	int nextID = 0;
-	std::set<int> reusableIDs;
+	std::vector<GameObjectSlot> slots;
+	uint32_t freeSlotList = UINT32_MAX;
+
+	// Live objects packed for iteration, destroying one swaps the last object into its place
 	std::vector<class GameObject*> gameObjects;
+	std::vector<uint32_t> denseSlots;
+
+	// GameObjects come from a pool that is reused level after level, so creating one is not a heap call
+	PoolAllocator<GameObject> gameObjectPool;
+	// Load time data such as MeshModels, released in one go when the level is unloaded
+	LevelArena levelArena;
+
+	// Indexed by objectID, which levels number from 0, so parents are linked in O(1) whichever of the pair loads first.
+	// Both keep their capacity from level to level and are cleared with it.
+	std::vector<LevelObjectLink> levelObjectLinks;
+	std::vector<LevelWaitingChild> waitingChildren;
+
+	// Every game object's transform, looked up with GameObject::GetTransformHandle()
+	ObjectTransforms objectTransforms;
+	// Update callbacks run over every object each frame, then the transforms are propagated
+	ObjectUpdateScheduler updateScheduler;
 
 	// Reference to EngineManager
 	class EngineManager* seEngineManager = nullptr;
@@ -22,20 +73,41 @@ public:
 	// Creates a game object and returns it
 	class GameObject* CreateGameObject(struct ObjectData _objectData, class Mesh* _mesh, class MeshModel* _meshModel);
 	
-	// Deletes all game objects within a level
+	/*
+	* Removes the object from the scene straight away and invalidates its handle. Its children are detached and kept.
+	* The mesh buffers go to the Renderer's deletion queue so frames in flight can finish with them, nothing waits
+	* on the device. Unsubscribe it from the CollisionManager first.
+	*/
+	void DestroyGameObject(GameObjectHandle _handle);
+
+	// Deletes all game objects within a level and resets the level arena
 	void DestroyAllGameObjects();
-	//void Game::DestroyMeshes()
-	//{
-	//	// TODO: FIX
-	//	for (int i = gameObjects.size() - 1; i >= 0; i--)
-	//	{
-	//		gameObjects[i]->objectMeshModel->DestroyMeshModel();
-	//		delete gameObjects[i];
-	//		gameObjects.pop_back();
-	//	}
-	//}
+
+	// Parents _child to _parent (nullptr to detach) keeping its world position, returns false if it would make a cycle
+	bool SetParent(class GameObject* _child, class GameObject* _parent);
+	// The update phase: runs the update callbacks and brings every world matrix and AABB up to date on the engine's
+	// job system. Call once per fixed simulation tick, _deltaTime is the tick interval.
+	void UpdateObjects(float _deltaTime);
+	// How far the frame being drawn is between the last two ticks, see ObjectTransforms::GetRenderModel
+	void SetInterpolationAlpha(float _alpha) { objectTransforms.SetInterpolationAlpha(_alpha); };
 
 	/* Getters + Setters */
 
-	const std::vector<class GameObject*> GetGameObjects() { return gameObjects; };
+	// Returns nullptr if the object has been destroyed
+	class GameObject* GetGameObject(GameObjectHandle _handle) const;
+	// Every live object in no particular order, destroying an object moves the last one into its place
+	const std::vector<class GameObject*>& GetGameObjects() const { return gameObjects; };
+	ObjectTransforms* GetObjectTransforms() { return &objectTransforms; };
+	ObjectUpdateScheduler* GetUpdateScheduler() { return &updateScheduler; };
+	LevelArena* GetLevelArena() { return &levelArena; };
+	const AllocationStatistics& GetGameObjectPoolStatistics() const { return gameObjectPool.GetStatistics(); };
+
+private:
+	GameObjectHandle AllocateSlot();
+	void FreeSlot(GameObjectHandle _handle);
+	// Releases the GPU buffers of its mesh and gives the object back to the pool, the MeshModel memory stays in the level arena
+	void DeleteGameObject(class GameObject* _gameObject);
+
+	// Level objects load in any order, so parents are linked by objectID whichever of the pair is created second
+	void LinkLevelParents(class GameObject* _gameObject);
 };
\ No newline at end of file
@@ -0,0 +1,132 @@
+#pragma once
+
+// Standard Library
+#include <vector>
+#include <cstdint>
+
+// Project includes
+#include "Engine/Source/Public/Rendering/Utilities.h"
+
+enum ObjectTransformFlags : uint8_t
+{
+	TRANSFORM_FLAG_NONE = 0,
+	TRANSFORM_FLAG_WORLD_AABB_DIRTY = 1 << 0,		// The world matrix changed since the world AABB was last calculated
+	TRANSFORM_FLAG_LOCAL_DIRTY = 1 << 1,			// The local matrix changed, the world matrices of it and its children need updating
+	TRANSFORM_FLAG_WORLD_CHANGED = 1 << 2,			// The world matrix was recalculated by the current UpdateWorldMatrices pass
+	TRANSFORM_FLAG_REMOVED = 1 << 3,				// A hole left by Remove, dropped by the next sort
+};
+
+/*
+* Transforms, bounds and flags of every GameObject in structure of arrays form, owned by the ObjectManager.
+* Systems that touch every object (culling, instance upload, collision) stream through each array in order
+* instead of chasing one heap allocation per object.
+*
+* The arrays are kept sorted so every parent comes before its children, which lets UpdateWorldMatrices rebuild
+* the world matrices of every moved subtree in one forward pass. Sorting moves transforms around, so a GameObject
+* holds a handle that stays the same for its lifetime and is mapped to the current index.
+*/
+class ObjectTransforms
+{
+	/* Variables */
+private:
+	// World matrix and texture flag, laid out exactly as the push constant so it can be uploaded as is
+	std::vector<Model> models;
+	std::vector<glm::mat4> localMatrices;
+	// Index of the parent transform, -1 for root objects. Always lower than the child's own index once sorted.
+	std::vector<int> parentIndices;
+	std::vector<AABB> localAABBs;
+	std::vector<AABB> worldAABBs;
+	std::vector<uint8_t> flags;
+
+	// World matrices at the start of the current simulation tick, rendering blends from these to the models
+	std::vector<glm::mat4> previousWorldMatrices;
+	float interpolationAlpha = 1.0f;
+
+	std::vector<int> handleToIndex;
+	std::vector<int> indexToHandle;
+	std::vector<int> freeHandles;
+
+	// Every transform of depth d is in [depthStarts[d], depthStarts[d + 1]), so a whole depth can be updated at once
+	std::vector<int> depthStarts;
+
+	// A parent changed or a transform was removed, so the arrays have to be re-sorted before the next update
+	bool hierarchyDirty = false;
+	// Any local matrix changed since the last update, nothing to do otherwise
+	bool transformsDirty = false;
+	// Any world matrix or bound changed since the last TakeWorldChanged, so anything built from world bounds is stale
+	bool worldChanged = false;
+
+	// Transforms per job in the parallel updates, enough work per job to hide the cost of starting it
+	static const size_t updateChunkSize = 1024;
+
+	/* Functions */
+public:
+	// Returns the handle of the new transform, it starts as a root with _modelMatrix as its local and world matrix
+	int Add(const glm::mat4& _modelMatrix, const AABB& _localAABB);
+	// Leaves a hole that the next UpdateWorldMatrices packs away, so it never moves other transforms. Children must be detached first.
+	void Remove(int _handle);
+	void Clear();
+
+	// Sets the parent, -1 for none. The world matrix is kept, so the local matrix becomes relative to the new parent.
+	void SetParent(int _handle, int _parentHandle);
+
+	void SetLocalMatrix(int _handle, const glm::mat4& _localMatrix);
+	// Sets the local matrix that puts the transform at _worldMatrix under its current parent
+	void SetWorldMatrix(int _handle, const glm::mat4& _worldMatrix);
+	void SetUseTexture(int _handle, int _useTexture) { models[handleToIndex[_handle]].useTexture = _useTexture; };
+	void SetLocalAABB(int _handle, const AABB& _localAABB);
+
+	/*
+	* Index based access for the update phase, where jobs own disjoint index ranges. Setting a local matrix only touches
+	* that index, the world matrix is left for UpdateWorldMatrices and MarkLocalMatricesChanged must be called after.
+	*/
+	const glm::mat4& GetLocalMatrixAt(size_t _index) const { return localMatrices[_index]; };
+	void SetLocalMatrixAt(size_t _index, const glm::mat4& _localMatrix) { localMatrices[_index] = _localMatrix; flags[_index] |= TRANSFORM_FLAG_LOCAL_DIRTY; };
+	int GetHandleAt(size_t _index) const { return indexToHandle[_index]; };
+	void MarkLocalMatricesChanged() { transformsDirty = true; };
+
+	// Sorts the hierarchy into parents first order if a parent changed or a transform was added or removed
+	void UpdateHierarchy() { if (hierarchyDirty) SortHierarchy(); };
+
+	// Call at the start of every simulation tick, keeps the current world matrices to interpolate from
+	void BeginTick(class JobSystem* _jobSystem = nullptr);
+	// How far rendering is between the previous tick and the latest one, 0 to 1
+	void SetInterpolationAlpha(float _alpha) { interpolationAlpha = _alpha; };
+
+	// Sorts the hierarchy if it changed, then recalculates the world matrix of every transform whose local matrix
+	// or any ancestor's local matrix changed since the last update. Call once per frame before anything reads the world.
+	// With a job system each depth is split into chunks run in parallel, parents are always a depth ahead of their children.
+	void UpdateWorldMatrices(class JobSystem* _jobSystem = nullptr);
+
+	// Recalculates the world AABB of every transform that moved, in one pass over the arrays (in parallel chunks with a job system)
+	void UpdateWorldAABBs(class JobSystem* _jobSystem = nullptr);
+
+	// True if a world matrix or bound changed (set directly, by a parent change or by UpdateWorldMatrices) since the last call
+	bool TakeWorldChanged() { bool changed = worldChanged; worldChanged = false; return changed; };
+
+	/* Getters */
+	const Model& GetModel(int _handle) const { return models[handleToIndex[_handle]]; };
+	// The model to draw this frame, blended between the last two ticks. Matrices are blended linearly, close enough
+	// for the rotation one tick adds.
+	Model GetRenderModel(int _handle) const;
+	const glm::mat4& GetLocalMatrix(int _handle) const { return localMatrices[handleToIndex[_handle]]; };
+	const AABB& GetLocalAABB(int _handle) const { return localAABBs[handleToIndex[_handle]]; };
+	// Recalculated first if the transform moved since the last call
+	const AABB& GetWorldAABB(int _handle);
+	int GetParent(int _handle) const;
+
+	// Arrays in hierarchy order, only valid until the next UpdateWorldMatrices
+	const std::vector<Model>& GetModels() const { return models; };
+	const std::vector<AABB>& GetWorldAABBs() const { return worldAABBs; };
+	size_t GetCount() const { return models.size(); };
+
+private:
+	// Stable sort by depth so parents come first and siblings keep their order
+	void SortHierarchy();
+
+	// Recalculates the world matrices in [_first, _last) whose local or parent world matrix changed
+	void UpdateWorldMatrixRange(size_t _first, size_t _last);
+	void UpdateWorldAABBRange(size_t _first, size_t _last);
+
+	const glm::mat4& GetParentWorldMatrix(int _index) const;
+};
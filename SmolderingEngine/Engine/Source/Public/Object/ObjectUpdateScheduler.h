@@ -0,0 +1,80 @@
+#pragma once
+
+// Standard Library
+#include <vector>
+#include <string>
+#include <functional>
+#include <algorithm>
+#include <cstdint>
+
+// What an update callback touches, used to work out which callbacks can run at the same time
+enum ObjectUpdateAccess : uint32_t
+{
+	OBJECT_ACCESS_NONE = 0,
+	OBJECT_ACCESS_LOCAL_MATRICES = 1 << 0,
+	OBJECT_ACCESS_WORLD_MATRICES = 1 << 1,		// Read only for callbacks, they see last frame's world until propagation runs
+	OBJECT_ACCESS_WORLD_AABBS = 1 << 2,			// Read only for callbacks, same as the world matrices
+	OBJECT_ACCESS_GAME_OBJECTS = 1 << 3,		// Any other per object state, e.g. members of the GameObject or the caller's own arrays
+
+	// Bits from here up are free for game systems to name their own data
+	OBJECT_ACCESS_USER = 1 << 8,
+};
+
+// The transforms a callback is given, it may only touch indices in [first, last)
+struct ObjectUpdateChunk
+{
+	class ObjectTransforms* transforms;
+	float deltaTime;
+	size_t first;
+	size_t last;
+};
+
+using ObjectUpdateFunction = std::function<void(const ObjectUpdateChunk&)>;
+
+struct ObjectUpdateCallback
+{
+	int id;
+	std::string name;
+	uint32_t reads;
+	uint32_t writes;
+	ObjectUpdateFunction function;
+};
+
+/*
+* The per frame update phase, run before culling and rendering. Every callback declares what it reads and writes,
+* callbacks that do not conflict share a stage and a stage runs all its callbacks over every object at once, split
+* into chunks of neighbouring transforms. Callbacks that do conflict run in the order they were added.
+* Transform propagation always runs last, as its own stage.
+*/
+class ObjectUpdateScheduler
+{
+	/* Variables */
+private:
+	std::vector<ObjectUpdateCallback> callbacks;
+	int nextCallbackID = 0;
+
+	// Callback indices grouped into stages, rebuilt when callbacks are added or removed
+	std::vector<std::vector<size_t>> stages;
+	bool stagesDirty = false;
+
+	// Objects per job, enough to hide the cost of a job while keeping every core busy with 100k objects
+	size_t chunkSize = 512;
+
+	/* Functions */
+public:
+	// Returns an ID to remove it with. World matrices and AABBs can not be written, only the propagation writes them.
+	int AddUpdateCallback(const std::string& _name, uint32_t _reads, uint32_t _writes, ObjectUpdateFunction _function);
+	void RemoveUpdateCallback(int _id);
+
+	// Runs every callback then propagates the transforms. Serially on this thread without a job system.
+	void Update(float _deltaTime, class ObjectTransforms* _transforms, class JobSystem* _jobSystem);
+
+	void SetChunkSize(size_t _chunkSize) { chunkSize = std::max<size_t>(1, _chunkSize); };
+
+	/* Getters */
+	size_t GetStageCount();
+
+private:
+	void BuildStages();
+	static bool Conflicts(const ObjectUpdateCallback& _a, const ObjectUpdateCallback& _b);
+};
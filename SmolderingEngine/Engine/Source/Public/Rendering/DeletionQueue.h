@@ -0,0 +1,78 @@
+#pragma once
+
+// Standard Library
+#include <deque>
+#include <cstdint>
+
+// Third Party
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+enum class DeferredDeletionType : uint8_t
+{
+	Buffer,
+	Image,
+	ImageView,
+	DeviceMemory,
+	Sampler,
+	DescriptorSet,
+};
+
+// One Vulkan handle waiting for the frames that may still use it to finish
+struct DeferredDeletion
+{
+	DeferredDeletionType type;
+	union
+	{
+		VkBuffer buffer;
+		VkImage image;
+		VkImageView imageView;
+		VkDeviceMemory memory;
+		VkSampler sampler;
+		VkDescriptorSet descriptorSet;
+	};
+	// Pool the descriptor set is freed back to, it must have been created with VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT
+	VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+
+	uint64_t retiredFrameNumber;		// Frame number at the time it was released
+};
+
+/*
+* Frame safe replacement for vkDeviceWaitIdle before destroying resources. Released handles are tagged with the
+* frame being built and destroyed once the Renderer has waited on that frame's fence, MAX_FRAME_DRAWS frames later.
+* Anything can be released at any point of the frame without stalling the GPU. Only used while holding
+* RenderThread::LockDevice, releases that a snapshot may still point at also need RenderThread::LockFrame.
+*/
+class DeletionQueue
+{
+	/* Variables */
+private:
+	VkDevice logicalDevice;
+
+	// Tagged in release order, so the frame numbers never go down and only the front has to be checked
+	std::deque<DeferredDeletion> deletions;
+	uint64_t frameNumber = 0;
+
+	/* Functions */
+public:
+	DeletionQueue(VkDevice _logicalDevice);
+
+	// Called by the Renderer once this frame's fence has signaled, destroys everything no frame in flight can use
+	void BeginFrame(uint64_t _frameNumber);
+	// Destroys everything straight away, only when the device is idle (shutdown)
+	void DestroyAll();
+
+	void ReleaseBuffer(VkBuffer _buffer);
+	void ReleaseImage(VkImage _image);
+	void ReleaseImageView(VkImageView _imageView);
+	void ReleaseMemory(VkDeviceMemory _memory);
+	void ReleaseSampler(VkSampler _sampler);
+	void ReleaseDescriptorSet(VkDescriptorPool _descriptorPool, VkDescriptorSet _descriptorSet);
+
+	/* Getters */
+	size_t GetPendingCount() const { return deletions.size(); };
+
+private:
+	void Push(DeferredDeletion& _deletion);
+	void Destroy(const DeferredDeletion& _deletion);
+};
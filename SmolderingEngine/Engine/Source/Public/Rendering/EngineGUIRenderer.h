@@ -10,6 +10,9 @@
 #include <backends/imgui_impl_glfw.h>
 #include <backends/imgui_impl_vulkan.h>
 
+// Project Includes
+#include "Engine/Source/Public/Object/GameObject.h"
+
 class EngineGUIRenderer
 {
 	/* Variables */
@@ -21,8 +24,8 @@ private:
 	VkDescriptorPool imguiDescriptorPool = VK_NULL_HANDLE;
 
 	// Handle GUI input
-	/* What model ID is currently selected */
-	int currentSelectedModelID = 0;
+	/* Which object is currently selected, goes stale by itself if the object is destroyed */
+	GameObjectHandle selectedObject;
 
 private:
 	class EngineManager* seEngineManager = nullptr;
@@ -30,6 +33,10 @@ private:
 	/* Engine GUI bools */
 	bool shouldSaveLevel = false;
 	bool shouldLoadLevel = false;
+	bool shouldDestroySelected = false;
+
+	// How many frames the depth pre-pass benchmark renders with and without the pre-pass
+	const int benchmarkFramesPerMode = 300;
 
 
 	/* Functions */
@@ -38,15 +45,24 @@ public:
 	EngineGUIRenderer(const VulkanResources* _resources);
 	void DestroyEngineGUIRenderer();
 	
-	// Draw the GUI
-	void RecordToCommandBuffer(VkCommandBuffer _commandBuffer, uint32_t _imageIndex);
+	// Simulation thread. Builds this frame's GUI and copies its draw lists into the snapshot.
+	void BuildFrame(struct RenderSnapshot& _snapshot);
+
+	// Render thread. Draws the GUI that was built for the snapshot being recorded.
+	void RecordToCommandBuffer(VkCommandBuffer _commandBuffer, uint32_t _frameIndex, const struct GUIDrawData& _drawData);
 
-	// Process any GUI commands that may need to be done prior to rendering
+	// Simulation thread. Process any GUI commands that may need to be done before the next snapshot
 	void ProcessEngineGUIInputs();
 
 private:
 	bool InitImGUI();
 
+	// Shows GPU timings from the FrameProfiler, CPU timings from the FrameTimeline and the renderer toggles
+	void DrawRendererStatistics(struct RenderSnapshot& _snapshot);
+
+	// Selects the object under the mouse on left click, using a SceneQuery raycast
+	void PickObjectUnderMouse();
+
 	// Helper Functions
 	void ResultCheck(VkResult _error);
 };
\ No newline at end of file
@@ -0,0 +1,106 @@
+#pragma once
+
+// Standard Library
+#include <array>
+#include <string>
+#include <mutex>
+#include <atomic>
+
+// Third Party
+#define GLFW_INCLUDE_VULKAN
+#include <GLFW/glfw3.h>
+
+// Project includes
+#include "Engine/Source/Public/Rendering/Utilities.h"
+
+// Points in the frame a GPU timestamp is written, in the order they are written
+enum FrameTimestamp : uint32_t
+{
+	TIMESTAMP_SCENE_BEGIN = 0,
+	TIMESTAMP_DEPTH_PREPASS_END,
+	TIMESTAMP_OPAQUE_END,
+	TIMESTAMP_SKYBOX_END,
+	TIMESTAMP_TRANSPARENT_END,
+
+	TIMESTAMP_COUNT
+};
+
+// GPU timings (milliseconds) and counters for the scene part of one frame
+struct FrameStatistics
+{
+	bool valid = false;
+	bool usedDepthPrePass = false;
+
+	double depthPrePassTime = 0.0;
+	double opaqueTime = 0.0;
+	double skyboxTime = 0.0;
+	double transparentTime = 0.0;
+	double sceneTime = 0.0;
+
+	uint64_t fragmentShaderInvocations = 0;
+};
+
+class FrameProfiler
+{
+	/* Variables */
+public:
+
+private:
+	/* Struct that holds general vulkan resources (already created by Renderer) */
+	const struct VulkanResources* vulkanResources;
+
+	// One set of queries per frame in flight so reading last frame's results never waits on the GPU
+	VkQueryPool timestampQueryPool = VK_NULL_HANDLE;
+	VkQueryPool statisticsQueryPool = VK_NULL_HANDLE;
+	std::array<bool, MAX_FRAME_DRAWS> queriesWritten = {};
+	std::array<bool, MAX_FRAME_DRAWS> frameUsedDepthPrePass = {};
+	std::array<bool, MAX_FRAME_DRAWS> frameInBenchmark = {};
+
+	// Nanoseconds per timestamp tick
+	float timestampPeriod = 0.0f;
+	bool timestampsSupported = false;
+	bool statisticsSupported = false;
+
+	// Results are written by the render thread and shown by the GUI on the simulation thread
+	std::mutex resultsMutex;
+	FrameStatistics latestStatistics;
+
+	// Depth pre-pass benchmark, renders framesPerMode frames without the pre-pass and then framesPerMode with it
+	std::atomic<bool> benchmarkRunning{ false };
+	int benchmarkFramesPerMode = 0;
+	int benchmarkFramesRequested = 0;
+	int benchmarkFramesCollected = 0;
+	bool benchmarkFrameRequested = false;		// If the frame being recorded counts towards the benchmark
+	std::array<FrameStatistics, 2> benchmarkTotals;		// [0] = without pre-pass, [1] = with pre-pass
+	std::string benchmarkReport;		// Guarded by resultsMutex
+
+	/* Functions */
+public:
+	FrameProfiler() {};
+	FrameProfiler(const VulkanResources* _resources, uint32_t _graphicsQueueFamily);
+	void DestroyFrameProfiler();
+
+	// Recording, reset must happen outside of the render pass
+	void ResetQueries(VkCommandBuffer _commandBuffer, uint32_t _frameIndex, bool _usingDepthPrePass);
+	void WriteTimestamp(VkCommandBuffer _commandBuffer, uint32_t _frameIndex, FrameTimestamp _timestamp);
+	void BeginStatistics(VkCommandBuffer _commandBuffer, uint32_t _frameIndex);
+	void EndStatistics(VkCommandBuffer _commandBuffer, uint32_t _frameIndex);
+
+	// Reads back the queries of a frame whose fence has already been waited on
+	void CollectResults(uint32_t _frameIndex);
+
+	// Render thread, the GUI asks for it through RenderSnapshot::depthPrePassBenchmarkFrames
+	void StartDepthPrePassBenchmark(int _framesPerMode);
+	// While the benchmark runs it decides if the pre-pass is used, returns false when it is not running
+	bool GetBenchmarkDepthPrePass(bool* _useDepthPrePass);
+
+	/* Getters */
+	// Copies, as the render thread may be writing new results
+	FrameStatistics GetLatestStatistics();
+	std::string GetBenchmarkReport();
+	bool IsBenchmarkRunning() { return benchmarkRunning; };
+	bool IsStatisticsSupported() { return statisticsSupported; };
+
+private:
+	void AccumulateBenchmark(const FrameStatistics& _statistics);
+};
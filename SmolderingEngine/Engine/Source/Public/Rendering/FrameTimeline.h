@@ -0,0 +1,86 @@
+#pragma once
+
+// Standard Library
+#include <array>
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+
+// CPU phases of a frame. The simulation thread runs the first ones, the render thread (or the main thread with the
+// render thread off) the rest.
+enum FramePhase : uint32_t
+{
+	PHASE_SIMULATION = 0,		// Window events, main thread jobs and the fixed ticks
+	PHASE_SNAPSHOT,				// GUI and copying the scene into the next snapshot
+	PHASE_HANDOFF,				// Waiting for the render thread to take the previous snapshot
+
+	PHASE_RENDER_IDLE,			// Render thread waiting for a snapshot
+	PHASE_FRAME_WAIT,			// Frame in flight fence and swapchain image acquire
+	PHASE_RECORD,				// Sorting the snapshot into draw commands and recording them
+	PHASE_SUBMIT,				// Queue submit and present
+
+	PHASE_COUNT
+};
+
+// Averages over the last reporting period, in milliseconds per drawn frame
+struct FrameTimeBreakdown
+{
+	bool valid = false;
+	int frameCount = 0;
+
+	double frameTime = 0.0;
+	std::array<double, PHASE_COUNT> phaseTimes = {};
+
+	// Time the simulation thread was busy (simulation and snapshot) while a frame was being recorded or submitted
+	double overlapTime = 0.0;
+};
+
+/*
+* CPU side companion to the FrameProfiler. Each thread records how long it spent in each FramePhase, and every
+* reporting period the phases are averaged per drawn frame. Simulation and render intervals are also intersected,
+* which shows how much of the frame the two threads actually spend working at the same time. Any thread.
+*/
+class FrameTimeline
+{
+	/* Variables */
+public:
+	using Clock = std::chrono::steady_clock;
+
+private:
+	struct PhaseInterval
+	{
+		Clock::time_point start;
+		Clock::time_point end;
+	};
+
+	std::mutex timelineMutex;
+
+	// Busy intervals of this period. Each list is only written by one thread at a time, so it stays in time order.
+	std::vector<PhaseInterval> simulationIntervals;
+	std::vector<PhaseInterval> renderIntervals;
+	std::array<double, PHASE_COUNT> phaseTotals = {};
+	int frameCount = 0;
+	Clock::time_point periodStart = Clock::now();
+
+	const std::chrono::milliseconds reportPeriod{ 500 };
+	FrameTimeBreakdown latestBreakdown;
+
+	/* Functions */
+public:
+	FrameTimeline() {};
+
+	static Clock::time_point Now() { return Clock::now(); };
+
+	// Adds the time from _start until now to _phase
+	void Record(FramePhase _phase, Clock::time_point _start);
+	// Called once a frame has been presented, folds the period into a breakdown when it is over
+	void EndFrame();
+
+	/* Getters */
+	FrameTimeBreakdown GetLatestBreakdown();
+
+private:
+	// Total time the two lists of intervals overlap, both in time order
+	static double IntersectIntervals(const std::vector<PhaseInterval>& _a, const std::vector<PhaseInterval>& _b);
+};
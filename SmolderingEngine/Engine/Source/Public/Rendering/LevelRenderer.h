@@ -8,6 +8,33 @@
 
 // Project includes
 #include "Engine/Source/Public/Rendering/Renderer.h"
+#include "Engine/Source/Public/Rendering/RenderSnapshot.h"
+
+// Bits that make up a key into the level pipeline table. Alpha blend must stay the highest bit so opaque batches sort first.
+enum LevelPipelineFlags : uint32_t
+{
+	PIPELINE_FLAG_NONE = 0,
+	PIPELINE_FLAG_TEXTURED = 1 << 0,
+	PIPELINE_FLAG_DEPTH_EQUAL = 1 << 1,		// Opaque pass following a depth pre-pass, never combined with alpha blend
+	PIPELINE_FLAG_ALPHA_BLEND = 1 << 2,
+
+	PIPELINE_VARIANT_COUNT = 1 << 3
+};
+
+// Keys that can be drawn with. Depth equal with alpha blend never happens, so those variants are not built.
+inline bool IsValidPipelineKey(uint32_t _key)
+{
+	return !((_key & PIPELINE_FLAG_DEPTH_EQUAL) && (_key & PIPELINE_FLAG_ALPHA_BLEND));
+}
+
+// A single mesh to draw and the pipeline variant it needs
+struct LevelDrawCommand
+{
+	uint32_t pipelineKey;
+	const RenderInstance* instance;
+	class Mesh* mesh;
+	VkDescriptorSet textureDescriptorSet;		// From the snapshot, VK_NULL_HANDLE when the mesh has no texture
+};
 
 class LevelRenderer
 {
@@ -18,10 +45,17 @@ private:
 	/* Struct that holds general vulkan resources (already created by Renderer) */
 	const VulkanResources* vulkanResources;
 
-	// Graphics pipeline
-	VkPipeline graphicsPipeline;
+	// Graphics pipeline variants, indexed by LevelPipelineFlags. All share one layout, invalid keys are VK_NULL_HANDLE.
+	std::array<VkPipeline, PIPELINE_VARIANT_COUNT> graphicsPipelines;
 	VkPipelineLayout graphicsPipelineLayout;
 
+	// Vertex only pipeline that fills the depth buffer before the opaque pass
+	VkPipeline depthPrePassPipeline;
+
+	// Rebuilt every frame, kept as a member so it does not reallocate. Opaque draws come first, then transparent.
+	std::vector<LevelDrawCommand> drawCommands;
+	size_t transparentDrawStart = 0;
+
 	// Use push constants to make things move
 	VkPushConstantRange pushConstantRange;
 
@@ -43,6 +77,9 @@ private:
 	std::vector<VkDeviceMemory> textureImageMemory;
 	std::vector<VkImageView> textureImageViews;
 
+	// If a texture has any non-opaque pixels, indexed the same as samplerDescriptorSets
+	std::vector<bool> samplerHasTransparency;
+
 	/* Functions */
 public:
 	LevelRenderer() {};
@@ -52,10 +89,17 @@ public:
 	// Destroys all textures that the level renderer holds
 	void DestroyAllRendererTextures();
 
-	// Handle drawing commands
-	void RecordToCommandBuffer(VkCommandBuffer _commandBuffer, uint32_t _imageIndex);
-	void UpdateUniformBuffer(const class Camera* _camera, uint32_t _imageIndex);
-	void ResizeRenderer();
+	// Simulation thread. Copies every level object's mesh and interpolated model into _instances.
+	void CollectInstances(std::vector<RenderInstance>& _instances);
+	// Simulation thread. Copies the texture descriptor sets and their transparency, indexed by texture ID.
+	void CollectTextures(std::vector<VkDescriptorSet>& _descriptorSets, std::vector<bool>& _hasTransparency);
+
+	// Handle drawing commands, PrepareDrawCommands must be called first each frame
+	void PrepareDrawCommands(const RenderSnapshot& _snapshot, bool _depthPrePass);
+	void RecordDepthPrePass(VkCommandBuffer _commandBuffer, uint32_t _frameIndex);
+	void RecordOpaqueToCommandBuffer(VkCommandBuffer _commandBuffer, uint32_t _frameIndex);
+	void RecordTransparentToCommandBuffer(VkCommandBuffer _commandBuffer, uint32_t _frameIndex);
+	void UpdateUniformBuffer(const UniformBufferObjectViewProjection& _viewProjection, uint32_t _frameIndex);
 
 	// Create needed resources
 	void CreateDescriptorSetLayout();
@@ -74,7 +118,10 @@ public:
 
 	// Handles textures
 	stbi_uc* LoadTextureFile(std::string _fileName, int* _width, int* _height, VkDeviceSize* _imageSize);
-	int CreateTextureImage(std::string _fileName);
+	int CreateTextureImage(std::string _fileName, bool* _hasTransparency);
 	int CreateTexture(std::string _fileName);
 	int CreateTextureDescriptor(VkImageView _textureImage);
+
+private:
+	void RecordDrawCommands(VkCommandBuffer _commandBuffer, uint32_t _frameIndex, size_t _first, size_t _last);
 };
\ No newline at end of file
@@ -10,8 +10,24 @@
 
 // Engine
 #include "Engine/Source/Public/Rendering/Utilities.h"
+#include "Engine/Source/Public/SceneQuery/TriangleBVH.h"
 
+// The CPU side of a mesh, built by the import job on a worker and moved into a Mesh when it is uploaded on the main thread
+struct MeshData
+{
+	std::vector<Vertex> vertices;
+	std::vector<uint32_t> indices;
+
+	std::vector<glm::vec3> vertexPositions;
+	AABB localAABB;
+	TriangleBVH triangleBVH;
+
+	unsigned int materialIndex = 0;
+	bool alphaBlend = false;
 
+	// Fills in the positions, bounds and triangle BVH from vertices and indices
+	void BuildQueryData();
+};
 
 class Mesh
 {
@@ -19,11 +35,14 @@ class Mesh
 private:
 	// Vertex
 	std::vector<glm::vec3> initialVertexPositions;
+	AABB localAABB;		// Object space bounds, calculated once on load
 	int vertexCount;
 	VkBuffer vertexBuffer;
 	VkDeviceMemory vertexBufferMemory;
 
 	// Index
+	std::vector<uint32_t> initialIndices;		// CPU copy for scene queries
+	TriangleBVH triangleBVH;		// Object space, built once on load
 	int indexCount;
 	VkBuffer indexBuffer;
 	VkDeviceMemory indexBufferMemory;
@@ -37,24 +56,35 @@ private:
 
 	int useTexture;
 
+	// Set from the material opacity, these meshes are drawn with blending after all opaque ones
+	bool alphaBlend = false;
+
 	/* Functions */
 public:
 	Mesh();
+	// Uploads the vertex and index buffers and takes the rest of inMeshData over without copying it
 	Mesh(VkPhysicalDevice inPhysicalDevice, VkDevice inLogicalDevice, VkQueue inTransferQueue, VkCommandPool inTransferCommandPool,
-		std::vector<Vertex>* inVertices, std::vector<uint32_t>* inIndicies);
-	void DestroyMesh();
+		MeshData&& inMeshData);
+	// Hands the vertex and index buffers to the deletion queue, they are destroyed once no frame in flight uses them
+	void DestroyMesh(class DeletionQueue* _deletionQueue);
 
 	void SetTextureFilePath(std::string inFilePath);
 	std::string GetTextureFilePath();
 
 	int GetTextureID();
 	void SetTextureID(int inTextureID);
+
+	bool GetAlphaBlend();
+	void SetAlphaBlend(bool inAlphaBlend);
 	
 	int GetVertexCount();
 	VkBuffer GetVertexBuffer();	
-	std::vector<glm::vec3> GetVertices();
+	const std::vector<glm::vec3>& GetVertices();
+	const AABB& GetLocalAABB() { return localAABB; };
 	
 	int GetIndexCount();
+	const std::vector<uint32_t>& GetIndices() { return initialIndices; };
+	const TriangleBVH& GetTriangleBVH() { return triangleBVH; };
 	VkBuffer GetIndexBuffer();
 
 private:
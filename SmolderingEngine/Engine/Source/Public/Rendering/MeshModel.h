@@ -18,20 +18,28 @@ public:
 	std::vector<Mesh> meshList;
 	//glm::mat4 model;
 
+private:
+	// Bounds of every mesh in the model, in object space
+	AABB localAABB;
+
 	/* Functions */
 public:
 	MeshModel();
-	MeshModel(std::vector<Mesh> inMeshList);
-	void DestroyMeshModel();
+	// Takes the meshes over without copying their vertex, index and BVH data
+	MeshModel(std::vector<Mesh>&& inMeshList);
+	void DestroyMeshModel(class DeletionQueue* _deletionQueue);
 
 	static std::vector<std::string> LoadMaterials(const aiScene* inScene);
-	static std::vector<Mesh> LoadNode(VkPhysicalDevice inPhysicalDevice, VkDevice inLogicalDevice, VkQueue inTransferQueue, VkCommandPool inTransferCommandPool,
-		aiNode* inNode, const aiScene* inScene, std::vector<int> inMaterialToTexture);
-	static Mesh LoadMesh(VkPhysicalDevice inPhysicalDevice, VkDevice inLogicalDevice, VkQueue inTransferQueue, VkCommandPool inTransferCommandPool,
-		aiMesh* inMesh, const aiScene* inScene, std::vector<int> inMaterialToTexture);
+	// Any thread. Appends the CPU side data of the meshes of inNode and all its children to outMeshData
+	static void LoadNode(aiNode* inNode, const aiScene* inScene, std::vector<MeshData>& outMeshData);
+	static MeshData LoadMesh(aiMesh* inMesh, const aiScene* inScene);
+	// Main thread. Uploads every mesh and sets the texture of its material
+	static std::vector<Mesh> CreateMeshes(VkPhysicalDevice inPhysicalDevice, VkDevice inLogicalDevice, VkQueue inTransferQueue, VkCommandPool inTransferCommandPool,
+		std::vector<MeshData>& inMeshData, const std::vector<int>& inMaterialToTexture);
 
 	size_t GetMeshCount();
 	Mesh* GetMesh(size_t inIndex);
+	const AABB& GetLocalAABB() { return localAABB; };
 
 
 };
\ No newline at end of file
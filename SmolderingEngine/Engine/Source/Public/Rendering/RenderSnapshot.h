@@ -0,0 +1,64 @@
+#pragma once
+
+// Standard Library
+#include <vector>
+#include <cstdint>
+
+// Third Party
+#include <imgui.h>
+
+// Project includes
+#include "Engine/Source/Public/Rendering/Utilities.h"
+
+// One object to draw, copied out of the level so the simulation can move it while this frame is recorded
+struct RenderInstance
+{
+	Model model;
+	class MeshModel* meshModel;
+};
+
+// ImGui's draw lists for one frame, cloned so ImGui can build the next frame while the render thread records this one
+struct GUIDrawData
+{
+	ImDrawData drawData;
+
+	GUIDrawData() {};
+	~GUIDrawData();
+
+	GUIDrawData(const GUIDrawData&) = delete;
+	GUIDrawData& operator=(const GUIDrawData&) = delete;
+
+	// Replaces the lists held with copies of _source's
+	void CopyFrom(const ImDrawData* _source);
+	void Clear();
+};
+
+/*
+* Everything the render thread needs to draw one frame. The simulation thread fills it in and it is not changed after
+* it is published, so recording never reads the level or the camera while the next frame is simulated.
+*
+* Meshes and textures it points at are only released while the render thread is held between frames, and the pending
+* snapshot is discarded at the same time (see RenderThread::LockFrame), so a snapshot never outlives them.
+*/
+struct RenderSnapshot
+{
+	// Counts published snapshots, so the render thread can tell how many it skipped
+	uint64_t simulationFrame = 0;
+
+	// The swapchain follows the window size the simulation thread saw
+	int framebufferWidth = 0;
+	int framebufferHeight = 0;
+
+	UniformBufferObjectViewProjection viewProjection;
+	std::vector<RenderInstance> instances;
+
+	// The level's texture sets by texture ID, copied since uploads add textures while this frame is recorded
+	std::vector<VkDescriptorSet> textureDescriptorSets;
+	std::vector<bool> textureTransparency;
+
+	// Settings changed from the GUI, read by the render thread through the snapshot instead of from the Renderer
+	bool depthPrePass = true;
+	int depthPrePassBenchmarkFrames = 0;		// Starts the FrameProfiler's benchmark when above 0
+
+	GUIDrawData gui;
+};
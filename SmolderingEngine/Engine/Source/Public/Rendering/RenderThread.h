@@ -0,0 +1,88 @@
+#pragma once
+
+// Standard Library
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <cstdint>
+
+// Project includes
+#include "Engine/Source/Public/Rendering/RenderSnapshot.h"
+#include "Engine/Source/Public/Rendering/FrameTimeline.h"
+#include "Engine/Source/Public/Threading/TripleBuffer.h"
+
+/*
+* Records and submits frames on its own thread. The simulation (main) thread fills in a RenderSnapshot each frame and
+* publishes it through a triple buffer, then goes straight on to simulating the next frame while this one is recorded.
+* The simulation thread runs at most one snapshot ahead, publishing waits for the previous snapshot to be taken.
+*
+* Two locks keep it apart from the simulation thread. The render thread holds the frame lock from taking a snapshot
+* until that snapshot has been presented, anything that frees what a snapshot points at (destroying objects, unloading
+* a level) takes it through LockFrame. The device lock covers the graphics queue, the deletion queue and the descriptor
+* pools, the render thread only takes it around releasing and submitting, so uploads through LockDevice do not wait
+* for a frame. When both are needed the frame lock is taken first.
+*/
+class RenderThread
+{
+	/* Variables */
+private:
+	using DrawFunction = std::function<void(const RenderSnapshot&)>;
+	DrawFunction drawSnapshot;
+
+	TripleBuffer<RenderSnapshot> snapshots;
+	uint64_t publishedCount = 0;
+
+	// Held while drawing a snapshot
+	std::mutex frameMutex;
+	// Held while using the graphics queue, deletion queue or descriptor pools
+	std::mutex deviceMutex;
+
+	// Wakes the render thread when a snapshot is published, and the simulation thread once it has been taken
+	std::mutex handoffMutex;
+	std::condition_variable handoffCondition;
+	bool running = true;
+
+	// Off draws each snapshot on the thread that publishes it, the old serial frame to compare against
+	std::atomic<bool> threaded{ true };
+
+	FrameTimeline frameTimeline;
+
+	// Last, so everything it uses exists before the thread starts
+	std::thread thread;
+
+	/* Functions */
+public:
+	RenderThread(DrawFunction _drawSnapshot);
+	~RenderThread();
+
+	RenderThread(const RenderThread&) = delete;
+	RenderThread& operator=(const RenderThread&) = delete;
+
+	// Simulation thread. The snapshot to fill in for the next frame, it still holds what was written to it three
+	// publishes ago so its vectors keep their capacity.
+	RenderSnapshot& BeginSnapshot() { return snapshots.GetWriteBuffer(); };
+	// Simulation thread. Hands the snapshot over, after waiting for the render thread to take the previous one.
+	void PublishSnapshot();
+
+	// Waits for the frame being drawn to be presented and keeps the next one from starting while the lock is held
+	std::unique_lock<std::mutex> LockFrame() { return std::unique_lock<std::mutex>(frameMutex); };
+	// Keeps the render thread off the graphics queue and the deletion queue while the lock is held
+	std::unique_lock<std::mutex> LockDevice() { return std::unique_lock<std::mutex>(deviceMutex); };
+	// Frame lock held. Drops a published snapshot that has not been drawn, call it before releasing anything a
+	// snapshot may point at (meshes, textures).
+	void DiscardPendingSnapshot() { snapshots.DiscardPending(); };
+
+	void SetThreaded(bool _threaded) { threaded = _threaded; };
+
+	/* Getters */
+	bool IsThreaded() const { return threaded; };
+	FrameTimeline* GetFrameTimeline() { return &frameTimeline; };
+
+private:
+	void RenderLoop();
+
+	// Frame lock held. Draws the latest snapshot if there is one that has not been drawn yet.
+	void DrawPendingSnapshot();
+};
@@ -7,6 +7,8 @@
 #include <iostream>
 #include <set>
 #include <algorithm>
+#include <chrono>
+#include <filesystem>
 
 // TEMP STD
 #include <windows.h>
@@ -43,6 +45,8 @@ struct VulkanResources
 	// Graphics 
 	VkQueue graphicsQueue;
 	VkCommandPool graphicsCommandPool;
+	// One-off transfers (uploads) get their own pool, the frame's command buffers are recorded without the device lock
+	VkCommandPool uploadCommandPool;
 
 	// Swapchain info
 	VkSwapchainKHR swapchain;
@@ -51,6 +55,12 @@ struct VulkanResources
 
 	// Renderpass info
 	VkRenderPass renderPass;
+
+	// Shared by every renderer (and ImGui) so pipelines compiled on a previous run can be reused
+	VkPipelineCache pipelineCache;
+
+	// Resources released here are destroyed once the frames that may use them have finished, instead of waiting idle
+	class DeletionQueue* deletionQueue;
 };
 
 class Renderer
@@ -65,11 +75,31 @@ private:
 	class EngineLevelManager* seLevelManager;
 	int currentFrame = 0;
 
+	// Total frames submitted, used to know when retired resources are no longer in flight
+	uint64_t frameNumber = 0;
+
 	// Other renderer references
 	class SkyboxRenderer* seSkyboxRenderer;
 	class EngineGUIRenderer* seEngineGUIRenderer;
 	class LevelRenderer* seLevelRenderer;
 
+	// GPU timings and counters for each frame
+	class FrameProfiler* seFrameProfiler;
+
+	// CPU time of each phase of the frame, owned by the RenderThread
+	class FrameTimeline* seFrameTimeline = nullptr;
+
+	// Owns the device lock, taken in Draw only around the deletion queue and the queue submit/present
+	class RenderThread* seRenderThread = nullptr;
+
+	// Lays down level depth before shading so hidden fragments are rejected by early-Z.
+	// Set from the GUI on the simulation thread, the render thread reads it from the snapshot.
+	bool depthPrePassEnabled = true;
+
+	// Size the swapchain is made for, from the last snapshot. GLFW may only be asked on the main thread.
+	int framebufferWidth = 0;
+	int framebufferHeight = 0;
+
 	/* General Vulkan Resources that other renderers will need */
 	VulkanResources* vulkanResources;
 
@@ -86,6 +116,10 @@ private:
 	VkDeviceMemory depthBufferImageMemory;
 	VkImageView depthBufferImageView;
 
+	// Swapchains replaced on resize, kept alive until the frames that used them have finished
+	std::vector<RetiredSwapchain> retiredSwapchains;
+	bool swapchainOutOfDate = false;
+
 	// Synchronisation
 	std::vector<VkSemaphore> imageAvailableSemaphores;
 	std::vector<VkSemaphore> renderingCompleteSemaphores;
@@ -94,6 +128,10 @@ private:
 	// Debug
 	VkDebugUtilsMessengerEXT debugMessenger;
 
+	// Pipeline cache file, loaded on startup and written back when the renderer is destroyed
+	const std::string pipelineCacheFilePath = std::string(PROJECT_SOURCE_DIR) + "/SmolderingEngine/Engine/Cache/PipelineCache.bin";
+	bool pipelineCacheLoadedFromFile = false;
+
 	// Vulkan Validation Layers
 	const std::vector<const char*> validationLayers = 
 	{
@@ -107,22 +145,34 @@ public:
 	Renderer(GLFWwindow* _window, class Camera* _camera);
 	void DestroyRenderer();
 
-	void Draw();
-	void RecordCommands(uint32_t _imageIndex);
+	// Simulation thread. Handles GUI input, builds the GUI and copies the camera and level into _snapshot.
+	void PrepareSnapshot(struct RenderSnapshot& _snapshot);
 
-	// Re-creates window based off of new window size
+	// Render thread (with the frame lock held). Records, submits and presents one snapshot.
+	void Draw(const struct RenderSnapshot& _snapshot);
+	void RecordCommands(uint32_t _imageIndex, const struct RenderSnapshot& _snapshot);
+
+	// Re-creates the swapchain if the framebuffer size changed
 	void ResizeRenderer(int inWidth, int inHeight);
+	void RecreateSwapchain();
+
+	// Destroys retired swapchain resources once no frame in flight can use them, or all of them when the device is idle
+	void DestroyRetiredSwapchains(bool _destroyAll);
 
 	// Vulkan functions
 	void CreateVulkanInstance();
 	void CreateLogicalDevice();
 	void CreateVulkanSurface();
-	void CreateSwapChain();
+	void CreateSwapChain(VkSwapchainKHR _oldSwapchain = VK_NULL_HANDLE);
 	void CreateRenderpass();
 	void CreateDepthBufferImage();
 	void CreateFramebuffers();
 	void CreateCommandPool();
 	void CreateSynchronizationPrimatives();
+	void CreatePipelineCache();
+
+	// Writes the pipeline cache to disk so the next launch does not have to recompile pipelines
+	void SavePipelineCache();
 
 	void AllocateCommandBuffers();
 
@@ -140,6 +190,7 @@ public:
 	bool CheckForBestPhysicalDevice(VkPhysicalDevice InPhysicalDevice);
 	bool CheckDeviceExtentionSupport(VkPhysicalDevice InPhysicalDevice);
 	bool CheckValidationLayerSupport();
+	bool IsPipelineCacheDataValid(const std::vector<char>& _cacheData);
 
 	VkFormat ChooseSupportedFormat(const std::vector<VkFormat>& inFormats, VkImageTiling inTiling, VkFormatFeatureFlags inFeatureFlags);
 	VkSurfaceFormatKHR ChooseBestSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& InSurfaceFormats);
@@ -150,11 +201,17 @@ public:
 	VulkanResources GetVulkanResources() { return *vulkanResources; };
 	// TODO: REMOVE ASAP
 	class LevelRenderer* GetLevelRenderer() { return seLevelRenderer; };
+	class DeletionQueue* GetDeletionQueue() { return vulkanResources->deletionQueue; };
+	class FrameProfiler* GetFrameProfiler() { return seFrameProfiler; };
+	void SetFrameTimeline(class FrameTimeline* _frameTimeline) { seFrameTimeline = _frameTimeline; };
+	void SetRenderThread(class RenderThread* _renderThread) { seRenderThread = _renderThread; };
+	bool IsDepthPrePassEnabled() { return depthPrePassEnabled; };
+	void SetDepthPrePassEnabled(bool _enabled) { depthPrePassEnabled = _enabled; };
 	void SetEngineLevelManager(class EngineLevelManager* inLevel) { seLevelManager = inLevel; };
 	VkDevice GetLogicalDevice() { return vulkanResources->logicalDevice; };
 	VkPhysicalDevice GetPhysicalDevice() { return vulkanResources->physicalDevice; };
 	VkQueue GetGraphicsQueue() { return vulkanResources->graphicsQueue; };
-	VkCommandPool GetGraphicsCommandPool() { return vulkanResources->graphicsCommandPool; };
+	VkCommandPool GetUploadCommandPool() { return vulkanResources->uploadCommandPool; };
 	VkRenderPass GetRenderPass() { return vulkanResources->renderPass; };
 	uint32_t GetSwapchainImageSize() { return vulkanResources->swapchainImages.size(); };
 	std::vector<VkFramebuffer> GetSwapchainFramebuffers() { return swapchainFramebuffers; };
@@ -59,9 +59,8 @@ public:
 	void DestroySkyboxRenderer();
 
 	// Handle drawing commands
-	void RecordToCommandBuffer(VkCommandBuffer _commandBuffer, uint32_t _imageIndex);
-	void UpdateUniformBuffer(const class Camera* _camera, uint32_t _imageIndex);
-	void ResizeRenderer();
+	void RecordToCommandBuffer(VkCommandBuffer _commandBuffer, uint32_t _frameIndex);
+	void UpdateUniformBuffer(const UniformBufferObjectViewProjection& _viewProjection, uint32_t _frameIndex);
 	
 	// Create needed resources
 	void CreateCubemapTextureSampler();
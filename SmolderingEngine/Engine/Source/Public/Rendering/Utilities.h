@@ -6,9 +6,16 @@
 #include <GLM/glm.hpp>
 
 #include <fstream>
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include <string>
+#include <stdexcept>
 
 const int MAX_FRAME_DRAWS = 2;
 const int MAX_OBJECTS = 256;
+const int MAX_COLLISION_CONTACTS = 1024;
+const int MAX_COLLISION_EVENTS = 4096;
 const bool ENABLE_VULKAN_DEBUG_VALIDATION_LAYERS = true;
 
 const std::vector<const char*> deviceExtensions =
@@ -49,6 +56,20 @@ struct SwapchainImage
 	VkImageView imageView;
 };
 
+// Everything owned by a swapchain that has been replaced but may still be used by frames in flight
+struct RetiredSwapchain
+{
+	VkSwapchainKHR swapchain;
+	std::vector<SwapchainImage> swapchainImages;
+	std::vector<VkFramebuffer> framebuffers;
+
+	VkImage depthBufferImage;
+	VkDeviceMemory depthBufferImageMemory;
+	VkImageView depthBufferImageView;
+
+	uint64_t retiredFrameNumber;		// Frame number at the time it was replaced
+};
+
 struct UniformBufferObjectViewProjection
 {
 	glm::mat4 projection;
@@ -69,6 +90,17 @@ struct AABB
 
 	float minimumY;
 	float maximumY;
+
+	float minimumZ;
+	float maximumZ;
+};
+
+// Direction is expected to be normalized so hit distances are in world units
+struct Ray
+{
+	glm::vec3 origin = glm::vec3(0.0f);
+	glm::vec3 direction = glm::vec3(0.0f, 0.0f, 1.0f);
+	float maxDistance = std::numeric_limits<float>::max();
 };
 
 struct Model
@@ -305,4 +337,201 @@ static 	VkShaderModule CreateShaderModule(VkDevice _logicalDevice, const std::ve
 		throw std::runtime_error("Failed to create shader module!");
 
 	return ShaderModule;
-}
\ No newline at end of file
+}
+
+// Inside out box so the first point grown into it becomes both its minimum and maximum
+static AABB CreateEmptyAABB()
+{
+	AABB emptyAABB;
+	emptyAABB.minimumX = emptyAABB.minimumY = emptyAABB.minimumZ = std::numeric_limits<float>::max();
+	emptyAABB.maximumX = emptyAABB.maximumY = emptyAABB.maximumZ = std::numeric_limits<float>::lowest();
+
+	return emptyAABB;
+}
+
+static void GrowAABB(AABB& _aabb, const glm::vec3& _point)
+{
+	_aabb.minimumX = std::min(_aabb.minimumX, _point.x);
+	_aabb.minimumY = std::min(_aabb.minimumY, _point.y);
+	_aabb.minimumZ = std::min(_aabb.minimumZ, _point.z);
+	_aabb.maximumX = std::max(_aabb.maximumX, _point.x);
+	_aabb.maximumY = std::max(_aabb.maximumY, _point.y);
+	_aabb.maximumZ = std::max(_aabb.maximumZ, _point.z);
+}
+
+static AABB MergeAABB(const AABB& _first, const AABB& _second)
+{
+	AABB mergedAABB;
+	mergedAABB.minimumX = std::min(_first.minimumX, _second.minimumX);
+	mergedAABB.minimumY = std::min(_first.minimumY, _second.minimumY);
+	mergedAABB.minimumZ = std::min(_first.minimumZ, _second.minimumZ);
+	mergedAABB.maximumX = std::max(_first.maximumX, _second.maximumX);
+	mergedAABB.maximumY = std::max(_first.maximumY, _second.maximumY);
+	mergedAABB.maximumZ = std::max(_first.maximumZ, _second.maximumZ);
+
+	return mergedAABB;
+}
+
+static bool AABBOverlaps(const AABB& _first, const AABB& _second)
+{
+	return (_first.minimumX <= _second.maximumX) && (_first.maximumX >= _second.minimumX)
+		&& (_first.minimumY <= _second.maximumY) && (_first.maximumY >= _second.minimumY)
+		&& (_first.minimumZ <= _second.maximumZ) && (_first.maximumZ >= _second.minimumZ);
+}
+
+// True if _inner is completely inside of _outer
+static bool AABBContains(const AABB& _outer, const AABB& _inner)
+{
+	return (_outer.minimumX <= _inner.minimumX) && (_outer.maximumX >= _inner.maximumX)
+		&& (_outer.minimumY <= _inner.minimumY) && (_outer.maximumY >= _inner.maximumY)
+		&& (_outer.minimumZ <= _inner.minimumZ) && (_outer.maximumZ >= _inner.maximumZ);
+}
+
+static float AABBSurfaceArea(const AABB& _aabb)
+{
+	float width = _aabb.maximumX - _aabb.minimumX;
+	float height = _aabb.maximumY - _aabb.minimumY;
+	float depth = _aabb.maximumZ - _aabb.minimumZ;
+
+	return 2.0f * (width * height + height * depth + depth * width);
+}
+
+static AABB ExpandAABB(const AABB& _aabb, float _margin)
+{
+	AABB expandedAABB;
+	expandedAABB.minimumX = _aabb.minimumX - _margin;
+	expandedAABB.minimumY = _aabb.minimumY - _margin;
+	expandedAABB.minimumZ = _aabb.minimumZ - _margin;
+	expandedAABB.maximumX = _aabb.maximumX + _margin;
+	expandedAABB.maximumY = _aabb.maximumY + _margin;
+	expandedAABB.maximumZ = _aabb.maximumZ + _margin;
+
+	return expandedAABB;
+}
+
+// Distance from the centre to the closest point on the box
+static bool SphereOverlapsAABB(const glm::vec3& _center, float _radius, const AABB& _aabb)
+{
+	glm::vec3 closestPoint = glm::clamp(_center,
+		glm::vec3(_aabb.minimumX, _aabb.minimumY, _aabb.minimumZ), glm::vec3(_aabb.maximumX, _aabb.maximumY, _aabb.maximumZ));
+	glm::vec3 offset = closestPoint - _center;
+
+	return glm::dot(offset, offset) <= _radius * _radius;
+}
+
+/*
+* Transforms a local space AABB into a world space AABB using Arvo's method ("Transforming Axis-Aligned Bounding Boxes", Graphics Gems 1990).
+* Each world axis starts at the translation, then every matrix element adds whichever of the local min/max gives the smaller
+* (or larger) product. Gives the same box as transforming all 8 corners but with 9 multiplies per bound instead of 8 matrix multiplies.
+*/
+static AABB TransformAABB(const AABB& _localAABB, const glm::mat4& _matrix)
+{
+	const float localMinimum[3] = { _localAABB.minimumX, _localAABB.minimumY, _localAABB.minimumZ };
+	const float localMaximum[3] = { _localAABB.maximumX, _localAABB.maximumY, _localAABB.maximumZ };
+	float worldMinimum[3] = { _matrix[3][0], _matrix[3][1], _matrix[3][2] };
+	float worldMaximum[3] = { _matrix[3][0], _matrix[3][1], _matrix[3][2] };
+
+	// glm is column major, _matrix[column][row]
+	for (int row = 0; row < 3; row++)
+	{
+		for (int column = 0; column < 3; column++)
+		{
+			float a = _matrix[column][row] * localMinimum[column];
+			float b = _matrix[column][row] * localMaximum[column];
+
+			worldMinimum[row] += std::min(a, b);
+			worldMaximum[row] += std::max(a, b);
+		}
+	}
+
+	AABB worldAABB;
+	worldAABB.minimumX = worldMinimum[0];
+	worldAABB.minimumY = worldMinimum[1];
+	worldAABB.minimumZ = worldMinimum[2];
+	worldAABB.maximumX = worldMaximum[0];
+	worldAABB.maximumY = worldMaximum[1];
+	worldAABB.maximumZ = worldMaximum[2];
+
+	return worldAABB;
+}
+
+/*
+* Swept AABB test, moves _moving by _displacement and finds the first time (0 to 1) it touches _target.
+* Writes 0 if they already overlap at the start, _normal is the face of _target that was hit (zero when already overlapping).
+*/
+static bool SweptAABBTimeOfImpact(const AABB& _moving, const glm::vec3& _displacement, const AABB& _target, float* _timeOfImpact, glm::vec3* _normal)
+{
+	const float movingMinimum[3] = { _moving.minimumX, _moving.minimumY, _moving.minimumZ };
+	const float movingMaximum[3] = { _moving.maximumX, _moving.maximumY, _moving.maximumZ };
+	const float targetMinimum[3] = { _target.minimumX, _target.minimumY, _target.minimumZ };
+	const float targetMaximum[3] = { _target.maximumX, _target.maximumY, _target.maximumZ };
+
+	float entryTime = std::numeric_limits<float>::lowest();
+	float exitTime = std::numeric_limits<float>::max();
+	int entryAxis = -1;
+
+	for (int axis = 0; axis < 3; axis++)
+	{
+		// Not moving on this axis, it has to overlap the whole time
+		if (_displacement[axis] == 0.0f)
+		{
+			if (movingMaximum[axis] < targetMinimum[axis] || movingMinimum[axis] > targetMaximum[axis])
+				return false;
+			continue;
+		}
+
+		float inverseDisplacement = 1.0f / _displacement[axis];
+		float time1 = (targetMinimum[axis] - movingMaximum[axis]) * inverseDisplacement;
+		float time2 = (targetMaximum[axis] - movingMinimum[axis]) * inverseDisplacement;
+
+		float axisEntry = std::min(time1, time2);
+		if (axisEntry > entryTime)
+		{
+			entryTime = axisEntry;
+			entryAxis = axis;
+		}
+		exitTime = std::min(exitTime, std::max(time1, time2));
+	}
+
+	if (entryTime > exitTime || exitTime < 0.0f || entryTime > 1.0f)
+		return false;
+
+	*_normal = glm::vec3(0.0f);
+	if (entryTime <= 0.0f || entryAxis == -1)
+	{
+		*_timeOfImpact = 0.0f;
+		return true;
+	}
+
+	*_timeOfImpact = entryTime;
+	(*_normal)[entryAxis] = _displacement[entryAxis] > 0.0f ? -1.0f : 1.0f;
+	return true;
+}
+
+/*
+* Slab test. _inverseDirection is 1 / ray direction per axis (infinite for axis aligned rays is fine).
+* Writes the distance the ray enters the box at, 0 if it starts inside.
+*/
+static bool RayIntersectAABB(const glm::vec3& _origin, const glm::vec3& _inverseDirection, const AABB& _aabb, float _maxDistance, float* _entryDistance)
+{
+	float tx1 = (_aabb.minimumX - _origin.x) * _inverseDirection.x;
+	float tx2 = (_aabb.maximumX - _origin.x) * _inverseDirection.x;
+	float tMinimum = std::min(tx1, tx2);
+	float tMaximum = std::max(tx1, tx2);
+
+	float ty1 = (_aabb.minimumY - _origin.y) * _inverseDirection.y;
+	float ty2 = (_aabb.maximumY - _origin.y) * _inverseDirection.y;
+	tMinimum = std::max(tMinimum, std::min(ty1, ty2));
+	tMaximum = std::min(tMaximum, std::max(ty1, ty2));
+
+	float tz1 = (_aabb.minimumZ - _origin.z) * _inverseDirection.z;
+	float tz2 = (_aabb.maximumZ - _origin.z) * _inverseDirection.z;
+	tMinimum = std::max(tMinimum, std::min(tz1, tz2));
+	tMaximum = std::min(tMaximum, std::max(tz1, tz2));
+
+	if (tMaximum < std::max(tMinimum, 0.0f) || tMinimum > _maxDistance)
+		return false;
+
+	*_entryDistance = std::max(tMinimum, 0.0f);
+	return true;
+}
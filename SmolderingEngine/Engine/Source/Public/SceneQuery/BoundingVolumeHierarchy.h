@@ -0,0 +1,137 @@
+#pragma once
+
+// Standard Library
+#include <vector>
+
+// Project includes
+#include "Engine/Source/Public/Rendering/Utilities.h"
+
+// Interior nodes have primitiveCount 0 and their children at leftFirst and leftFirst + 1.
+// Leaves hold primitiveCount primitives starting at primitiveIndices[leftFirst].
+struct BVHNode
+{
+	AABB bounds;
+	int leftFirst = 0;
+	int primitiveCount = 0;
+
+	bool IsLeaf() const { return primitiveCount > 0; };
+};
+
+/*
+* Static bounding volume hierarchy built once with the surface area heuristic (binned, see Wald 2007
+* "On fast Construction of SAH-based Bounding Volume Hierarchies"). It only stores primitive indices, the
+* caller tests the primitives itself so the same tree works for objects and triangles.
+* Building is not thread safe, queries on a built tree are.
+*/
+class BoundingVolumeHierarchy
+{
+	/* Variables */
+public:
+	// Nodes this deep become leaves no matter how many primitives they hold, lets queries use a fixed size stack
+	static const int MAX_DEPTH = 48;
+
+private:
+	std::vector<BVHNode> nodes;
+	std::vector<int> primitiveIndices;
+
+	/* Functions */
+public:
+	// Rebuilds the tree from scratch over the given primitive bounds
+	void Build(const std::vector<AABB>& _primitiveBounds);
+	void Clear();
+
+	/*
+	* Calls _intersect(primitiveIndex, closestDistance) for primitives in nodes the ray reaches, nearest nodes first.
+	* _intersect returns true and lowers closestDistance when it finds a closer hit, nodes further away are then skipped.
+	*/
+	template<typename Intersect>
+	void Raycast(const Ray& _ray, float& _closestDistance, Intersect&& _intersect) const;
+
+	// Calls _callback(primitiveIndex) for primitives in leaves whose bounds overlap _aabb
+	template<typename Callback>
+	void Query(const AABB& _aabb, Callback&& _callback) const;
+
+	/* Getters */
+	bool IsEmpty() const { return nodes.empty(); };
+	const AABB& GetBounds() const { return nodes[0].bounds; };
+	size_t GetNodeCount() const { return nodes.size(); };
+
+private:
+	void Subdivide(int _nodeID, int _depth, const std::vector<AABB>& _primitiveBounds, const std::vector<glm::vec3>& _centroids);
+	void UpdateNodeBounds(int _nodeID, const std::vector<AABB>& _primitiveBounds);
+};
+
+template<typename Intersect>
+void BoundingVolumeHierarchy::Raycast(const Ray& _ray, float& _closestDistance, Intersect&& _intersect) const
+{
+	if (nodes.empty())
+		return;
+
+	glm::vec3 inverseDirection = 1.0f / _ray.direction;
+
+	// Depth is capped at MAX_DEPTH when building, so the stack can never hold more than MAX_DEPTH + 1 nodes
+	int stack[MAX_DEPTH + 1];
+	int stackCount = 0;
+
+	float entryDistance;
+	if (!RayIntersectAABB(_ray.origin, inverseDirection, nodes[0].bounds, std::min(_closestDistance, _ray.maxDistance), &entryDistance))
+		return;
+
+	stack[stackCount++] = 0;
+	while (stackCount > 0)
+	{
+		const BVHNode& node = nodes[stack[--stackCount]];
+
+		if (node.IsLeaf())
+		{
+			for (int i = 0; i < node.primitiveCount; i++)
+				_intersect(primitiveIndices[node.leftFirst + i], _closestDistance);
+			continue;
+		}
+
+		// Visit the nearer child first so the closest hit shrinks the search as early as possible
+		float maxDistance = std::min(_closestDistance, _ray.maxDistance);
+		float leftDistance, rightDistance;
+		bool hitLeft = RayIntersectAABB(_ray.origin, inverseDirection, nodes[node.leftFirst].bounds, maxDistance, &leftDistance);
+		bool hitRight = RayIntersectAABB(_ray.origin, inverseDirection, nodes[node.leftFirst + 1].bounds, maxDistance, &rightDistance);
+
+		if (hitLeft && hitRight)
+		{
+			bool leftFirst = leftDistance <= rightDistance;
+			stack[stackCount++] = leftFirst ? node.leftFirst + 1 : node.leftFirst;
+			stack[stackCount++] = leftFirst ? node.leftFirst : node.leftFirst + 1;
+		}
+		else if (hitLeft)
+			stack[stackCount++] = node.leftFirst;
+		else if (hitRight)
+			stack[stackCount++] = node.leftFirst + 1;
+	}
+}
+
+template<typename Callback>
+void BoundingVolumeHierarchy::Query(const AABB& _aabb, Callback&& _callback) const
+{
+	if (nodes.empty())
+		return;
+
+	int stack[MAX_DEPTH + 1];
+	int stackCount = 0;
+
+	stack[stackCount++] = 0;
+	while (stackCount > 0)
+	{
+		const BVHNode& node = nodes[stack[--stackCount]];
+		if (!AABBOverlaps(node.bounds, _aabb))
+			continue;
+
+		if (node.IsLeaf())
+		{
+			for (int i = 0; i < node.primitiveCount; i++)
+				_callback(primitiveIndices[node.leftFirst + i]);
+			continue;
+		}
+
+		stack[stackCount++] = node.leftFirst;
+		stack[stackCount++] = node.leftFirst + 1;
+	}
+}
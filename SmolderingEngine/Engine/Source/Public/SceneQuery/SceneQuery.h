@@ -0,0 +1,75 @@
+#pragma once
+
+// Standard Library
+#include <vector>
+#include <atomic>
+
+// Project includes
+#include "Engine/Source/Public/Rendering/Utilities.h"
+#include "Engine/Source/Public/SceneQuery/BoundingVolumeHierarchy.h"
+#include "Engine/Source/Public/Threading/ParallelFor.h"
+
+struct RaycastHit
+{
+	bool hit = false;
+	class GameObject* gameObject = nullptr;
+	float distance = 0.0f;
+	glm::vec3 position = glm::vec3(0.0f);
+	glm::vec3 normal = glm::vec3(0.0f);
+};
+
+struct Sphere
+{
+	glm::vec3 center = glm::vec3(0.0f);
+	float radius = 0.0f;
+};
+
+// Everything a query needs from a GameObject, copied at build time so queries never touch the object itself
+struct SceneQueryObject
+{
+	class GameObject* gameObject = nullptr;
+	glm::mat4 inverseModelMatrix = glm::mat4(1.0f);
+	glm::mat3 normalMatrix = glm::mat3(1.0f);
+	AABB worldAABB;
+	std::vector<class Mesh*> meshes;
+};
+
+/*
+* Ray, sphere and box queries against the level's objects. A SAH BVH over the objects' world AABBs finds the
+* candidates, rays are then tested against each mesh's triangle BVH so hits are exact. Overlap queries stop at the
+* world AABB. Queries are const and safe to run from several threads at once, the batch versions spread across threads.
+*/
+class SceneQuery
+{
+	/* Variables */
+private:
+	std::vector<SceneQueryObject> objects;
+	BoundingVolumeHierarchy sceneBVH;
+
+	// Set from any thread when objects are added, removed or moved
+	std::atomic<bool> dirty{ true };
+
+	// Each thread gets at least this many queries so small batches do not pay for starting threads
+	const size_t minimumQueriesPerThread = 64;
+
+	/* Functions */
+public:
+	void MarkDirty() { dirty = true; };
+	// Rebuilds when marked dirty, must not run at the same time as a query
+	void UpdateIfDirty(const std::vector<class GameObject*>& _gameObjects);
+	void Build(const std::vector<class GameObject*>& _gameObjects);
+
+	// Closest hit along the ray
+	RaycastHit Raycast(const Ray& _ray) const;
+	// Appends every object whose world AABB overlaps the sphere/box
+	void OverlapSphere(const Sphere& _sphere, std::vector<class GameObject*>& _results) const;
+	void OverlapBox(const AABB& _box, std::vector<class GameObject*>& _results) const;
+
+	// _results is resized to match the queries, result i belongs to query i
+	void RaycastBatch(const std::vector<Ray>& _rays, std::vector<RaycastHit>& _results) const;
+	void OverlapSphereBatch(const std::vector<Sphere>& _spheres, std::vector<std::vector<class GameObject*>>& _results) const;
+	void OverlapBoxBatch(const std::vector<AABB>& _boxes, std::vector<std::vector<class GameObject*>>& _results) const;
+
+	// World space ray through a pixel, for picking. Screen space has (0, 0) at the top left.
+	static Ray CreateScreenRay(float _screenX, float _screenY, float _screenWidth, float _screenHeight, const UniformBufferObjectViewProjection& _viewProjection);
+};
@@ -0,0 +1,59 @@
+#pragma once
+
+// Standard Library
+#include <vector>
+#include <cstdint>
+
+// Project includes
+#include "Engine/Source/Public/SceneQuery/BoundingVolumeHierarchy.h"
+
+/*
+* BVH over the triangles of one mesh in object space, used for exact ray hits after the scene BVH
+* has found the object. Vertices and indices are not copied, they are passed in on every query.
+*/
+class TriangleBVH
+{
+	/* Variables */
+private:
+	BoundingVolumeHierarchy bvh;
+
+	/* Functions */
+public:
+	void Build(const std::vector<glm::vec3>& _vertices, const std::vector<uint32_t>& _indices);
+
+	// Returns true and lowers _closestDistance if a triangle is hit closer than it, _normal is the object space face normal
+	bool Raycast(const Ray& _ray, const std::vector<glm::vec3>& _vertices, const std::vector<uint32_t>& _indices,
+		float& _closestDistance, glm::vec3* _normal) const;
+
+	/* Getters */
+	bool IsEmpty() const { return bvh.IsEmpty(); };
+};
+
+/*
+* Moller-Trumbore ray/triangle test, double sided so picking works from inside models too.
+* Returns the distance along the ray or a negative number on a miss.
+*/
+static float RayIntersectTriangle(const glm::vec3& _origin, const glm::vec3& _direction, const glm::vec3& _vertex0, const glm::vec3& _vertex1, const glm::vec3& _vertex2)
+{
+	const float epsilon = 1e-8f;
+
+	glm::vec3 edge1 = _vertex1 - _vertex0;
+	glm::vec3 edge2 = _vertex2 - _vertex0;
+	glm::vec3 p = glm::cross(_direction, edge2);
+	float determinant = glm::dot(edge1, p);
+	if (std::abs(determinant) < epsilon)
+		return -1.0f;
+
+	float inverseDeterminant = 1.0f / determinant;
+	glm::vec3 s = _origin - _vertex0;
+	float u = glm::dot(s, p) * inverseDeterminant;
+	if (u < 0.0f || u > 1.0f)
+		return -1.0f;
+
+	glm::vec3 q = glm::cross(s, edge1);
+	float v = glm::dot(_direction, q) * inverseDeterminant;
+	if (v < 0.0f || u + v > 1.0f)
+		return -1.0f;
+
+	return glm::dot(edge2, q) * inverseDeterminant;
+}
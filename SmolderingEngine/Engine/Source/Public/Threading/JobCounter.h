@@ -0,0 +1,12 @@
+#pragma once
+
+// Standard Library
+#include <atomic>
+
+// Jobs still running that were started with it, Wait on it to know they have all finished
+struct JobCounter
+{
+	std::atomic<int> value{ 0 };
+
+	bool IsDone() const { return value.load(std::memory_order_acquire) == 0; };
+};
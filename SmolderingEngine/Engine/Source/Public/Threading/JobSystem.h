@@ -0,0 +1,188 @@
+#pragma once
+
+// Standard Library
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <new>
+#include <utility>
+#include <type_traits>
+#include <algorithm>
+#include <cstdint>
+
+// Project includes
+#include "Engine/Source/Public/Threading/JobCounter.h"
+#include "Engine/Source/Public/Threading/WorkStealingDeque.h"
+#include "Engine/Source/Public/Threading/MPSCTaskQueue.h"
+
+// Bytes a job's callable can capture before it has to capture by reference instead
+const size_t JOB_STORAGE_SIZE = 96;
+
+// One unit of work. The callable is stored inline so starting a job never touches the heap.
+struct alignas(64) Job
+{
+	void (*invoke)(Job*) = nullptr;
+	void (*destroy)(Job*) = nullptr;
+	JobCounter* counter = nullptr;
+	// Set until the job has run, a long running job keeps its slot while the ring wraps around it
+	std::atomic<bool> inUse{ false };
+	alignas(16) unsigned char storage[JOB_STORAGE_SIZE];
+};
+
+// Jobs owned by one thread, a ring reused in order so allocating a job is usually an increment
+struct JobRing
+{
+	static const size_t capacity = 4096;
+	std::unique_ptr<Job[]> jobs{ new Job[capacity] };
+	size_t next = 0;
+};
+
+/*
+* Pool of worker threads, one per core besides the main thread. Each thread keeps its own work-stealing deque and takes
+* work from the others when it runs dry, so jobs spawned from jobs stay on the thread that made them while idle threads
+* pick up the rest. Jobs can only be started from the main thread or from inside another job.
+*
+* Vulkan work that has to happen on the main thread goes through RunOnMainThread, from any thread. The main thread runs
+* those jobs once a frame in RunMainThreadJobs and whenever it waits.
+*
+* At most JobRing::capacity jobs started by one thread may be unfinished at a time.
+*/
+class JobSystem
+{
+	/* Variables */
+private:
+	std::vector<std::thread> workers;
+
+	// Index 0 is the main thread, 1 onwards are the workers
+	std::vector<std::unique_ptr<WorkStealingDeque>> queues;
+	std::vector<std::unique_ptr<JobRing>> jobRings;
+
+	// Jobs only the main thread may run, pushed from any thread without a lock
+	MPSCTaskQueue mainThreadTasks;
+
+	// Workers sleep on this when every queue is empty. Pushing only takes the lock when a worker is asleep.
+	std::mutex sleepMutex;
+	std::condition_variable wakeCondition;
+	std::atomic<int> queuedJobs{ 0 };
+	std::atomic<int> sleepingWorkers{ 0 };
+	std::atomic<bool> running{ true };
+
+	// Index into queues and jobRings of the calling thread, -1 for threads the job system does not own
+	static thread_local int threadIndex;
+	// The job system the calling thread belongs to, so shared helpers can find it without being handed one
+	static thread_local JobSystem* threadJobSystem;
+
+	/* Functions */
+public:
+	// 0 workers runs every job on the thread that waits for it
+	JobSystem(size_t _workerCount = std::max(1u, std::thread::hardware_concurrency()) - 1);
+	~JobSystem();
+
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	// Starts _function() on any thread. _counter (optional) is incremented now and decremented when it has run.
+	template<typename Function>
+	void Run(Function&& _function, JobCounter* _counter = nullptr);
+
+	// Like Run but the job only ever runs on the main thread, for Vulkan work a job has prepared. Any thread may call it,
+	// it waits for the main thread to catch up if MPSCTaskQueue::capacity jobs are already queued.
+	template<typename Function>
+	void RunOnMainThread(Function&& _function, JobCounter* _counter = nullptr);
+	// Main thread only, runs every main thread job queued so far. Jobs these queue wait for the next call.
+	void RunMainThreadJobs();
+
+	// Runs other jobs on this thread until every job started with _counter has finished
+	void Wait(JobCounter* _counter);
+
+	/*
+	* Splits [0, _count) into chunks of _chunkSize and calls _function(first, last) for each chunk as its own job,
+	* returning once all of them have run. Chunks let a job work through neighbouring array elements in one go.
+	*/
+	template<typename Function>
+	void ParallelFor(size_t _count, size_t _chunkSize, Function&& _function);
+
+	/* Getters */
+	size_t GetWorkerCount() const { return workers.size(); };
+	// Threads that run jobs, the workers plus the main thread
+	size_t GetThreadCount() const { return queues.size(); };
+	// The job system running the calling thread, nullptr on threads that do not belong to one
+	static JobSystem* GetThreadJobSystem() { return threadJobSystem; };
+
+private:
+	void WorkerLoop(int _threadIndex);
+
+	// Fills in a job from the calling thread's ring
+	template<typename Function>
+	Job* CreateJob(Function&& _function, JobCounter* _counter);
+	Job* AllocateJob();
+	void Push(Job* _job);
+	// The calling thread's newest job, otherwise the oldest job of another thread
+	Job* GetJob();
+	void Execute(Job* _job);
+};
+
+template<typename Function>
+void JobSystem::Run(Function&& _function, JobCounter* _counter)
+{
+	Push(CreateJob(std::forward<Function>(_function), _counter));
+}
+
+template<typename Function>
+void JobSystem::RunOnMainThread(Function&& _function, JobCounter* _counter)
+{
+	// TryPush only moves from _function once it has a cell for it
+	while (!mainThreadTasks.TryPush(std::forward<Function>(_function), _counter))
+	{
+		if (threadIndex == 0)
+			RunMainThreadJobs();
+		else
+			std::this_thread::yield();
+	}
+}
+
+template<typename Function>
+Job* JobSystem::CreateJob(Function&& _function, JobCounter* _counter)
+{
+	using Callable = std::decay_t<Function>;
+	static_assert(sizeof(Callable) <= JOB_STORAGE_SIZE, "Job captures too much, capture by reference or a pointer instead");
+	static_assert(alignof(Callable) <= 16, "Job callable is over aligned");
+
+	Job* job = AllocateJob();
+	new (job->storage) Callable(std::forward<Function>(_function));
+	job->invoke = [](Job* _job) { (*std::launder(reinterpret_cast<Callable*>(_job->storage)))(); };
+	job->destroy = [](Job* _job) { std::launder(reinterpret_cast<Callable*>(_job->storage))->~Callable(); };
+	job->counter = _counter;
+
+	if (_counter != nullptr)
+		_counter->value.fetch_add(1, std::memory_order_relaxed);
+
+	return job;
+}
+
+template<typename Function>
+void JobSystem::ParallelFor(size_t _count, size_t _chunkSize, Function&& _function)
+{
+	if (_count == 0)
+		return;
+
+	_chunkSize = std::max<size_t>(1, _chunkSize);
+
+	// A single chunk is not worth handing to another thread
+	if (_count <= _chunkSize)
+	{
+		_function(size_t(0), _count);
+		return;
+	}
+
+	JobCounter counter;
+	for (size_t first = 0; first < _count; first += _chunkSize)
+	{
+		size_t last = std::min(_count, first + _chunkSize);
+		Run([&_function, first, last]() { _function(first, last); }, &counter);
+	}
+	Wait(&counter);
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+// Standard Library
+#include <atomic>
+#include <memory>
+#include <new>
+#include <utility>
+#include <type_traits>
+#include <cstdint>
+
+// Project includes
+#include "Engine/Source/Public/Threading/JobCounter.h"
+
+// Bytes a task's callable can capture before it is moved to the heap instead
+const size_t TASK_INLINE_STORAGE_SIZE = 80;
+
+// One queued task. Small callables live inline in the cell, bigger ones behind a pointer in the same storage.
+struct alignas(64) TaskCell
+{
+	// Which lap of the ring the cell is on, tells producers and the consumer whose turn it is
+	std::atomic<size_t> sequence{ 0 };
+	void (*invoke)(void*) = nullptr;
+	void (*destroy)(void*) = nullptr;
+	JobCounter* counter = nullptr;
+	alignas(16) unsigned char storage[TASK_INLINE_STORAGE_SIZE];
+};
+
+/*
+* Bounded lock-free queue of tasks with many producers and one consumer, a ring of cells where each cell carries a
+* sequence number (Vyukov's bounded queue). Producers claim a cell with one compare and swap on the enqueue position,
+* the consumer never touches shared counters other than the cell it reads. Any thread may push, only one thread at a
+* time may run tasks.
+*/
+class MPSCTaskQueue
+{
+	/* Variables */
+public:
+	// Power of two so wrapping a position is a mask
+	static const size_t capacity = 1024;
+
+private:
+	std::unique_ptr<TaskCell[]> cells{ new TaskCell[capacity] };
+
+	// Kept on separate cache lines, producers write the enqueue position and the consumer the dequeue position
+	alignas(64) std::atomic<size_t> enqueuePosition{ 0 };
+	alignas(64) size_t dequeuePosition = 0;
+
+	/* Functions */
+public:
+	MPSCTaskQueue();
+	~MPSCTaskQueue();
+
+	MPSCTaskQueue(const MPSCTaskQueue&) = delete;
+	MPSCTaskQueue& operator=(const MPSCTaskQueue&) = delete;
+
+	// Any thread. Returns false without queuing anything when the ring is full. _counter is decremented once it has run.
+	template<typename Function>
+	bool TryPush(Function&& _function, JobCounter* _counter = nullptr);
+
+	// Consumer only. Runs the tasks queued before the call, returns how many ran. Tasks may push and run more tasks.
+	size_t RunPending();
+
+	/* Getters */
+	// Only a hint while producers are pushing
+	bool IsEmpty() const { return enqueuePosition.load(std::memory_order_relaxed) == dequeuePosition; };
+
+private:
+	// Claims the next free cell, nullptr when the ring is full
+	TaskCell* ClaimCell(size_t& _position);
+	// Hands a filled cell to the consumer
+	void PublishCell(TaskCell* _cell, size_t _position);
+	void RunCell(TaskCell* _cell);
+};
+
+template<typename Function>
+bool MPSCTaskQueue::TryPush(Function&& _function, JobCounter* _counter)
+{
+	using Callable = std::decay_t<Function>;
+
+	size_t position;
+	TaskCell* cell = ClaimCell(position);
+	if (cell == nullptr)
+		return false;
+
+	if constexpr (sizeof(Callable) <= TASK_INLINE_STORAGE_SIZE && alignof(Callable) <= 16)
+	{
+		new (cell->storage) Callable(std::forward<Function>(_function));
+		cell->invoke = [](void* _storage) { (*std::launder(reinterpret_cast<Callable*>(_storage)))(); };
+		cell->destroy = [](void* _storage) { std::launder(reinterpret_cast<Callable*>(_storage))->~Callable(); };
+	}
+	else
+	{
+		// Too big to keep inline, the cell holds a pointer to it instead
+		new (cell->storage) Callable*(new Callable(std::forward<Function>(_function)));
+		cell->invoke = [](void* _storage) { (**std::launder(reinterpret_cast<Callable**>(_storage)))(); };
+		cell->destroy = [](void* _storage) { delete *std::launder(reinterpret_cast<Callable**>(_storage)); };
+	}
+	cell->counter = _counter;
+
+	if (_counter != nullptr)
+		_counter->value.fetch_add(1, std::memory_order_relaxed);
+
+	PublishCell(cell, position);
+	return true;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+// Standard Library
+#include <vector>
+#include <thread>
+#include <algorithm>
+
+// Project includes
+#include "Engine/Source/Public/Threading/JobSystem.h"
+
+/*
+* Splits [0, _count) into one contiguous range per thread and calls _function(index) for each index.
+* Each thread gets at least _minimumPerThread indices so small loops run on the calling thread alone.
+* Which thread runs an index is not fixed, so _function must only write to outputs owned by that index.
+*
+* Called from a thread that belongs to a JobSystem (the engine's main thread or any job) the ranges are jobs on it,
+* otherwise threads are started for the call.
+*/
+template<typename Function>
+static void ParallelFor(size_t _count, size_t _minimumPerThread, Function&& _function)
+{
+	if (_count == 0)
+		return;
+
+	JobSystem* jobSystem = JobSystem::GetThreadJobSystem();
+	size_t hardwareThreads = (jobSystem != nullptr) ? jobSystem->GetThreadCount() : std::max<size_t>(1, std::thread::hardware_concurrency());
+	size_t threadCount = std::min(hardwareThreads, std::max<size_t>(1, _count / std::max<size_t>(1, _minimumPerThread)));
+	size_t indicesPerThread = (_count + threadCount - 1) / threadCount;
+
+	if (jobSystem != nullptr)
+	{
+		jobSystem->ParallelFor(_count, indicesPerThread, [&_function](size_t _first, size_t _last)
+			{
+				for (size_t i = _first; i < _last; i++)
+					_function(i);
+			});
+		return;
+	}
+
+	auto runRange = [&](size_t _first)
+		{
+			size_t last = std::min(_count, _first + indicesPerThread);
+			for (size_t i = _first; i < last; i++)
+				_function(i);
+		};
+
+	// The calling thread takes the first range instead of waiting idle
+	std::vector<std::thread> threads;
+	for (size_t thread = 1; thread < threadCount; thread++)
+		threads.emplace_back(runRange, thread * indicesPerThread);
+
+	runRange(0);
+
+	for (std::thread& thread : threads)
+		thread.join();
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+// Standard Library
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/*
+* Hands the latest value from one producer thread to one consumer thread without either of them waiting. There are
+* three slots, one the producer writes, one the consumer reads and one in between. Publishing swaps the producer's slot
+* with the one in between and acquiring swaps the consumer's slot with it, so neither side ever touches a slot the other
+* one is using. A published value the consumer did not acquire in time is replaced by the next one.
+*/
+template<typename Type>
+class TripleBuffer
+{
+	/* Variables */
+private:
+	// The in between slot's index, with a bit that is set when the producer has put something new there
+	static const uint8_t INDEX_MASK = 0x3;
+	static const uint8_t FRESH_BIT = 0x4;
+
+	std::array<Type, 3> slots;
+
+	uint8_t writeIndex = 0;			// Producer only
+	std::atomic<uint8_t> sharedState{ 1 };
+	uint8_t readIndex = 2;			// Consumer only
+
+	/* Functions */
+public:
+	TripleBuffer() {};
+
+	TripleBuffer(const TripleBuffer&) = delete;
+	TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+	// Producer. Slots are reused as they are, whatever the producer wrote three publishes ago is still there.
+	Type& GetWriteBuffer() { return slots[writeIndex]; };
+
+	// Producer. Makes the write buffer the latest value, returns false if it replaced a value the consumer never took
+	bool Publish()
+	{
+		// Released so the consumer sees everything written to the slot, acquired so we see the consumer is done with the one we get
+		uint8_t previousState = sharedState.exchange(writeIndex | FRESH_BIT, std::memory_order_acq_rel);
+		writeIndex = previousState & INDEX_MASK;
+		return (previousState & FRESH_BIT) == 0;
+	};
+
+	// Producer or consumer. Drops a published value that has not been acquired, the consumer keeps its current one.
+	void DiscardPending()
+	{
+		uint8_t state = sharedState.load(std::memory_order_relaxed);
+		while ((state & FRESH_BIT) && !sharedState.compare_exchange_weak(state, state & INDEX_MASK, std::memory_order_relaxed))
+			;
+	};
+
+	// Consumer. Takes the latest published value if there is one the consumer does not have yet.
+	bool Acquire()
+	{
+		// Swapped only while it is still fresh, the producer may discard it between the check and the swap
+		uint8_t state = sharedState.load(std::memory_order_acquire);
+		do
+		{
+			if (!(state & FRESH_BIT))
+				return false;
+		} while (!sharedState.compare_exchange_weak(state, readIndex, std::memory_order_acq_rel, std::memory_order_acquire));
+
+		readIndex = state & INDEX_MASK;
+		return true;
+	};
+
+	// Consumer. The value taken by the last successful Acquire.
+	const Type& GetReadBuffer() const { return slots[readIndex]; };
+
+	/* Getters */
+	bool HasPending() const { return (sharedState.load(std::memory_order_acquire) & FRESH_BIT) != 0; };
+};
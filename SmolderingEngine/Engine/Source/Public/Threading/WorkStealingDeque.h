@@ -0,0 +1,38 @@
+#pragma once
+
+// Standard Library
+#include <atomic>
+#include <memory>
+#include <cstdint>
+
+/*
+* Chase-Lev work-stealing deque of jobs. Only the owning thread may Push and Pop, which work on the bottom and never
+* take a lock. Any thread may Steal from the top, racing the owner and other thieves with a single compare and swap
+* on the last job. The capacity is fixed, Push returns false once it is full.
+*/
+class WorkStealingDeque
+{
+	/* Variables */
+public:
+	// Power of two so wrapping an index is a mask
+	static const int64_t capacity = 4096;
+
+private:
+	// Kept on separate cache lines, thieves write top and the owner writes bottom
+	alignas(64) std::atomic<int64_t> top{ 0 };
+	alignas(64) std::atomic<int64_t> bottom{ 0 };
+	std::unique_ptr<std::atomic<struct Job*>[]> buffer{ new std::atomic<struct Job*>[capacity] };
+
+	/* Functions */
+public:
+	// Owner only
+	bool Push(struct Job* _job);
+	// Owner only, the newest job or nullptr
+	struct Job* Pop();
+	// Any thread, the oldest job or nullptr when it is empty or another thread took it first
+	struct Job* Steal();
+
+	/* Getters */
+	// Only a hint while other threads use it
+	bool IsEmpty() const { return top.load(std::memory_order_relaxed) >= bottom.load(std::memory_order_relaxed); };
+};
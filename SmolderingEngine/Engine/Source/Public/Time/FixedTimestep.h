@@ -0,0 +1,40 @@
+#pragma once
+
+// Standard Library
+#include <chrono>
+
+/*
+* Decides how many fixed simulation ticks a frame runs. Real time since the last frame goes into an accumulator and
+* every whole tick interval in it is one tick, the remainder carries over. Simulation speed then only depends on the
+* tick rate, while rendering runs as fast as it likes and interpolates between the last two ticks.
+*/
+class FixedTimestep
+{
+	/* Variables */
+private:
+	using Clock = std::chrono::steady_clock;
+
+	double tickInterval;
+	double accumulator = 0.0;
+	Clock::time_point previousTime;
+	bool started = false;
+
+	// After a long stall (loading, a breakpoint) the simulation skips ahead instead of running hundreds of ticks to catch up
+	int maxTicksPerFrame = 8;
+
+	/* Functions */
+public:
+	FixedTimestep(int _ticksPerSecond = 60);
+
+	// Adds the real time since the last call and returns how many ticks to run this frame
+	int Advance();
+
+	void SetTickRate(int _ticksPerSecond);
+	void SetMaxTicksPerFrame(int _maxTicksPerFrame) { maxTicksPerFrame = (_maxTicksPerFrame < 1) ? 1 : _maxTicksPerFrame; };
+
+	/* Getters */
+	float GetTickInterval() const { return static_cast<float>(tickInterval); };
+	int GetTickRate() const { return static_cast<int>(1.0 / tickInterval + 0.5); };
+	// How far into the next tick the frame is, 0 shows the last tick and 1 would show the next one
+	float GetInterpolationAlpha() const { return static_cast<float>(accumulator / tickInterval); };
+};
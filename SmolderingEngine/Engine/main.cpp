@@ -20,18 +20,27 @@
 #include <iostream>
 #include <chrono>
 #include <thread>
+#include <string>
+#include <cstdlib>
+#include <cerrno>
 
 // Project Includes
 #include "Engine/Source/EngineManager.h"
 
 
 #include "Engine/Source/Public/Rendering/Renderer.h"
+#include "Engine/Source/Public/Rendering/RenderThread.h"
+#include "Engine/Source/Public/Rendering/FrameTimeline.h"
 //#include "Engine/Public/Rendering/SkyboxRenderer.h"
 
 #include "Engine/Source/Public/Collision/CollisionManager.h"
 #include "Engine/Source/Public/Input/InputManager.h"
 #include "Engine/Source/Public/Camera/Camera.h"
 #include "Engine/Source/Public/EngineLevel/EngineLevelManager.h"
+#include "Engine/Source/Public/Object/ObjectManager.h"
+#include "Engine/Source/Public/Benchmark/Benchmarks.h"
+#include "Engine/Source/Public/Threading/JobSystem.h"
+#include "Engine/Source/Public/Time/FixedTimestep.h"
 
 #include "Game/Source/Public/Game.h"
 
@@ -41,55 +50,107 @@ Game* seGame;
 CollisionManager* seCollision;
 
 
-int main()
+int main(int argc, char* argv[])
 {
+	// --benchmark <name> runs a CPU benchmark and exits before a window or device is created
+	// --tick-rate <ticks per second> sets how often the simulation updates, rendering is not tied to it
+	// --no-render-thread records and submits each frame on the main thread, to compare against the render thread
+	int ticksPerSecond = 60;
+	bool renderThreadEnabled = true;
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::string(argv[i]) == "--benchmark")
+		{
+			std::string benchmarkName = (i + 1 < argc) ? argv[i + 1] : "";
+			return Benchmarks::RunBenchmark(benchmarkName) ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+		else if (std::string(argv[i]) == "--tick-rate")
+		{
+			if (i + 1 >= argc)
+			{
+				std::cout << "Error: --tick-rate needs a number of ticks per second" << std::endl;
+				return EXIT_FAILURE;
+			}
+
+			// Same range FixedTimestep::SetTickRate clamps to, anything else is rejected rather than silently changed
+			const char* value = argv[++i];
+			char* valueEnd = nullptr;
+			errno = 0;
+			long parsedTicksPerSecond = std::strtol(value, &valueEnd, 10);
+			if (valueEnd == value || *valueEnd != '\0' || errno == ERANGE || parsedTicksPerSecond < 1 || parsedTicksPerSecond > 1000)
+			{
+				std::cout << "Error: --tick-rate expects a whole number from 1 to 1000, got \"" << value << "\"" << std::endl;
+				return EXIT_FAILURE;
+			}
+			ticksPerSecond = static_cast<int>(parsedTicksPerSecond);
+		}
+		else if (std::string(argv[i]) == "--no-render-thread")
+		{
+			renderThreadEnabled = false;
+		}
+	}
+
 	seEngineManager = EngineManager::GetEngineManager();
+	FixedTimestep* seFixedTimestep = seEngineManager->GetFixedTimestep();
+	seFixedTimestep->SetTickRate(ticksPerSecond);
+	RenderThread* seRenderThread = seEngineManager->GetRenderThread();
+	seRenderThread->SetThreaded(renderThreadEnabled);
+	FrameTimeline* seFrameTimeline = seRenderThread->GetFrameTimeline();
 
 	seCollision = new CollisionManager(); // TODO: MAKE COLLISION MANAGER WORK AGAIN
 
 	// Game manager
 	seGame = new Game(); // TODO: this should be broken into 2 classes at least - 1 for game management (engine side), 1 more focused directly gameplay
 
-	//chrono stuff, update it 1/30 per second
-	constexpr int updatesPerSecond = 30; //if you want this to not be initialized in compiler change constexpr to const
-	constexpr std::chrono::duration<float> updateInterval(1.0 / updatesPerSecond); //if you want this to not be initialized in compiler change constexpr to const
-	auto previousTime = std::chrono::high_resolution_clock::now(); //initialize
-	//auto lag = std::chrono::duration<double>::zero();
-
 	while (!glfwWindowShouldClose(seEngineManager->GetInputManager()->window))
 	{
+		FrameTimeline::Clock::time_point simulationStart = FrameTimeline::Now();
+
 		// Check for window inputs
 		glfwPollEvents();
 
 		// Ensure the window is not minimized
 		if (glfwGetWindowAttrib(seEngineManager->GetInputManager()->window, GLFW_ICONIFIED) == GLFW_FALSE)
 		{
-			// Handle window resizing
-			int width, height;
-			glfwGetFramebufferSize(seEngineManager->GetInputManager()->window, &width, &height);
-			if (seEngineManager->GetInputManager()->windowWidth != width || seEngineManager->GetInputManager()->windowHeight != height)
+			// Vulkan work queued by jobs, e.g. the buffers and textures of models that finished loading
+			// TODO: This helps reduce loading hitches but is not perfect. Make it better
+			seEngineManager->GetJobSystem()->RunMainThreadJobs();
+
+			// Run as many fixed ticks as real time has passed, so simulation speed does not depend on frame rate
+			int tickCount = seFixedTimestep->Advance();
+			for (int tick = 0; tick < tickCount; tick++)
 			{
-				seEngineManager->GetRenderer()->ResizeRenderer(width, height);
-				seEngineManager->GetInputManager()->windowWidth = width;
-				seEngineManager->GetInputManager()->windowHeight = height;
+				seEngineManager->GetInputManager()->processInput(seFixedTimestep->GetTickInterval(), seEngineManager->GetCamera());
+
+				// Update phase, object callbacks then the world matrices of anything that moved (and its children)
+				seEngineManager->GetEngineLevelManager()->GetObjectManager()->UpdateObjects(seFixedTimestep->GetTickInterval());
 			}
 
-			// TODO: This helps reduce loading hitches but is not perfect. Make it better
-			seEngineManager->GetEngineLevelManager()->ProcessLevelModelTasks();
+			// Draw between the last two ticks, by how far real time is into the next one
+			float interpolationAlpha = seFixedTimestep->GetInterpolationAlpha();
+			seEngineManager->GetCamera()->InterpolateView(interpolationAlpha);
+			seEngineManager->GetEngineLevelManager()->GetObjectManager()->SetInterpolationAlpha(interpolationAlpha);
+			seFrameTimeline->Record(PHASE_SIMULATION, simulationStart);
 
-			//process da inputs 30 times per second please 
-			seEngineManager->GetInputManager()->processInput(updateInterval.count(), seEngineManager->GetCamera());
+			// Copy what this frame draws (GUI, camera, object transforms) so the next frame can be simulated while it is recorded
+			FrameTimeline::Clock::time_point snapshotStart = FrameTimeline::Now();
+			seEngineManager->GetRenderer()->PrepareSnapshot(seRenderThread->BeginSnapshot());
+			seFrameTimeline->Record(PHASE_SNAPSHOT, snapshotStart);
 
-			// Notifies all renderers to draw
-			seEngineManager->GetRenderer()->Draw();
+			// Hands the frame to the render thread. The present mode paces frames (mailbox runs uncapped, FIFO at the display rate).
+			seRenderThread->PublishSnapshot();
+		}
+		else
+		{
+			// Nothing to draw while minimized, sleep until the window gets an event
+			glfwWaitEvents();
 		}
-		
-		// Sleep to prevent busy waiting
-		std::this_thread::sleep_for(std::chrono::milliseconds(1));
 	}
 
 	delete(seCollision);
 	delete(seGame);
 
+	seEngineManager->DeleteEngineManager();
+
 	return EXIT_SUCCESS;
 }
\ No newline at end of file